@@ -1,6 +1,52 @@
-#include "SkyNet.h"
+#include "skyNet.h"
 #include <cmath>
 #include <chrono>
+
+// Heap allocations made by the calling thread. The global operator new is
+// replaced so the allocation check can count them around simulation ticks.
+static thread_local long threadHeapAllocations = 0;
+
+// GCC inlines the replacements into new[]/delete[] pairs and then reports
+// malloc/free as mismatched
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static void* countedAllocate(size_t size)
+{
+    threadHeapAllocations++;
+    return malloc(size > 0 ? size : 1);
+}
+
+void* operator new(size_t size)
+{
+    void* block = countedAllocate(size);
+    if (block == NULL) throw std::bad_alloc();
+    return block;
+}
+
+void* operator new[](size_t size)
+{
+    void* block = countedAllocate(size);
+    if (block == NULL) throw std::bad_alloc();
+    return block;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return countedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return countedAllocate(size); }
+
+void operator delete(void* block) noexcept { free(block); }
+void operator delete[](void* block) noexcept { free(block); }
+void operator delete(void* block, size_t) noexcept { free(block); }
+void operator delete[](void* block, size_t) noexcept { free(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { free(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { free(block); }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
 int readInt(const string& prompt, int minVal, int maxVal)
 {
     int value;
@@ -29,6 +75,15 @@ int readInt(const string& prompt, int minVal, int maxVal)
     }
 }
 
+// Whole line, possibly empty
+string readLine(const string& prompt)
+{
+    string value;
+    cout << prompt;
+    getline(cin, value);
+    return value;
+}
+
 string readString(const string& prompt)
 {
     string value;
@@ -41,18 +96,197 @@ string readString(const string& prompt)
 class SkyNetATC
 {
 private:
-    static const int GRID_SIZE = 20;
-    char radar[GRID_SIZE][GRID_SIZE];
-    HashTable aircraftRegistry;
-    MinHeap landingQueue;
-    AVLTree flightLog;
+    static const int VIEW_ROWS = 20;
+    static const int VIEW_COLS = 20;
+    static const int TICK_SECONDS = 60;
+    static const int SECONDS_PER_KM = 4;            // approach speed, ~900 km/h
+    static const int FUEL_SECONDS_PER_PERCENT = 60; // endurance per 1% of fuel
+    static const int UNREACHABLE_KM = 1000;
+    static const int LOW_FUEL_PERCENT = 10;
+    static const int COMMAND_QUEUE_CAPACITY = 4096;
+    static const int COMMAND_BATCH = 256;
+    RadarModel radarModel;
+    RadarViewport viewport;
+    FrameRenderer radarView;
+    ConcurrentRegistry aircraftRegistry;
+    LandingScheduler landingScheduler;
+    FlightLog flightLog;
+    FlightLogAnalytics analytics;
     Graph airspace;
+    long simClock;
+    MpscQueue<ControlCommand> commandQueue;
+    CommandStats commandStats;
+    bool applyingCommands;      // inside drainCommands, which a CMD_TICK re-enters
+    int feedRuns;
+    SnapshotCell<AirspaceSnapshot> snapshots;
+    long long snapshotVersion;
+    DynamicArray<AircraftPage*> aircraftPages;      // latest copy of each registry page, shared by snapshots
+    DynamicArray<unsigned int> aircraftPageVersions; // registry page version each copy was taken at
+    SharedRows<Aircraft>* logRows;      // flight log window shared by snapshots while unchanged
+    int logRowsCount;
+    int logEpoch;                       // bumped when the log is replaced by a load
+    int logRowsEpoch;
+    Checkpointer checkpointer;          // declared after snapshots: joined before they go
+    string registryFile;                // what saveData writes and loadData reads
+    string logFile;
+
+    // Simulation time never runs behind the wall clock; ticks move it ahead
+    long currentTime()
+    {
+        long wall = (long)chrono::duration_cast<chrono::seconds>(
+            chrono::system_clock::now().time_since_epoch()).count();
+        if (wall > simClock) simClock = wall;
+        return simClock;
+    }
+
+    // ETA, fuel deadline and delay weight of a queued flight for the arrival
+    // manager, using the live registry copy for position and fuel
+    void estimateArrival(const Aircraft& queued, const string& airport, long now, ArrivalCandidate& out)
+    {
+        Aircraft live;
+        const Aircraft& aircraft = (aircraftRegistry.tryGet(queued.flightID, live) == ATC_OK) ? live : queued;
+
+        int distance = UNREACHABLE_KM;
+        if (airspace.tryGetDistance(aircraft.currentNode, airport, distance) != ATC_OK)
+            distance = UNREACHABLE_KM;
+
+        // the flight has been flying its approach since it was queued
+        long start = (aircraft.queuedAt > 0 && aircraft.queuedAt < now) ? aircraft.queuedAt : now;
+        out.eta = start + (long)distance * SECONDS_PER_KM;
+        out.fuelDeadline = now + (long)aircraft.fuelLevel * FUEL_SECONDS_PER_PERCENT;
+        out.weight = ArrivalManager::classWeight(effectivePriority(aircraft, now));
+    }
+
+    // Burns fuel on the live registry copy. Dropping under LOW_FUEL_PERCENT
+    // escalates the flight to HIGH, as declaring a low-fuel emergency does.
+    // Returns true if the flight was escalated.
+    bool burnFuel(Aircraft& aircraft, int percent)
+    {
+        aircraft.fuelLevel -= percent;
+        if (aircraft.fuelLevel < 0) aircraft.fuelLevel = 0;
+        if (aircraft.fuelLevel >= LOW_FUEL_PERCENT || aircraft.priority <= 2) return false;
+
+        aircraft.priority = 2;
+        aircraft.status = "EMERGENCY";
+        // ATC_NOT_FOUND: not queued for landing; the registry copy is still escalated
+        landingScheduler.tryDecreaseKey(aircraft.flightID, 2);
+        return true;
+    }
+
+    // Fuel used flying one leg of the airspace graph
+    int legFuel(string from, string to)
+    {
+        return fuelForDistance(airspace.getEdgeWeight(from, to));
+    }
 
+    // Fuel for a leg of distance km; at least 1%, also for a missing edge (-1)
+    int fuelForDistance(int distance)
+    {
+        int percent = (distance > 0) ? distance * SECONDS_PER_KM / FUEL_SECONDS_PER_PERCENT : 0;
+        return (percent < 1) ? 1 : percent;
+    }
+
+    void reportEscalation(const Aircraft& aircraft)
+    {
+        setColor(COLOR_WARNING);
+        cout << "    " << aircraft.flightID << " fuel at " << aircraft.fuelLevel
+            << "% - escalated to HIGH priority (LOW FUEL)\n";
+        setColor(COLOR_RESET);
+    }
+
+    // Formatted into the scratch arena; valid until the current operation ends
+    const char* formatTime(long timestamp)
+    {
+        time_t rawtime = (time_t)timestamp;
+        struct tm timeinfo;
+        localtime_s(&timeinfo, &rawtime);
+        char* buffer = scratchArena().allocate<char>(32);
+        strftime(buffer, 32, "%Y-%m-%d %H:%M:%S", &timeinfo);
+        return buffer;
+    }
+
+    string formatDuration(double seconds)
+    {
+        long total = (long)(seconds + 0.5);
+        return toString((int)(total / 60)) + "m " + toString((int)(total % 60)) + "s";
+    }
+
+    // Queue partition for a flight: its destination when that is an airport,
+    // otherwise the airport nearest to where it currently is
+    string landingAirportFor(const Aircraft& aircraft)
+    {
+        if (landingScheduler.hasAirport(aircraft.destination))
+            return aircraft.destination;
+        string nearest = airspace.findNearestAirport(aircraft.currentNode);
+        if (!nearest.empty()) return nearest;
+        return aircraft.currentNode;
+    }
+
+    // Publishes the current state as a new snapshot version. Displays and
+    // saves read the latest version instead of the live structures, so
+    // they never need the engine to stop, and the engine never waits for
+    // a reader to finish with an older version.
+    void publishSnapshot()
+    {
+        checkpointer.poll();
+        AirspaceSnapshot* snapshot = new AirspaceSnapshot();
+        snapshot->version = ++snapshotVersion;
+        snapshot->clock = currentTime();
+
+        // Registry pages written since the previous version are copied
+        // again; the rest are shared with it
+        if (aircraftPages.empty()) {
+            aircraftPages.resize(ConcurrentRegistry::PAGES);
+            aircraftPageVersions.resize(ConcurrentRegistry::PAGES);
+            for (int p = 0; p < ConcurrentRegistry::PAGES; p++) aircraftPages[p] = NULL;
+        }
+        snapshot->pages.reserve(ConcurrentRegistry::PAGES);
+        for (int p = 0; p < ConcurrentRegistry::PAGES; p++) {
+            unsigned int seen = aircraftRegistry.getPageVersion(p);
+            if (aircraftPages[p] == NULL || aircraftPageVersions[p] != seen) {
+                if (aircraftPages[p] != NULL) aircraftPages[p]->release();
+                AircraftPage* page = AircraftPage::create();
+                auto copy = [page](const Aircraft& aircraft) { page->rows.push(aircraft); };
+                aircraftRegistry.forEachInPage(p, copy);
+                page->seal();
+                aircraftPages[p] = page;
+                aircraftPageVersions[p] = seen;
+            }
+            snapshot->addPage(aircraftPages[p]);
+        }
+        snapshot->traffic.copyFrom(radarModel.getTraffic());
+        snapshot->queued = landingScheduler.getSize();
+        snapshot->logged = flightLog.getCount();
+        if (analytics.getLandings() > 0) snapshot->landingsLastHour = analytics.getLandingsLastHour(snapshot->clock);
+        if (analytics.getWaitSamples() > 0) snapshot->waitEwma = analytics.getWaitEwma();
+        snapshot->commandsApplied = commandStats.applied;
+
+        // The log only grows between loads, so an unchanged count means
+        // the previous version's rows can be shared
+        if (logRows == NULL || logRowsCount != snapshot->logged || logRowsEpoch != logEpoch) {
+            if (logRows != NULL) logRows->release();
+            logRows = SharedRows<Aircraft>::create();
+            logRows->rows.reserve(flightLog.getHotCount());
+            auto copy = [this](const Aircraft& record) { logRows->rows.push(record); };
+            flightLog.forEachRecent(copy);
+            logRowsCount = snapshot->logged;
+            logRowsEpoch = logEpoch;
+        }
+        snapshot->recentLog = logRows->share();
+
+        snapshots.publish(snapshot);
+    }
+
+    bool startCheckpoint()
+    {
+        return checkpointer.start(snapshots, registryFile, logFile);
+    }
+
+    // The radar's traffic layer follows node occupancy from here on
     void initializeRadar()
     {
-        for (int i = 0; i < GRID_SIZE; i++)
-            for (int j = 0; j < GRID_SIZE; j++)
-                radar[i][j] = '.';
+        radarModel.clearTraffic();
+        airspace.attachRadar(&radarModel);
     }
 
     void initializeAirspace()
@@ -126,23 +360,105 @@ private:
         airspace.addEdge("WP8", "WP4", 40);
         airspace.addEdge("WP4", "WP8", 40);
 
-        radar[2][2] = 'A';
-        radar[17][17] = 'A';
-        radar[10][10] = 'A';
-        radar[2][17] = 'A';
-        radar[17][2] = 'A';
-		radar[5][5] = 'W';
-        radar[15][5] = 'W';
-        radar[5][15] = 'W';
-        radar[15][15] = 'W';
-        radar[10][2] = 'W';
-        radar[10][18] = 'W';
-        radar[2][10] = 'W';
-		radar[18][10] = 'W';
+        // Runways and minimum separation (seconds) per airport
+        landingScheduler.configureAirport("PSW", 1, 90);
+        landingScheduler.configureAirport("LHR", 2, 90);
+        landingScheduler.configureAirport("ISB", 2, 60);
+        landingScheduler.configureAirport("FSD", 1, 120);
+        landingScheduler.configureAirport("KHI", 2, 60);
+
+        for (int i = 0; i < airspace.getNodeCount(); i++) {
+            GraphNode* node = airspace.getNodeAt(i);
+            radarModel.addFeature(node->x, node->y, node->isAirport);
+        }
     }
 
     //void clearScreen() { system("cls"); }
 
+    // Glyph for one screen cell: aircraft counts win over airports and
+    // waypoints; several aircraft in one cell show as a count or heat level
+    void radarGlyph(AirspaceSnapshot& view, long cellX, long cellY, char& glyph, int& cellColor)
+    {
+        int level = viewport.level;
+        int planes = view.traffic.count(level, cellX, cellY);
+        if (planes == 1) { glyph = 'P'; cellColor = COLOR_CRITICAL; }
+        else if (planes > 1 && planes < 10) { glyph = (char)('0' + planes); cellColor = COLOR_CRITICAL; }
+        else if (planes >= 10 && planes < 100) { glyph = '+'; cellColor = COLOR_WARNING; }
+        else if (planes >= 100 && planes < 1000) { glyph = '#'; cellColor = COLOR_DANGER; }
+        else if (planes >= 1000) { glyph = '@'; cellColor = COLOR_DANGER; }
+        else if (radarModel.airportsAt(level, cellX, cellY) > 0) { glyph = 'A'; cellColor = COLOR_SUCCESS; }
+        else if (radarModel.waypointsAt(level, cellX, cellY) > 0) { glyph = 'W'; cellColor = COLOR_SUBTITLE; }
+        else { glyph = '.'; cellColor = COLOR_SUBTITLE; }
+    }
+
+    // Draws the viewport over a snapshot's traffic, its bounds and the
+    // legend into the radar framebuffer; the last row is left for a status
+    // line. Airports and waypoints never change after start-up, so they are
+    // read from the live radar model.
+    void composeRadar(AirspaceSnapshot& view)
+    {
+        radarView.clear();
+        for (int j = 0; j < VIEW_COLS; j++)
+            radarView.put(0, 5 + j * 2, (char)('0' + ((viewport.cellY + j) % 10 + 10) % 10), COLOR_SUBTITLE);
+
+        for (int i = 0; i < VIEW_ROWS; i++) {
+            radarView.put(i + 1, 2, (char)('0' + ((viewport.cellX + i) % 10 + 10) % 10), COLOR_SUBTITLE);
+            for (int j = 0; j < VIEW_COLS; j++) {
+                char glyph;
+                int cellColor;
+                radarGlyph(view, viewport.cellX + i, viewport.cellY + j, glyph, cellColor);
+                radarView.put(i + 1, 5 + j * 2, glyph, cellColor);
+            }
+        }
+
+        long span = viewport.getCellSpan();
+        string line = "  View: x ";
+        appendNumber(line, viewport.getWorldX());
+        line += "..";
+        appendNumber(line, viewport.getWorldX() + VIEW_ROWS * span - 1);
+        line += ", y ";
+        appendNumber(line, viewport.getWorldY());
+        line += "..";
+        appendNumber(line, viewport.getWorldY() + VIEW_COLS * span - 1);
+        line += ", 1 cell = ";
+        appendNumber(line, span);
+        line += (span == 1) ? " unit, " : " units, ";
+        appendNumber(line, view.traffic.getTotal());
+        line += " aircraft";
+        radarView.putText(VIEW_ROWS + 1, 0, line, COLOR_INFO);
+
+        int col = radarView.putText(VIEW_ROWS + 2, 2, "Legend: ", COLOR_INFO);
+        col = radarView.putText(VIEW_ROWS + 2, col, "[A] Airport  ", COLOR_SUCCESS);
+        col = radarView.putText(VIEW_ROWS + 2, col, "[W] Waypoint  ", COLOR_SUBTITLE);
+        col = radarView.putText(VIEW_ROWS + 2, col, "[P] Plane  ", COLOR_CRITICAL);
+        radarView.putText(VIEW_ROWS + 2, col, "[.] Empty Sky", COLOR_SUBTITLE);
+        col = radarView.putText(VIEW_ROWS + 3, 10, "[2-9] Planes in cell  ", COLOR_CRITICAL);
+        col = radarView.putText(VIEW_ROWS + 3, col, "[+] 10+  ", COLOR_WARNING);
+        radarView.putText(VIEW_ROWS + 3, col, "[#] 100+  [@] 1000+", COLOR_DANGER);
+    }
+
+    // w/a/s/d pan a quarter of the view, +/- zoom by a factor of two,
+    // f fits everything on the radar, r returns to the 1:1 home view
+    void navigateRadar(const string& keys)
+    {
+        for (size_t k = 0; k < keys.length(); k++) {
+            switch (keys[k]) {
+            case 'w': viewport.pan(-VIEW_ROWS / 4, 0); break;
+            case 's': viewport.pan(VIEW_ROWS / 4, 0); break;
+            case 'a': viewport.pan(0, -VIEW_COLS / 4); break;
+            case 'd': viewport.pan(0, VIEW_COLS / 4); break;
+            case '+': viewport.zoomIn(); break;
+            case '-': viewport.zoomOut(); break;
+            case 'f': {
+                long x0, x1, y0, y1;
+                if (radarModel.getBounds(x0, x1, y0, y1)) viewport.fit(x0, x1, y0, y1);
+                break;
+            }
+            case 'r': viewport = RadarViewport(VIEW_ROWS, VIEW_COLS); break;
+            }
+        }
+    }
+
     void displayRadar()
     {
         setColor(COLOR_HEADER);
@@ -151,37 +467,101 @@ private:
         cout << "|||===========================================================|||\n";
         setColor(COLOR_RESET);
 
-        setColor(COLOR_SUBTITLE);
-        cout << "     ";
-        for (int i = 0; i < GRID_SIZE; i++) cout << i % 10 << " ";
-        cout << "\n";
-        setColor(COLOR_RESET);
-
-        for (int i = 0; i < GRID_SIZE; i++) {
-            setColor(COLOR_SUBTITLE);
-            cout << "  " << i % 10 << "  ";
-            setColor(COLOR_RESET);
+        while (true) {
+            {
+                SnapshotReader<AirspaceSnapshot> view(snapshots);
+                composeRadar(*view);
+            }
+            radarView.presentInline();
+            string keys = readLine("\n  Pan w/a/s/d, zoom +/-, f fit, r home (Enter to return): ");
+            if (keys.empty()) break;
+            navigateRadar(keys);
+        }
+    }
 
-            for (int j = 0; j < GRID_SIZE; j++) {
-                if (radar[i][j] == 'A') setColor(COLOR_SUCCESS);
-                else if (radar[i][j] == 'P') setColor(COLOR_CRITICAL);
-                else setColor(COLOR_SUBTITLE);
+    // One leg of flying for every airborne flight: each moves to the next
+    // node on its shortest path to the airport it will land at, or holds
+    // if that node is taken. Returns how many flights moved.
+    int flyTowardsAirports()
+    {
+        ScratchScope scope;
+        string* path = scratchArena().allocate<string>(airspace.getNodeCount());
+        int moved = 0;
+        auto fly = [this, path, &moved](Aircraft& aircraft) {
+            string airport = landingAirportFor(aircraft);
+            int pathCount = 0, distance = 0;
+            if (airport == aircraft.currentNode ||
+                airspace.tryGetDijkstraPath(aircraft.currentNode, airport, path, pathCount, distance) != ATC_OK ||
+                pathCount < 2) return;
+            bool escalated = false;
+            if (tryMoveFlight(aircraft, path[1], escalated) == ATC_OK) moved++;
+        };
+        aircraftRegistry.modifyEach(fly);
+        return moved;
+    }
 
-                cout << radar[i][j];
-                setColor(COLOR_RESET);
-                cout << " ";
+    // Runs the simulation while redrawing the radar in place at a fixed
+    // frame rate. Each tick flies every flight one leg towards its airport
+    // and lands the flights that are due; frames between ticks redraw the
+    // latest snapshot. After the first frame only the cells that changed
+    // (the clock, the counters, any moved aircraft) are written.
+    void liveRadar()
+    {
+        int seconds = readInt("  Refresh for how many seconds (1-60): ", 1, 60);
+        int fps = readInt("  Frames per second (1-120): ", 1, 120);
+        int tickRate = readInt("  Simulation ticks per second (1-20): ", 1, 20);
+        int frames = seconds * fps;
+
+        cout << "\x1b[2J\x1b[?25l";
+        cout.flush();
+        radarView.invalidate();
+
+        size_t firstBytes = 0, totalBytes = 0;
+        int ticks = 0, moves = 0, landed = 0;
+        chrono::steady_clock::duration frameTime = chrono::microseconds(1000000 / fps);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        string status;
+        for (int f = 0; f < frames; f++) {
+            ScratchScope scope;
+            long long due = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count()
+                * tickRate / 1000000;
+            if (ticks < due) {
+                for (; ticks < due; ticks++) {
+                    moves += flyTowardsAirports();
+                    LandingSlot* cleared = NULL;
+                    landed += stepSimulation(cleared, false);
+                }
+                publishSnapshot();
             }
-            cout << "\n";
+
+            SnapshotReader<AirspaceSnapshot> view(snapshots);
+            composeRadar(*view);
+            status = "  LIVE  ";
+            status += formatTime(view->clock);
+            status += "  tick ";
+            appendNumber(status, ticks);
+            status += ", landed ";
+            appendNumber(status, landed);
+            status += ", frame ";
+            appendNumber(status, f + 1);
+            status += '/';
+            appendNumber(status, frames);
+            status += "      ";
+            radarView.putText(VIEW_ROWS + 4, 0, status, COLOR_INFO);
+
+            size_t bytes = radarView.present();
+            if (f == 0) firstBytes = bytes;
+            totalBytes += bytes;
+            this_thread::sleep_until(start + frameTime * (f + 1));
         }
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 
+        cout << "\x1b[?25h\x1b[" << radarView.getHeight() + 1 << ";1H";
         setColor(COLOR_INFO);
-        cout << "\n  Legend: ";
-        setColor(COLOR_SUCCESS);
-        cout << "[A] Airport  ";
-        setColor(COLOR_CRITICAL);
-        cout << "[P] Plane  ";
-        setColor(COLOR_SUBTITLE);
-        cout << "[.] Empty Sky\n";
+        cout << "\n  " << frames << " frames in " << elapsed << " s (" << (elapsed > 0 ? frames / elapsed : 0) << " FPS)\n";
+        cout << "  " << ticks << " ticks: " << moves << " legs flown, " << landed << " landed\n";
+        cout << "  First frame: " << firstBytes << " bytes, later frames: "
+            << (frames > 1 ? (totalBytes - firstBytes) / (frames - 1) : 0) << " bytes on average\n";
         setColor(COLOR_RESET);
     }
 
@@ -193,34 +573,37 @@ private:
         cout << "|||===========================================================|||\n";
         setColor(COLOR_RESET);
 
-        try {
-            Aircraft next = landingQueue.peek();
-            setColor(COLOR_SUCCESS);
-            cout << "  NEXT TO LAND: ";
-            setColor(MENU);
-            cout << next.flightID;
-            setColor(COLOR_INFO);
-            cout << " [Priority: ";
-
-            if (next.priority == 1) setColor(COLOR_DANGER);
-            else if (next.priority == 2) setColor(COLOR_WARNING);
-            else setColor(COLOR_INFO);
-
-            cout << next.priority << " - " << getPriorityString(next.priority);
-            setColor(COLOR_INFO);
-            cout << "]\n";
-
-            setColor(COLOR_SUBTITLE);
-            cout << "  Aircraft in queue: ";
-            setColor(MENU);
-            cout << landingQueue.getSize() << endl;
-            setColor(COLOR_RESET);
-        }
-        catch (EmptyQueueException& e) {
+        LandingSlot slot;
+        if (landingScheduler.tryPeek(slot) != ATC_OK) {
             setColor(COLOR_WARNING);
             cout << "  No aircraft in landing queue.\n";
             setColor(COLOR_RESET);
+            return;
         }
+
+        Aircraft& next = slot.aircraft;
+        setColor(COLOR_SUCCESS);
+        cout << "  NEXT TO LAND: ";
+        setColor(MENU);
+        cout << next.flightID;
+        setColor(COLOR_INFO);
+        cout << " at " << slot.airport << " [Priority: ";
+
+        if (next.priority == 1) setColor(COLOR_DANGER);
+        else if (next.priority == 2) setColor(COLOR_WARNING);
+        else setColor(COLOR_INFO);
+
+        cout << next.priority << " - " << getPriorityString(next.priority);
+        int effective = effectivePriority(next, currentTime());
+        if (effective < next.priority) cout << ", aged to " << effective;
+        setColor(COLOR_INFO);
+        cout << "]\n";
+
+        setColor(COLOR_SUBTITLE);
+        cout << "  Aircraft in queue: ";
+        setColor(MENU);
+        cout << landingScheduler.getSize() << endl;
+        setColor(COLOR_RESET);
     }
 
     string getPriorityString(int priority)
@@ -242,184 +625,1561 @@ private:
         cout << "|||===========================================================|||\n";
         setColor(COLOR_RESET);
 
+        SnapshotReader<AirspaceSnapshot> view(snapshots);
         setColor(COLOR_INFO);
         cout << "  Active Flights: ";
         setColor(MENU);
-        cout << aircraftRegistry.getCount() << endl;
+        cout << view->aircraftCount << endl;
 
         setColor(COLOR_INFO);
         cout << "  Landing Queue: ";
         setColor(MENU);
-        cout << landingQueue.getSize() << endl;
+        cout << view->queued << endl;
 
         setColor(COLOR_INFO);
         cout << "  Completed Flights: ";
         setColor(MENU);
-        cout << flightLog.getCount() << endl;
+        cout << view->logged << endl;
 
-        setColor(COLOR_RESET);
-    }
+        if (view->landingsLastHour >= 0) {
+            setColor(COLOR_INFO);
+            cout << "  Landings (last hour): ";
+            setColor(MENU);
+            cout << view->landingsLastHour << endl;
+        }
+        if (view->waitEwma >= 0) {
+            setColor(COLOR_INFO);
+            cout << "  Recent Wait (EWMA): ";
+            setColor(MENU);
+            cout << formatDuration(view->waitEwma) << endl;
+        }
 
-public:
-    SkyNetATC()
-    {
-        srand((unsigned)time(0));
-        initializeRadar();
-        initializeAirspace();
+        const CheckpointReport& saved = checkpointer.getLast();
+        if (checkpointer.isRunning()) {
+            setColor(COLOR_INFO);
+            cout << "  Checkpoint: ";
+            setColor(MENU);
+            cout << "writing version " << checkpointer.getVersion() << ", " << checkpointer.getPercent() << "%, "
+                << checkpointer.getBytesWritten() / 1024 << " KB so far" << endl;
+        }
+        else if (saved.version > 0 && saved.error.empty()) {
+            setColor(COLOR_INFO);
+            cout << "  Last Checkpoint: ";
+            setColor(MENU);
+            cout << "version " << saved.version << ", " << saved.records << " records, " << saved.bytes / 1024
+                << " KB in " << saved.micros / 1000.0 << " ms" << endl;
+        }
+        else if (!saved.error.empty()) {
+            setColor(COLOR_DANGER);
+            cout << "  Last Checkpoint failed: " << saved.error << endl;
+        }
+
+        setColor(COLOR_RESET);
     }
 
-    void addFlight()
+    void displayAnalytics()
     {
-        try {
-            setColor(COLOR_HEADER);
-            cout << "\n|||===========================================================|||\n";
-            cout << "|||                     ADD NEW FLIGHT                        |||\n";
-            cout << "|||===========================================================|||\n";
+        long now = currentTime();
+        int landings = analytics.getLandings();
+        if (landings == 0) {
+            setColor(COLOR_WARNING);
+            cout << "\n  No landings recorded yet.\n";
             setColor(COLOR_RESET);
+            return;
+        }
 
-            string flightID = readString("  Flight ID (e.g., PK-786): ");
-            string model = readString("  Aircraft Model (e.g., Boeing737): ");
-            int fuelLevel = readInt("  Fuel Level (0-100%): ", 0, 100);
-            string origin = readString("  Origin Airport: ");
-            string destination = readString("  Destination Airport: ");
-            int priority = readInt("  Priority (1=CRITICAL, 2=HIGH, 3=MEDIUM, 4=LOW): ", 1, 4);
-
-            Aircraft newAircraft(flightID, model, fuelLevel, origin, destination, priority);
-            newAircraft.validate();
+        setColor(COLOR_SUBTITLE);
+        cout << "\n  Landings: ";
+        setColor(MENU);
+        cout << landings << "  (last hour: " << analytics.getLandingsLastHour(now) << ")\n";
 
-            // --- FIX STARTS HERE ---//here
+        setColor(COLOR_SUBTITLE);
+        cout << "  Priority mix:\n";
+        for (int p = 1; p <= FlightLogAnalytics::MAX_PRIORITY; p++) {
+            setColor(COLOR_INFO);
+            cout << "    " << getPriorityString(p) << ": ";
+            setColor(MENU);
+            cout << analytics.getPriorityCount(p) << " (" << (int)(analytics.getPriorityShare(p) * 100 + 0.5) << "%)\n";
+        }
+        setColor(COLOR_SUBTITLE);
+        cout << "  Emergency rate (CRITICAL + HIGH): ";
+        setColor(MENU);
+        cout << (int)(analytics.getEmergencyRate() * 100 + 0.5) << "%\n";
 
-            // 1. Use the 'origin' string the user typed as the start node
-            string startNode = origin;
-            GraphNode* startGraphNode = airspace.getNodeByName(startNode);
+        if (analytics.getWaitSamples() > 0) {
+            setColor(COLOR_SUBTITLE);
+            cout << "  Wait from queue entry to landing:\n";
+            setColor(COLOR_INFO);
+            cout << "    Mean " << formatDuration(analytics.getAverageWait())
+                << "   EWMA " << formatDuration(analytics.getWaitEwma()) << "\n";
+            cout << "    p50 " << formatDuration(analytics.getWaitPercentile(0.50))
+                << "   p90 " << formatDuration(analytics.getWaitPercentile(0.90))
+                << "   p99 " << formatDuration(analytics.getWaitPercentile(0.99)) << "\n";
+        }
 
-            // 2. Validate: Does this place exist?
-            if (startGraphNode == NULL)
-                throw InvalidInputException("Origin '" + origin + "' not found in airspace");
+        setColor(COLOR_SUBTITLE);
+        cout << "  Per airport (total / last 24h / mean wait):\n";
+        for (int i = 0; i < analytics.getAirportCount(); i++) {
+            setColor(COLOR_INFO);
+            cout << "    " << analytics.getAirportName(i) << "  ";
+            setColor(MENU);
+            cout << analytics.getAirportLandings(i) << " / "
+                << analytics.getAirportLandingsRecent(i, now, 24) << " / "
+                << formatDuration(analytics.getAirportAverageWait(i)) << "\n";
+        }
+        setColor(COLOR_RESET);
+    }
 
-            // 3. Validate: Is it actually an Airport? (Prevent spawning at waypoints)
-            if (!startGraphNode->isAirport)
-                throw InvalidInputException("Location '" + origin + "' is not a valid Airport");
+    // Times one landing queue engine on the same synthetic fleet and counts
+    // how often two flights of equal priority left out of arrival order
+    template <typename Queue>
+    void runQueueBenchmark(const char* engineName, Aircraft* fleet, int count)
+    {
+        Queue queue(count);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+        for (int i = 0; i < count; i++)
+            queue.insert(fleet[i]);
+        for (int i = 0; i < count; i += 10)
+            queue.tryDecreaseKey(fleet[i].flightID, 1);
+
+        int fifoViolations = 0;
+        int lastPriority = 0;
+        int lastArrival = -1;
+        Aircraft next;
+        while (queue.tryExtractMin(next) == ATC_OK) {
+            int arrival = (int)next.timestamp;
+            if (next.priority == lastPriority && arrival < lastArrival) fifoViolations++;
+            lastPriority = next.priority;
+            lastArrival = arrival;
+        }
 
-            // 4. Validate: Is it occupied?
-            if (airspace.isNodeOccupied(startNode))
-                throw CollisionException("Airport " + origin + " is currently occupied at (" + toString(startGraphNode->x) + ", " + toString(startGraphNode->y) + ")");
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
 
-            // --- FIX ENDS HERE ---
+        setColor(MENU);
+        cout << "  " << engineName;
+        setColor(COLOR_INFO);
+        cout << "  time: " << ms << " ms";
+        setColor(fifoViolations == 0 ? COLOR_SUCCESS : COLOR_WARNING);
+        cout << "  out-of-order ties: " << fifoViolations << "\n";
+        setColor(COLOR_RESET);
+    }
 
-            newAircraft.x = startGraphNode->x;
-            newAircraft.y = startGraphNode->y;
-            newAircraft.currentNode = startNode;
+    void benchmarkLandingQueues()
+    {
+        int count = readInt("  Number of aircraft (100-200000): ", 100, 200000);
+
+        // timestamp doubles as the arrival sequence number
+        Aircraft* fleet = new Aircraft[count];
+        for (int i = 0; i < count; i++) {
+            fleet[i].flightID = "BM-" + toString(i);
+            fleet[i].priority = 2 + rand() % 3;
+            fleet[i].timestamp = i;
+        }
 
-            aircraftRegistry.insert(flightID, newAircraft);
-            landingQueue.insert(newAircraft);
-            airspace.occupyNode(startNode, flightID);
-            radar[newAircraft.x][newAircraft.y] = 'P';
+        setColor(COLOR_INFO);
+        cout << "\n  insert " << count << ", re-prioritize every 10th, land all:\n";
+        setColor(COLOR_RESET);
+        runQueueBenchmark<MinHeap>("MinHeap    ", fleet, count);
+        runQueueBenchmark<BucketQueue>("BucketQueue", fleet, count);
 
-            setColor(COLOR_SUCCESS);
-            cout << "\n  Flight " << flightID << " added successfully!\n";
-            cout << "  Starting at: " << startNode << " (" << newAircraft.x << ", " << newAircraft.y << ")\n";
-            setColor(COLOR_RESET);
-        }
-        catch (AircraftException& e) {
-            setColor(COLOR_DANGER);
-            cout << "\n  Issue: " << e.what() << "\n";
-            setColor(COLOR_RESET);
-        }
+        delete[] fleet;
     }
 
-    void declareEmergency()
+    void benchmarkArrivalManager()
     {
-        try {
-            setColor(COLOR_HEADER);
-            cout << "\n|||===========================================================|||\n";
-            cout << "|||                   DECLARE EMERGENCY                       |||\n";
-            cout << "|||===========================================================|||\n";
-            setColor(COLOR_RESET);
+        int count = readInt("  Arrivals per airport (10-2000): ", 10, 2000);
+        int runways = readInt("  Runways (1-4): ", 1, 4);
+
+        ArrivalCandidate* arrivals = new ArrivalCandidate[count];
+        long runwayFree[4] = { 0, 0, 0, 0 };
+        for (int i = 0; i < count; i++) {
+            arrivals[i].eta = rand() % (count * 45);
+            arrivals[i].fuelDeadline = arrivals[i].eta + 300 + rand() % 3600;
+            arrivals[i].weight = ArrivalManager::classWeight(1 + rand() % 4);
+        }
 
-            string flightID = readString("  Enter Flight ID: ");
-            Aircraft* aircraft = aircraftRegistry.search(flightID);
+        ArrivalManager manager;
+        const int runs = 20;
+        long long cost = 0;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int i = 0; i < runs; i++)
+            cost = manager.sequence(arrivals, count, runways, 60, runwayFree, 0);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() / runs;
 
-            if (aircraft == NULL)
-                throw FlightNotFoundException(flightID);
+        setColor(COLOR_INFO);
+        cout << "\n  First-come cost: ";
+        setColor(MENU);
+        cout << manager.getInitialCost();
+        setColor(COLOR_INFO);
+        cout << "\n  Optimized cost:  ";
+        setColor(COLOR_SUCCESS);
+        cout << cost;
+        setColor(COLOR_INFO);
+        cout << "\n  Time per sequence: ";
+        setColor(MENU);
+        cout << ms << " ms\n";
+        setColor(COLOR_RESET);
 
-            setColor(COLOR_WARNING);
-            cout << "\n  Emergency Types:\n";
-            setColor(COLOR_RESET);
-            cout << "    1. Medical Emergency\n";
-            cout << "    2. Engine Failure\n";
-            cout << "    3. Hijack\n";
-            cout << "    4. Low Fuel\n";
+        delete[] arrivals;
+    }
 
-            int choice = readInt("  Choice: ", 1, 4);
-            int newPriority = 1;
+    template <typename Log>
+    void runLogBenchmark(const char* engineName, Aircraft* records, int count)
+    {
+        Log* log = new Log();
 
-            if (choice == 4) {
-                int fuelLevel = readInt("  Enter current fuel level (0-100%): ", 0, 100);
-                aircraft->fuelLevel = fuelLevel;
-                newPriority = (fuelLevel < 10) ? 2 : 3;
-            }
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        log->insertBatch(records, count);
+        double insertMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
 
-            aircraft->priority = newPriority;
-            aircraft->status = "EMERGENCY";
-            aircraftRegistry.update(flightID, *aircraft);
-            landingQueue.decreaseKey(flightID, newPriority);
+        long long fuelTotal = 0;
+        auto sumFuel = [&fuelTotal](const Aircraft& record) { fuelTotal += record.fuelLevel; };
+        start = chrono::steady_clock::now();
+        log->forEach(sumFuel);
+        double scanMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
 
-            setColor(COLOR_SUCCESS);
-            cout << "\n  Emergency declared! " << flightID << " moved to priority " << newPriority << "\n";
-            if (choice == 4 && aircraft->fuelLevel < 10)
-                cout << "  Fuel level " << aircraft->fuelLevel << "% (LOW FUEL - HIGH PRIORITY)\n";
-            setColor(COLOR_RESET);
-        }
-        catch (AircraftException& e) {
-            setColor(COLOR_DANGER);
-            cout << "\n  Issue: " << e.what() << "\n";
-            setColor(COLOR_RESET);
-        }
+        setColor(MENU);
+        cout << "  " << engineName;
+        setColor(COLOR_INFO);
+        cout << "  insert: " << insertMs << " ms  scan: " << scanMs << " ms  (checksum " << fuelTotal << ")\n";
+        setColor(COLOR_RESET);
+
+        delete log;
     }
 
-    void landFlight()
+    void benchmarkFlightLogs()
     {
-        try {
-            Aircraft landed = landingQueue.extractMin();
-            // Check if the current node is an airport before clearing
-            GraphNode* node = airspace.getNodeByName(landed.currentNode);
-            if (node != NULL && node->isAirport) {
-                radar[landed.x][landed.y] = 'A'; // Restore Airport icon
-            }
-            else {
-                radar[landed.x][landed.y] = '.'; // Clear to empty sky
-            }
-            airspace.freeNode(landed.currentNode);
-            landed.status = "Landed";
-
-            // Get real timestamp (seconds since epoch)
-            auto now = chrono::system_clock::now();
-            landed.timestamp = chrono::duration_cast<chrono::seconds>(
-                now.time_since_epoch()).count();
+        int count = readInt("  Number of landings (1000-2000000): ", 1000, 2000000);
+
+        // Nearly monotonic timestamps, like real landings
+        Aircraft* records = new Aircraft[count];
+        long base = currentTime();
+        for (int i = 0; i < count; i++) {
+            records[i].flightID = "LG-" + toString(rand() % 5000);
+            records[i].model = (i % 3 == 0) ? "Boeing737" : "AirbusA320";
+            records[i].origin = "PSW";
+            records[i].destination = "KHI";
+            records[i].status = "Landed";
+            records[i].currentNode = "KHI";
+            records[i].fuelLevel = rand() % 100;
+            records[i].priority = 1 + rand() % 4;
+            records[i].timestamp = base + i * 30 - rand() % 60;
+        }
 
-            aircraftRegistry.remove(landed.flightID);
-            flightLog.insert(landed);
+        setColor(COLOR_INFO);
+        cout << "\n  insert " << count << " landings, then scan them in time order:\n";
+        setColor(COLOR_RESET);
+        runLogBenchmark<AVLTree>("AVLTree       ", records, count);
+        runLogBenchmark<FlightLogStore>("FlightLogStore", records, count);
+
+        // Both engines keep the same secondary indexes; AVLTree pays for
+        // them on insert, FlightLogStore on its first lookup
+        FlightLogIndex* index = new FlightLogIndex();
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int i = 0; i < count; i++) index->add(records[i], i);
+        double indexMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        setColor(COLOR_INFO);
+        cout << "  (the shared flight/airport/model index takes " << indexMs
+            << " ms: inside AVLTree's insert, deferred to FlightLogStore's first lookup)\n";
+        setColor(COLOR_RESET);
+        delete index;
 
-            setColor(COLOR_SUCCESS);
-            cout << "\n  Flight " << landed.flightID << " has landed safely!\n";
-            setColor(COLOR_INFO);
-            cout << "    Priority was: " << getPriorityString(landed.priority) << "\n";
-            cout << "    Landed at: " << landed.currentNode << "\n";
+        delete[] records;
+    }
 
-            // Display timestamp
-            time_t rawtime = (time_t)landed.timestamp;
-            struct tm timeinfo;
-            localtime_s(&timeinfo, &rawtime);
-            char buffer[80];
-            strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &timeinfo);
-            cout << "    Time: " << buffer << "\n";
+    template <typename T>
+    void printPoolStats(const char* poolName, NodePool<T>& pool)
+    {
+        setColor(MENU);
+        cout << "  " << poolName;
+        setColor(COLOR_INFO);
+        cout << "  live " << pool.getLive() << "  peak " << pool.getPeak()
+            << "  allocs " << pool.getAllocations() << "  frees " << pool.getFrees()
+            << "  slabs " << pool.getSlabCount() << " (" << pool.getCapacity() << " slots)"
+            << "  fragmentation " << (int)(pool.getFragmentation() * 100 + 0.5) << "%\n";
+        setColor(COLOR_RESET);
+    }
 
+    // Shows the live node pools, then churns a registry (remove one flight,
+    // register another) and a flight log to show slot reuse
+    void benchmarkNodePools()
+    {
+        setColor(COLOR_INFO);
+        cout << "\n  Live pools:\n";
+        printPoolStats("Airspace edges  ", airspace.getEdgePool());
+
+        int count = readInt("\n  Churn operations (1000-2000000): ", 1000, 2000000);
+        const int RESIDENT = 1000;
+
+        HashTable* registry = new HashTable();
+        Aircraft aircraft;
+        aircraft.model = "Boeing737";
+        aircraft.origin = "PSW";
+        aircraft.destination = "KHI";
+        aircraft.status = "In Flight";
+        for (int i = 0; i < RESIDENT; i++) {
+            aircraft.flightID = "PL-" + toString(i);
+            registry->insert(aircraft.flightID, aircraft);
+        }
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int i = 0; i < count; i++) {
+            registry->remove("PL-" + toString(i));
+            aircraft.flightID = "PL-" + toString(i + RESIDENT);
+            registry->insert(aircraft.flightID, aircraft);
+        }
+        double churnMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        AVLTree* log = new AVLTree();
+        aircraft.status = "Landed";
+        long base = currentTime();
+        for (int i = 0; i < count; i++) {
+            aircraft.timestamp = base + i * 30 - rand() % 60;
+            log->insert(aircraft);
+        }
+
+        setColor(COLOR_INFO);
+        cout << "\n  " << count << " remove/insert pairs on a " << RESIDENT << "-flight registry: " << churnMs << " ms\n";
+        setColor(COLOR_RESET);
+        printPoolStats("Registry nodes  ", registry->getNodePool());
+        printPoolStats("Flight log nodes", log->getNodePool());
+
+        delete registry;
+        delete log;
+    }
+
+    void printPhase(const char* phase, int operations, chrono::steady_clock::time_point& start)
+    {
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+        double ms = chrono::duration<double, milli>(now - start).count();
+        setColor(MENU);
+        cout << "  " << phase;
+        setColor(COLOR_INFO);
+        cout << "  " << operations << " ops in " << ms << " ms ("
+            << (operations ? ms * 1000000.0 / operations : 0) << " ns/op)\n";
+        setColor(COLOR_RESET);
+        start = now;
+    }
+
+    // Runs a large fleet end to end through a separate engine on a grid
+    // airspace with an airport at every node: admitFlight, raisePriority
+    // for every tenth flight, one leg per flight through tryMoveFlight, a
+    // checkpoint and restoreData, then landBatch until every flight is in
+    // the flight log. The live system and its files are not touched.
+    void stressTestScale()
+    {
+        const int GRID_COLS = 1024;
+        const int HUBS = 64;                // airports with runways, the destinations
+        const long long STRIDE = 1000003;   // prime: spreads origins over the grid
+        const int LAND_BATCH = 4096;
+
+        int count = readInt("  Concurrent flights (1000-1000000): ", 1000, 1000000);
+        // a quarter more nodes than flights, so moves find free neighbours
+        int gridRows = (int)(((long long)count * 5 / 4 + GRID_COLS - 1) / GRID_COLS);
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        SkyNetATC* engine = new SkyNetATC(GRID_COLS, gridRows, "stress");
+        engine->flightLog.removeArchive();     // left over from an interrupted run
+        Graph& grid = engine->airspace;
+        int nodeCount = grid.getNodeCount();
+        DynamicArray<string> hubs;
+        for (int h = 0; h < HUBS; h++) {
+            hubs.push(grid.getNodeAt((int)((long long)h * nodeCount / HUBS))->name);
+            engine->landingScheduler.configureAirport(hubs.back(), 2, 60);
+        }
+
+        setColor(COLOR_INFO);
+        cout << "\n  " << count << " flights on a " << GRID_COLS << " x " << gridRows << " grid, "
+            << nodeCount << " airports, " << HUBS << " with runways:\n";
+        setColor(COLOR_RESET);
+        printPhase("airspace ", nodeCount, start);
+
+        int admitted = 0;
+        for (int i = 0; i < count; i++) {
+            Aircraft aircraft("ST-" + toString(i), "AirbusA320", 20 + rand() % 80,
+                grid.getNodeAt((int)(i * STRIDE % nodeCount))->name, hubs[rand() % HUBS], 3 + rand() % 2);
+            try {
+                engine->admitFlight(aircraft);
+                admitted++;
+            }
+            catch (AircraftException&) {
+            }
+        }
+        printPhase("admit    ", admitted, start);
+
+        int emergencies = 0;
+        auto raise = [engine, &emergencies](Aircraft& aircraft) {
+            if (engine->raisePriority(aircraft, 1) == ATC_OK) emergencies++;
+        };
+        for (int i = 0; i < count; i += 10) engine->aircraftRegistry.tryModify("ST-" + toString(i), raise);
+        printPhase("emergency", emergencies, start);
+
+        int moves = 0, blocked = 0;
+        auto move = [engine, &grid, &moves, &blocked](Aircraft& aircraft) {
+            Edge* edge = grid.getEdges(grid.getNodeIndex(aircraft.currentNode));
+            bool escalated = false;
+            while (edge != NULL && engine->tryMoveFlight(aircraft, edge->destination, escalated) != ATC_OK)
+                edge = edge->next;
+            if (edge != NULL) moves++;
+            else blocked++;
+        };
+        engine->aircraftRegistry.modifyEach(move);
+        printPhase("move     ", moves + blocked, start);
+
+        engine->publishSnapshot();
+        engine->startCheckpoint();
+        engine->checkpointer.wait();
+        CheckpointReport saved = engine->checkpointer.getLast();
+        printPhase("save     ", saved.records, start);
+
+        int loaded = 0, requeued = 0;
+        try {
+            loaded = engine->restoreData();
+            requeued = engine->landingScheduler.getSize();
+        }
+        catch (AircraftException& e) {
+            saved.error = e.what();
+        }
+        printPhase("load     ", loaded, start);
+
+        int landed = 0;
+        DynamicArray<LandingSlot> cleared;
+        cleared.resize(LAND_BATCH);
+        int n;
+        while ((n = engine->landingScheduler.extractTopK(cleared.data(), LAND_BATCH, engine->currentTime())) > 0) {
+            engine->landBatch(cleared.data(), n);
+            landed += n;
+        }
+        printPhase("land     ", landed, start);
+
+        int logged = engine->flightLog.getCount();
+        int stillOccupied = grid.getOccupiedCount();
+        bool intact = saved.error.empty() && loaded == admitted && requeued == admitted && landed == admitted &&
+            logged == admitted && engine->aircraftRegistry.getCount() == 0 && stillOccupied == 0;
+        setColor(intact ? COLOR_SUCCESS : COLOR_DANGER);
+        cout << "\n  " << admitted << " admitted, " << emergencies << " emergencies, " << moves << " moved ("
+            << blocked << " blocked), " << loaded << " reloaded, " << landed << " landed, " << logged
+            << " in the flight log, " << stillOccupied << " nodes left occupied" << (intact ? "" : "  (MISMATCH)") << "\n";
+        if (!saved.error.empty()) cout << "  " << saved.error << "\n";
+        setColor(COLOR_RESET);
+
+        engine->flightLog.removeArchive();
+        remove(engine->registryFile.c_str());
+        remove(engine->logFile.c_str());
+        delete engine;
+    }
+
+    // Counts heap allocations across simulation ticks on a separate engine.
+    // Warm-up ticks grow the scratch arena and the scheduler's planning
+    // buffers; after that no tick may allocate, neither while the fleet is
+    // en route nor while flights land (registry, flight log, analytics).
+    void checkTickAllocations()
+    {
+        const int GRID_SIZE = 32;
+        const int FLIGHTS = 64;
+        const int LANDERS = 32;
+        const int WARMUP_TICKS = 3;
+        const int MEASURED_TICKS = 12;
+
+        SkyNetATC* engine = new SkyNetATC(GRID_SIZE, GRID_SIZE, "alloccheck");
+        engine->flightLog.removeArchive();
+        Graph& grid = engine->airspace;
+        string hub = grid.getNodeAt(0)->name;
+        engine->landingScheduler.configureAirport(hub, 4, 60);
+
+        // origins in the last quarter of the grid, more than WARMUP_TICKS +
+        // MEASURED_TICKS of flying from the hub, so nothing lands
+        int firstOrigin = grid.getNodeCount() * 3 / 4;
+        for (int i = 0; i < FLIGHTS; i++) {
+            Aircraft aircraft("AC-" + toString(i), "AirbusA320", 100, grid.getNodeAt(firstOrigin + i * 4)->name,
+                hub, 3 + i % 2);
+            engine->admitFlight(aircraft);
+        }
+
+        int landed = 0;
+        long cruising = measureTicks(engine, WARMUP_TICKS, MEASURED_TICKS, landed);
+        bool clean = (cruising == 0 && landed == 0);
+        setColor(clean ? COLOR_SUCCESS : COLOR_DANGER);
+        cout << "\n  " << MEASURED_TICKS << " ticks of " << FLIGHTS << " flights en route after " << WARMUP_TICKS
+            << " warm-up ticks: " << cruising << " heap allocations, " << landed << " landings"
+            << (clean ? "" : "  (FAILED)") << "\n";
+
+        // then flights a few legs from the hub, four to a row of the
+        // grid's corner, so about four of them land on every tick
+        for (int i = 0; i < LANDERS; i++) {
+            Aircraft aircraft("LD-" + toString(i), "AirbusA320", 100,
+                grid.getNodeAt(GRID_SIZE * (1 + i / 4) + i % 4)->name, hub, 3 + i % 2);
+            engine->admitFlight(aircraft);
+        }
+
+        long landing = measureTicks(engine, 1, LANDERS / 4, landed);
+        clean = (landing == 0 && landed > 0);
+        setColor(clean ? COLOR_SUCCESS : COLOR_DANGER);
+        cout << "  " << LANDERS / 4 << " landing ticks after 1 warm-up tick: " << landing
+            << " heap allocations, " << landed << " landings" << (clean ? "" : "  (FAILED)") << "\n";
+        setColor(COLOR_RESET);
+
+        engine->flightLog.removeArchive();
+        delete engine;
+    }
+
+    // Runs warmup unmeasured ticks then measured ones on engine; returns the
+    // heap allocations made by the measured ticks and sets landed
+    long measureTicks(SkyNetATC* engine, int warmup, int measured, int& landed)
+    {
+        long allocations = 0;
+        landed = 0;
+        for (int t = 0; t < warmup + measured; t++) {
+            long before = threadHeapAllocations;
+            int count;
+            {
+                ScratchScope scope;
+                LandingSlot* cleared = NULL;
+                count = engine->stepSimulation(cleared, false);
+            }
+            if (t < warmup) continue;
+            allocations += threadHeapAllocations - before;
+            landed += count;
+        }
+        return allocations;
+    }
+
+    // Sector scaling on a synthetic grid airspace: the same fleet shuttles
+    // between airports for a fixed number of ticks with 1, 2, 4 and 8
+    // sectors, each sector on its own thread
+    void benchmarkSectors()
+    {
+        const int GRID_COLS = 128;
+        const int GRID_ROWS = 64;
+        const int AIRPORT_SPACING = 16;
+        const int TICK_SECONDS = 10;
+
+        int flights = readInt("  Flights (100-4000): ", 100, 4000);
+        int ticks = readInt("  Ticks (10-2000): ", 10, 2000);
+
+        Graph* grid = new Graph();
+        buildGridAirspace(*grid, GRID_COLS, GRID_ROWS, AIRPORT_SPACING);
+        DynamicArray<string> airports;
+        grid->getAirports(airports);
+        int airportCount = airports.size();
+
+        setColor(COLOR_INFO);
+        cout << "\n  " << flights << " flights, " << ticks << " ticks, " << grid->getNodeCount() << " nodes, "
+            << airportCount << " airports, " << thread::hardware_concurrency() << " hardware threads:\n";
+        setColor(COLOR_RESET);
+
+        double baseRate = 0;
+        for (int sectorCount = 1; sectorCount <= 8; sectorCount *= 2) {
+            SectorCoordinator* coordinator = new SectorCoordinator(*grid, sectorCount, 1024, 4, 30);
+            coordinator->setTurnaround(true);
+
+            Aircraft aircraft;
+            aircraft.model = "AirbusA320";
+            aircraft.status = "In Flight";
+            aircraft.priority = 4;
+            for (int i = 0; i < flights; i++) {
+                int from = i % airportCount;
+                int to = (from + 1 + (i * 7) % (airportCount - 1)) % airportCount;
+                aircraft.flightID = "SC-" + toString(i);
+                aircraft.fuelLevel = 20 + i % 80;
+                aircraft.origin = airports[from];
+                aircraft.destination = airports[to];
+                aircraft.currentNode = airports[from];
+                coordinator->tryLaunch(aircraft);
+            }
+
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            coordinator->run(ticks, TICK_SECONDS);
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+            long hops = 0, handoffs = 0, landed = 0, blocked = 0;
+            for (int s = 0; s < sectorCount; s++) {
+                Sector* sector = coordinator->getSector(s);
+                hops += sector->getMoves() + sector->getHandoffsOut();
+                handoffs += sector->getHandoffsOut();
+                landed += sector->getLanded();
+                blocked += sector->getBlocked();
+            }
+            double rate = (ms > 0) ? hops * 1000.0 / ms : 0;
+            if (sectorCount == 1) baseRate = rate;
+            bool intact = coordinator->getAircraftCount() == flights;
+
+            setColor(MENU);
+            cout << "  " << sectorCount << " sector" << (sectorCount > 1 ? "s" : " ");
+            setColor(intact ? COLOR_INFO : COLOR_DANGER);
+            cout << "  " << ms << " ms, " << (long)rate << " hops/s ("
+                << (baseRate > 0 ? rate / baseRate : 0) << "x), " << handoffs << " handoffs, "
+                << landed << " landed, " << blocked << " blocked" << (intact ? "" : "  (FLIGHTS LOST)") << "\n";
             setColor(COLOR_RESET);
+
+            delete coordinator;
         }
-        catch (EmptyQueueException& e) {
+
+        delete grid;
+    }
+
+    // Spawns one process per sector of federation and waits for them to
+    // join. On failure the processes already started are stopped and
+    // reaped, and false is returned.
+    bool startSectorProcesses(SectorFederation& federation, const string& segment, ProcessHandle* processes)
+    {
+        FederationHeader& header = federation.getHeader();
+        int started = 0;
+        while (started < header.sectorCount && spawnSectorProcess(segment, started, processes[started])) started++;
+
+        long long deadline = steadyMicros() + 10000000;
+        while (started == header.sectorCount && header.attached.load() < header.sectorCount && steadyMicros() < deadline)
+            this_thread::sleep_for(chrono::milliseconds(1));
+        if (started == header.sectorCount && header.attached.load() == header.sectorCount) return true;
+
+        setColor(COLOR_DANGER);
+        cout << "  Could not start " << header.sectorCount << " sector processes (" << started << " started)\n";
+        setColor(COLOR_RESET);
+        for (int p = 0; p < started; p++) {
+#ifdef _WIN32
+            TerminateProcess(processes[p], 1);
+#else
+            kill(processes[p], SIGTERM);
+#endif
+            waitSectorProcess(processes[p]);
+        }
+        return false;
+    }
+
+    // One sector process, decoding handoffs and answering pings: batched
+    // handoff throughput, then ping-pong round trips
+    void benchmarkFederationTransport()
+    {
+        const int RING_CAPACITY = 1 << 20;
+        const int BATCH = 64;
+        const int PINGS = 20000;
+
+        int messages = readInt("  Handoff messages (10000-10000000): ", 10000, 10000000);
+
+        Graph grid;
+        buildGridAirspace(grid, 128, 64, 16);
+        SectorMap map(grid, 1);
+
+        string segment = federationSegmentName();
+        SectorFederation federation;
+        try {
+            federation.create(segment, FEDERATION_ECHO, 1, grid.getNodeCount(), RING_CAPACITY);
+        }
+        catch (SharedMemoryException& e) {
+            setColor(COLOR_DANGER);
+            cout << "  " << e.what() << "\n";
+            setColor(COLOR_RESET);
+            return;
+        }
+        FederationHeader& header = federation.getHeader();
+        header.gridCols = 128;
+        header.gridRows = 64;
+        header.airportSpacing = 16;
+        federation.open();
+
+        ProcessHandle process;
+        if (!startSectorProcesses(federation, segment, &process)) return;
+
+        int self = federation.getCoordinator();
+        ShmRing& outbox = federation.ring(self, 0);
+        ShmRing& inbox = federation.ring(0, self);
+        ParticipantSlot& mine = federation.getSlot(self);
+
+        SectorHandoff handoff;
+        handoff.aircraft.model = "AirbusA320";
+        handoff.aircraft.status = "In Flight";
+        handoff.aircraft.priority = 3;
+        string payload;
+        long long bytes = 0;
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int i = 0; i < messages; i++) {
+            while (!outbox.hasRoomFor(MAX_HANDOFF_BYTES)) {
+                federation.flush();
+                this_thread::yield();
+            }
+            handoff.node = i % grid.getNodeCount();
+            handoff.aircraft.flightID = "FX-" + toString(i);
+            handoff.aircraft.fuelLevel = i % 100;
+            handoff.aircraft.origin = map.getAirportName(i % map.getAirportCount());
+            handoff.aircraft.destination = map.getAirportName((i + 1) % map.getAirportCount());
+            handoff.aircraft.timestamp = 1700000000 + i;
+            handoff.aircraft.queuedAt = handoff.aircraft.timestamp - 60;
+            encodeHandoff(payload, handoff, map);
+            outbox.tryWrite(MSG_HANDOFF, payload.data(), (int)payload.size());
+            bytes += payload.size();
+            if ((i + 1) % BATCH == 0) federation.flush();
+        }
+        federation.flush();
+        while (!outbox.isDrained()) this_thread::yield();
+        double sendMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        class Counter
+        {
+        public:
+            int replies;
+            void operator()(unsigned char, const char*, int) { replies++; }
+        };
+        Counter counter;
+        counter.replies = 0;
+        auto replied = [&inbox]() { return inbox.hasData(); };
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < PINGS; i++) {
+            payload.clear();
+            appendVarint(payload, (unsigned long long)i);
+            outbox.tryWrite(MSG_ECHO, payload.data(), (int)payload.size());
+            federation.flush();
+            if (!mine.doorbell.wait(replied, 1000000)) break;
+            inbox.drain(counter, INT_MAX);
+        }
+        double pingMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        outbox.tryWrite(MSG_STOP, NULL, 0);
+        federation.flush();
+        int exitCode = waitSectorProcess(process);
+        long long decoded = federation.getSlot(0).stats[STAT_MESSAGES];
+
+        bool intact = (decoded == messages && counter.replies == PINGS && exitCode == 0);
+        setColor(COLOR_INFO);
+        cout << "\n  Handoffs  " << messages << " in " << sendMs << " ms ("
+            << (long)(sendMs > 0 ? messages * 1000.0 / sendMs : 0) << " msg/s, "
+            << (double)bytes / messages << " bytes/msg, batches of " << BATCH << ")\n";
+        cout << "  Ping-pong " << counter.replies << " round trips, "
+            << (counter.replies ? pingMs * 1000.0 / counter.replies : 0) << " us each\n";
+        setColor(intact ? COLOR_SUCCESS : COLOR_DANGER);
+        cout << "  " << decoded << " handoffs decoded by the sector process" << (intact ? "" : "  (MISMATCH)") << "\n";
+        setColor(COLOR_RESET);
+    }
+
+    // Answers route requests from the sector processes by walking the
+    // shared next-hop tables; a reply that does not fit is dropped
+    class RouteServer
+    {
+    public:
+        static const int MAX_ROUTE_NODES = 4096;
+
+        SectorFederation* federation;
+        SectorMap* map;
+        int from;
+        long long served;
+        string reply;
+
+        void operator()(unsigned char type, const char* payload, int length)
+        {
+            if (type != MSG_ROUTE_REQUEST) return;
+            try {
+                const char* p = payload;
+                const char* end = payload + length;
+                unsigned long long id = readVarint(p, end);
+                int node = (int)readVarint(p, end);
+                int slot = (int)readVarint(p, end);
+                if (node >= map->getNodeCount() || slot >= map->getAirportCount()) return;
+
+                reply.clear();
+                appendVarint(reply, id);
+                int distance = map->getDistance(slot, node);
+                appendVarint(reply, zigzag(distance == INT_MAX ? -1 : distance));
+                int count = 0;
+                while (node != -1 && count < MAX_ROUTE_NODES) {
+                    appendVarint(reply, (unsigned long long)node);
+                    count++;
+                    int next = map->nextHop(slot, node);
+                    node = (next == node) ? -1 : next;
+                }
+                federation->ring(federation->getSelf(), from).tryWrite(MSG_ROUTE_REPLY, reply.data(), (int)reply.size());
+                served++;
+            }
+            catch (AircraftException&) {}
+        }
+    };
+
+    // The sector scaling run with every sector in its own process; this
+    // process launches the fleet and serves route requests
+    void runSectorFederation()
+    {
+        const int GRID_COLS = 128;
+        const int GRID_ROWS = 64;
+        const int AIRPORT_SPACING = 16;
+        const int RING_CAPACITY = 1 << 18;
+
+        int sectorCount = readInt("  Sector processes (1-8): ", 1, 8);
+        int flights = readInt("  Flights (100-4000): ", 100, 4000);
+        int ticks = readInt("  Ticks (10-2000): ", 10, 2000);
+
+        Graph grid;
+        buildGridAirspace(grid, GRID_COLS, GRID_ROWS, AIRPORT_SPACING);
+        SectorMap map(grid, sectorCount);
+
+        string segment = federationSegmentName();
+        SectorFederation federation;
+        try {
+            federation.create(segment, FEDERATION_SECTORS, sectorCount, grid.getNodeCount(), RING_CAPACITY);
+        }
+        catch (SharedMemoryException& e) {
+            setColor(COLOR_DANGER);
+            cout << "  " << e.what() << "\n";
+            setColor(COLOR_RESET);
+            return;
+        }
+        FederationHeader& header = federation.getHeader();
+        header.gridCols = GRID_COLS;
+        header.gridRows = GRID_ROWS;
+        header.airportSpacing = AIRPORT_SPACING;
+        header.ticks = ticks;
+        header.tickSeconds = 10;
+        header.runways = 4;
+        header.separation = 30;
+        federation.open();
+
+        ProcessHandle* processes = new ProcessHandle[sectorCount];
+        if (!startSectorProcesses(federation, segment, processes)) {
+            delete[] processes;
+            return;
+        }
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        header.started.store(1, memory_order_release);
+        for (int s = 0; s < sectorCount; s++) federation.getSlot(s).doorbell.ring();
+
+        int self = federation.getCoordinator();
+        RouteServer server;
+        server.federation = &federation;
+        server.map = &map;
+        server.served = 0;
+
+        // Launch the fleet, serving route requests whenever a ring is full
+        SectorHandoff handoff;
+        handoff.aircraft.model = "AirbusA320";
+        handoff.aircraft.status = "In Flight";
+        handoff.aircraft.priority = 4;
+        string payload;
+        int airportCount = map.getAirportCount();
+        for (int i = 0; i < flights; i++) {
+            int from = i % airportCount;
+            int to = (from + 1 + (i * 7) % (airportCount - 1)) % airportCount;
+            handoff.node = map.getAirportNode(from);
+            handoff.aircraft.flightID = "SC-" + toString(i);
+            handoff.aircraft.fuelLevel = 20 + i % 80;
+            handoff.aircraft.origin = map.getAirportName(from);
+            handoff.aircraft.destination = map.getAirportName(to);
+            encodeHandoff(payload, handoff, map);
+
+            ShmRing& ring = federation.ring(self, map.getSector(handoff.node));
+            while (!ring.tryWrite(MSG_HANDOFF, payload.data(), (int)payload.size())) {
+                federation.flush();
+                this_thread::yield();
+            }
+        }
+        federation.flush();
+
+        // Serve until every sector has reported
+        auto busy = [&federation, sectorCount]() {
+            if (federation.hasMail()) return true;
+            for (int s = 0; s < sectorCount; s++)
+                if (federation.getSlot(s).done.load(memory_order_acquire) == 0) return false;
+            return true;
+        };
+        long long progress = -1, stalledSince = steadyMicros();
+        bool stalled = false;
+        while (true) {
+            for (int s = 0; s < sectorCount; s++) {
+                server.from = s;
+                federation.ring(s, self).drain(server, INT_MAX);
+            }
+            federation.flush();
+
+            bool finished = true;
+            long long ticksDone = 0;
+            for (int s = 0; s < sectorCount; s++) {
+                if (federation.getSlot(s).done.load(memory_order_acquire) == 0) finished = false;
+                ticksDone += federation.getSlot(s).ticksDone.load(memory_order_relaxed);
+            }
+            if (finished) break;
+
+            // A sector that crashed stops the others within their peer timeout
+            if (ticksDone != progress) {
+                progress = ticksDone;
+                stalledSince = steadyMicros();
+            }
+            else if (steadyMicros() - stalledSince > 15000000) {
+                stalled = true;
+                break;
+            }
+            federation.getSlot(self).doorbell.wait(busy, 1000);
+        }
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        if (stalled) {
+            for (int s = 0; s < sectorCount; s++) {
+#ifdef _WIN32
+                TerminateProcess(processes[s], 1);
+#else
+                kill(processes[s], SIGTERM);
+#endif
+            }
+        }
+
+        bool clean = true;
+        for (int s = 0; s < sectorCount; s++)
+            if (waitSectorProcess(processes[s]) != 0) clean = false;
+        delete[] processes;
+
+        // Handoffs still in a ring when their receiver finished
+        class HandoffCounter
+        {
+        public:
+            long long count;
+            void operator()(unsigned char type, const char*, int) { if (type == MSG_HANDOFF) count++; }
+        };
+        HandoffCounter inTransit;
+        inTransit.count = 0;
+        for (int from = 0; from <= sectorCount; from++) {
+            for (int to = 0; to < sectorCount; to++)
+                if (from != to) federation.ring(from, to).drain(inTransit, INT_MAX);
+        }
+
+        long long hops = 0, handoffs = 0, landed = 0, replies = 0, replyMicros = 0, total = inTransit.count;
+        setColor(COLOR_INFO);
+        cout << "\n  " << sectorCount << " sector processes, " << flights << " flights, " << ticks << " ticks:\n";
+        for (int s = 0; s < sectorCount; s++) {
+            long long* stats = federation.getSlot(s).stats;
+            hops += stats[STAT_MOVES] + stats[STAT_HANDOFFS_OUT];
+            handoffs += stats[STAT_HANDOFFS_OUT];
+            landed += stats[STAT_LANDED];
+            replies += stats[STAT_ROUTE_REPLIES];
+            replyMicros += stats[STAT_ROUTE_MICROS];
+            total += stats[STAT_AIRBORNE] + stats[STAT_HOLDING] + stats[STAT_QUEUED];
+            setColor(MENU);
+            cout << "  Sector " << s;
+            setColor(COLOR_INFO);
+            cout << "  moves " << stats[STAT_MOVES] << ", handoffs in " << stats[STAT_HANDOFFS_IN]
+                << " / out " << stats[STAT_HANDOFFS_OUT] << ", landed " << stats[STAT_LANDED]
+                << ", airborne " << stats[STAT_AIRBORNE] << ", holding " << stats[STAT_HOLDING] << "\n";
+        }
+        cout << "  " << ms << " ms, " << (long)(ms > 0 ? hops * 1000.0 / ms : 0) << " hops/s, "
+            << handoffs << " handoffs, " << landed << " landed, " << server.served << " routes served ("
+            << (replies ? (double)replyMicros / replies : 0) << " us round trip)\n";
+        bool intact = (total == flights && clean);
+        setColor(intact ? COLOR_SUCCESS : COLOR_DANGER);
+        cout << "  " << total << " of " << flights << " flights accounted for ("
+            << inTransit.count << " in transit)" << (clean ? "" : ", a sector process failed") << "\n";
+        setColor(COLOR_RESET);
+    }
+
+    void benchmarkFederation()
+    {
+        setColor(MENU);
+        cout << "\n  1. "; setColor(COLOR_RESET);
+        cout << "Transport Benchmark (Handoff Throughput / Round Trip)\n";
+        setColor(MENU);
+        cout << "  2. "; setColor(COLOR_RESET);
+        cout << "Federated Sector Run\n";
+
+        int choice = readInt("\n  Enter choice: ", 1, 2);
+        if (choice == 1) benchmarkFederationTransport();
+        else runSectorFederation();
+    }
+
+    // Readers and writers hammering one registry from 1 to 64 threads:
+    // the plain HashTable behind one mutex against the ConcurrentRegistry
+    void benchmarkRegistry()
+    {
+        const int RUN_MILLISECONDS = 200;
+
+        int size = readInt("  Registered aircraft (1000-200000): ", 1000, 200000);
+        int writePercent = readInt("  Writes per 100 operations (0-50): ", 0, 50);
+
+        string* keys = new string[size];
+        HashTable* table = new HashTable();
+        ConcurrentRegistry* registry = new ConcurrentRegistry();
+        Aircraft aircraft("", "AirbusA320", 60, "LHE", "KHI", 4);
+        for (int i = 0; i < size; i++) {
+            keys[i] = "CR-" + toString(i);
+            aircraft.flightID = keys[i];
+            table->insert(keys[i], aircraft);
+            registry->insert(aircraft);
+        }
+        mutex tableLock;
+
+        setColor(COLOR_INFO);
+        cout << "\n  " << size << " aircraft, " << writePercent << "% writes, " << RUN_MILLISECONDS
+            << " ms per run, " << thread::hardware_concurrency() << " hardware threads:\n";
+        setColor(COLOR_RESET);
+
+        for (int threads = 1; threads <= 64; threads *= 2) {
+            double rates[2];
+            for (int engine = 0; engine < 2; engine++) {
+                atomic<bool> running(true);
+                atomic<long long> operations(0);
+                thread* workers = new thread[threads];
+                for (int t = 0; t < threads; t++) {
+                    workers[t] = thread([&, t, engine]() {
+                        unsigned int state = 2463534242u + t * 7919u;
+                        Aircraft copy;
+                        auto bump = [](Aircraft& live) { live.x++; };
+                        long long done = 0;
+                        while (running.load(memory_order_relaxed)) {
+                            state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+                            const string& key = keys[state % (unsigned int)size];
+                            bool write = (int)((state >> 8) % 100) < writePercent;
+                            if (engine == 0) {
+                                lock_guard<mutex> guard(tableLock);
+                                copy = *table->search(key);
+                                if (write) {
+                                    copy.x++;
+                                    table->update(key, copy);
+                                }
+                            }
+                            else if (write) {
+                                registry->tryModify(key, bump);
+                            }
+                            else {
+                                registry->tryGet(key, copy);
+                            }
+                            done++;
+                        }
+                        operations.fetch_add(done);
+                    });
+                }
+                this_thread::sleep_for(chrono::milliseconds(RUN_MILLISECONDS));
+                running.store(false);
+                for (int t = 0; t < threads; t++) workers[t].join();
+                delete[] workers;
+                rates[engine] = operations.load() * 1000.0 / RUN_MILLISECONDS;
+            }
+
+            string label = toString(threads) + (threads == 1 ? " thread" : " threads");
+            label.resize(11, ' ');
+            setColor(MENU);
+            cout << "  " << label;
+            setColor(COLOR_INFO);
+            cout << "  locked table " << (long)rates[0] << " ops/s, registry " << (long)rates[1] << " ops/s ("
+                << (rates[0] > 0 ? rates[1] / rates[0] : 0) << "x)\n";
+        }
+        setColor(COLOR_INFO);
+        cout << "  " << registry->getLockedReads() << " registry lookups fell back to the stripe lock, "
+            << registry->getCount() << " aircraft registered\n";
+        setColor(COLOR_RESET);
+
+        delete registry;
+        delete table;
+        delete[] keys;
+    }
+
+    // Threads insert, update, modify, remove and read one registry at once
+    // while another keeps rewriting every record with modifyEach. Every
+    // record written keeps y == -x, timestamp == 3x and a model of 4 + x % 50
+    // characters, so a torn read shows up as a broken record; counter
+    // flights are only bumped through tryModify, so a lost update shows up
+    // in their total.
+    void checkRegistryConcurrency()
+    {
+        const int KEYS = 4096;
+        const int COUNTERS = 16;
+
+        int threads = readInt("  Threads (2-64): ", 2, 64);
+        int seconds = readInt("  Run for how many seconds (1-30): ", 1, 30);
+
+        ConcurrentRegistry* registry = new ConcurrentRegistry();
+        string* keys = new string[KEYS];
+        string* counters = new string[COUNTERS];
+        for (int i = 0; i < KEYS; i++) keys[i] = "RC-" + toString(i);
+        for (int i = 0; i < COUNTERS; i++) {
+            counters[i] = "RK-" + toString(i);
+            Aircraft counter(counters[i], "AirbusA320", 60, "LHE", "KHI", 4);
+            counter.timestamp = 0;
+            registry->insert(counter);
+        }
+
+        atomic<bool> running(true);
+        atomic<long long> reads(0), torn(0), bumps(0), sweeps(0);
+        thread* workers = new thread[threads];
+        for (int t = 0; t < threads; t++) {
+            workers[t] = thread([&, t]() {
+                unsigned int state = 88172645u + t * 7919u;
+                auto bump = [](Aircraft& counter) { counter.timestamp++; };
+                auto hold = [](Aircraft& aircraft) { aircraft.status = (aircraft.status == "Holding") ? "In Flight" : "Holding"; };
+                Aircraft aircraft("", "", 60, "LHE", "KHI", 4);
+                long long done = 0, broken = 0, bumped = 0, swept = 0;
+                while (running.load(memory_order_relaxed)) {
+                    state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+                    const string& key = keys[state % (unsigned int)KEYS];
+                    int op = (int)((state >> 12) % 100);
+                    if (t == 0 && op == 0) {
+                        registry->modifyEach(hold);
+                        swept++;
+                    }
+                    else if (op < 70) {
+                        if (registry->tryGet(key, aircraft) == ATC_OK) {
+                            done++;
+                            if (aircraft.flightID != key || aircraft.y != -aircraft.x || aircraft.timestamp != 3L * aircraft.x ||
+                                aircraft.model.size() != (size_t)(4 + aircraft.x % 50)) broken++;
+                        }
+                    }
+                    else if (op < 85) {
+                        aircraft.flightID = key;
+                        aircraft.x = (int)((state >> 3) % 5000);
+                        aircraft.y = -aircraft.x;
+                        aircraft.timestamp = 3L * aircraft.x;
+                        aircraft.model.assign((size_t)(4 + aircraft.x % 50), 'M');
+                        if (op < 78) registry->insert(aircraft);
+                        else registry->update(aircraft);
+                    }
+                    else if (op < 95) {
+                        if (registry->tryModify(counters[state % (unsigned int)COUNTERS], bump) == ATC_OK) bumped++;
+                    }
+                    else {
+                        registry->remove(key);
+                    }
+                }
+                reads.fetch_add(done);
+                torn.fetch_add(broken);
+                bumps.fetch_add(bumped);
+                sweeps.fetch_add(swept);
+            });
+        }
+        this_thread::sleep_for(chrono::seconds(seconds));
+        running.store(false);
+        for (int t = 0; t < threads; t++) workers[t].join();
+        delete[] workers;
+
+        long long counted = 0;
+        int visited = 0;
+        auto total = [&counted, &visited](const Aircraft& aircraft) {
+            visited++;
+            if (aircraft.flightID.compare(0, 3, "RK-") == 0) counted += aircraft.timestamp;
+        };
+        registry->forEach(total);
+
+        bool clean = (torn.load() == 0 && counted == bumps.load() && visited == registry->getCount());
+        setColor(clean ? COLOR_SUCCESS : COLOR_DANGER);
+        cout << "\n  " << threads << " threads for " << seconds << " s: " << reads.load() << " reads, " << torn.load()
+            << " torn, " << bumps.load() << " counter bumps (" << counted << " counted), " << sweeps.load()
+            << " modifyEach sweeps, " << visited << " of " << registry->getCount() << " aircraft visited"
+            << (clean ? "" : "  (FAILED)") << "\n";
+        setColor(COLOR_RESET);
+
+        delete registry;
+        delete[] counters;
+        delete[] keys;
+    }
+
+    void performanceDiagnostics()
+    {
+        setColor(COLOR_HEADER);
+        cout << "\n|||===========================================================|||\n";
+        cout << "|||                PERFORMANCE DIAGNOSTICS                    |||\n";
+        cout << "|||===========================================================|||\n";
+        setColor(COLOR_RESET);
+
+        setColor(MENU);
+        cout << "  1. "; setColor(COLOR_RESET);
+        cout << "Landing Queue Benchmark (MinHeap vs BucketQueue)\n";
+        setColor(MENU);
+        cout << "  2. "; setColor(COLOR_RESET);
+        cout << "Arrival Sequencing Benchmark\n";
+        setColor(MENU);
+        cout << "  3. "; setColor(COLOR_RESET);
+        cout << "Flight Log Benchmark (AVLTree vs FlightLogStore)\n";
+        setColor(MENU);
+        cout << "  4. "; setColor(COLOR_RESET);
+        cout << "Node Pool Statistics & Churn Benchmark\n";
+        setColor(MENU);
+        cout << "  5. "; setColor(COLOR_RESET);
+        cout << "Scale Stress Test (Add / Emergency / Move / Land / Save / Load)\n";
+        setColor(MENU);
+        cout << "  6. "; setColor(COLOR_RESET);
+        cout << "Sector Scaling Benchmark (Per-Sector Threads)\n";
+        setColor(MENU);
+        cout << "  7. "; setColor(COLOR_RESET);
+        cout << "Sector Federation (One Process per Sector, Shared Memory)\n";
+        setColor(MENU);
+        cout << "  8. "; setColor(COLOR_RESET);
+        cout << "Registry Contention Benchmark (1-64 Threads)\n";
+        setColor(MENU);
+        cout << "  9. "; setColor(COLOR_RESET);
+        cout << "Tick Allocation Check (Scratch Arena)\n";
+        setColor(MENU);
+        cout << "  10. "; setColor(COLOR_RESET);
+        cout << "Registry Concurrency Check (Torn Reads / Lost Updates)\n";
+        setColor(MENU);
+        cout << "  0. "; setColor(COLOR_RESET);
+        cout << "Back\n";
+
+        int choice = readInt("\n  Enter choice: ", 0, 10);
+        switch (choice) {
+        case 1:
+            benchmarkLandingQueues();
+            break;
+        case 2:
+            benchmarkArrivalManager();
+            break;
+        case 3:
+            benchmarkFlightLogs();
+            break;
+        case 4:
+            benchmarkNodePools();
+            break;
+        case 5:
+            stressTestScale();
+            break;
+        case 6:
+            benchmarkSectors();
+            break;
+        case 7:
+            benchmarkFederation();
+            break;
+        case 8:
+            benchmarkRegistry();
+            break;
+        case 9:
+            checkTickAllocations();
+            break;
+        case 10:
+            checkRegistryConcurrency();
+            break;
+        }
+    }
+
+public:
+    // radar view, two columns per cell, plus axis labels, view bounds,
+    // legend and status line
+    SkyNetATC() : viewport(VIEW_ROWS, VIEW_COLS), radarView(5 + VIEW_COLS * 2 + 24, VIEW_ROWS + 5), simClock(0),
+        commandQueue(COMMAND_QUEUE_CAPACITY), applyingCommands(false), feedRuns(0), snapshotVersion(0), logRows(NULL), logRowsCount(0),
+        logEpoch(0), logRowsEpoch(0), registryFile("aircraft_registry.txt"), logFile("flight_log.txt")
+    {
+        srand((unsigned)time(0));
+        enableAnsiOutput();
+        initializeRadar();
+        initializeAirspace();
+        publishSnapshot();
+    }
+
+    // A separate engine over a cols x rows grid airspace in which every
+    // node is an airport, saving to its own files named after prefix. The
+    // scale stress test drives the real engine paths on one.
+    SkyNetATC(int gridCols, int gridRows, const string& prefix) : viewport(VIEW_ROWS, VIEW_COLS),
+        radarView(5 + VIEW_COLS * 2 + 24, VIEW_ROWS + 5), flightLog(prefix + "_archive"), simClock(0),
+        commandQueue(COMMAND_QUEUE_CAPACITY), applyingCommands(false), feedRuns(0), snapshotVersion(0), logRows(NULL), logRowsCount(0),
+        logEpoch(0), logRowsEpoch(0), registryFile(prefix + "_registry.txt"), logFile(prefix + "_log.txt")
+    {
+        initializeRadar();
+        buildGridAirspace(airspace, gridCols, gridRows, 1);
+        publishSnapshot();
+    }
+
+    ~SkyNetATC()
+    {
+        for (int p = 0; p < aircraftPages.size(); p++)
+            if (aircraftPages[p] != NULL) aircraftPages[p]->release();
+        if (logRows != NULL) logRows->release();
+    }
+
+    // Validates a new flight, places it on its origin airport and queues it
+    // for landing; throws if it cannot be admitted
+    void admitFlight(Aircraft& newAircraft)
+    {
+        newAircraft.validate();
+        if (aircraftRegistry.contains(newAircraft.flightID))
+            throw InvalidInputException("Flight ID (" + newAircraft.flightID + " is already registered)");
+
+        // 1. Use the origin airport as the start node
+        string startNode = newAircraft.origin;
+        GraphNode* startGraphNode = airspace.getNodeByName(startNode);
+
+        // 2. Validate: Does this place exist?
+        if (startGraphNode == NULL)
+            throw InvalidInputException("Origin '" + startNode + "' not found in airspace");
+
+        // 3. Validate: Is it actually an Airport? (Prevent spawning at waypoints)
+        if (!startGraphNode->isAirport)
+            throw InvalidInputException("Location '" + startNode + "' is not a valid Airport");
+
+        // 4. Validate: Is it occupied?
+        if (airspace.isNodeOccupied(startNode))
+            throw CollisionException("Airport " + startNode + " is currently occupied at (" + toString(startGraphNode->x) + ", " + toString(startGraphNode->y) + ")");
+
+        newAircraft.x = startGraphNode->x;
+        newAircraft.y = startGraphNode->y;
+        newAircraft.currentNode = startNode;
+        newAircraft.queuedAt = currentTime();
+
+        aircraftRegistry.insert(newAircraft);
+        landingScheduler.insert(landingAirportFor(newAircraft), newAircraft);
+        airspace.occupyNode(startNode, newAircraft.flightID);
+        flightLog.reserve(newAircraft, landingScheduler.getSize());
+    }
+
+    void addFlight()
+    {
+        try {
+            setColor(COLOR_HEADER);
+            cout << "\n|||===========================================================|||\n";
+            cout << "|||                     ADD NEW FLIGHT                        |||\n";
+            cout << "|||===========================================================|||\n";
+            setColor(COLOR_RESET);
+
+            string flightID = readString("  Flight ID (e.g., PK-786): ");
+            string model = readString("  Aircraft Model (e.g., Boeing737): ");
+            int fuelLevel = readInt("  Fuel Level (0-100%): ", 0, 100);
+            string origin = readString("  Origin Airport: ");
+            string destination = readString("  Destination Airport: ");
+            int priority = readInt("  Priority (1=CRITICAL, 2=HIGH, 3=MEDIUM, 4=LOW): ", 1, 4);
+
+            Aircraft newAircraft(flightID, model, fuelLevel, origin, destination, priority);
+            admitFlight(newAircraft);
+
+            setColor(COLOR_SUCCESS);
+            cout << "\n  Flight " << flightID << " added successfully!\n";
+            cout << "  Starting at: " << newAircraft.currentNode << " (" << newAircraft.x << ", " << newAircraft.y << ")\n";
+            setColor(COLOR_RESET);
+        }
+        catch (AircraftException& e) {
+            setColor(COLOR_DANGER);
+            cout << "\n  Issue: " << e.what() << "\n";
+            setColor(COLOR_RESET);
+        }
+    }
+
+    // Emergency on the live registry copy; ATC_NOT_FOUND if the flight is
+    // registered but not queued for landing
+    AtcStatus raisePriority(Aircraft& aircraft, int newPriority)
+    {
+        aircraft.priority = newPriority;
+        aircraft.status = "EMERGENCY";
+        return landingScheduler.tryDecreaseKey(aircraft.flightID, newPriority);
+    }
+
+    void declareEmergency()
+    {
+        try {
+            setColor(COLOR_HEADER);
+            cout << "\n|||===========================================================|||\n";
+            cout << "|||                   DECLARE EMERGENCY                       |||\n";
+            cout << "|||===========================================================|||\n";
+            setColor(COLOR_RESET);
+
+            string flightID = readString("  Enter Flight ID: ");
+            Aircraft aircraft;
+            if (aircraftRegistry.tryGet(flightID, aircraft) != ATC_OK)
+                throw FlightNotFoundException(flightID);
+
             setColor(COLOR_WARNING);
-            cout << "\n  " << e.what() << "\n";
+            cout << "\n  Emergency Types:\n";
+            setColor(COLOR_RESET);
+            cout << "    1. Medical Emergency\n";
+            cout << "    2. Engine Failure\n";
+            cout << "    3. Hijack\n";
+            cout << "    4. Low Fuel\n";
+
+            int choice = readInt("  Choice: ", 1, 4);
+            int newPriority = 1;
+
+            // Low fuel uses the fuel level tracked by the simulation
+            if (choice == 4)
+                newPriority = (aircraft.fuelLevel < LOW_FUEL_PERCENT) ? 2 : 3;
+
+            AtcStatus queued = ATC_NOT_FOUND;
+            auto raise = [this, newPriority, &queued](Aircraft& live) { queued = raisePriority(live, newPriority); };
+            if (aircraftRegistry.tryModify(flightID, raise) != ATC_OK || queued != ATC_OK)
+                throw FlightNotFoundException(flightID);
+
+            setColor(COLOR_SUCCESS);
+            cout << "\n  Emergency declared! " << flightID << " moved to priority " << newPriority << "\n";
+            if (choice == 4 && aircraft.fuelLevel < LOW_FUEL_PERCENT)
+                cout << "  Fuel level " << aircraft.fuelLevel << "% (LOW FUEL - HIGH PRIORITY)\n";
+            setColor(COLOR_RESET);
+        }
+        catch (AircraftException& e) {
+            setColor(COLOR_DANGER);
+            cout << "\n  Issue: " << e.what() << "\n";
+            setColor(COLOR_RESET);
+        }
+    }
+
+    // Takes every flight that has been given a landing slot out of the
+    // airspace in one pass: frees nodes and radar cells, drops the flights
+    // from the registry, then appends them to the flight log together
+    void landBatch(LandingSlot* cleared, int count)
+    {
+        if (count <= 0) return;
+        ScratchScope scope;
+        Aircraft* landed = scratchArena().allocate<Aircraft>(count);
+
+        for (int i = 0; i < count; i++) {
+            Aircraft& aircraft = cleared[i].aircraft;
+
+            // the queued copy dates from admission; moves and fuel burn
+            // went to the registry copy
+            aircraftRegistry.tryGet(aircraft.flightID, aircraft);
+            airspace.freeNode(aircraft.currentNode);
+
+            aircraft.status = "Landed";
+            aircraft.timestamp = cleared[i].slotTime;
+            landed[i] = aircraft;
+        }
+
+        for (int i = 0; i < count; i++) {
+            aircraftRegistry.remove(landed[i].flightID);
+            analytics.record(landed[i], cleared[i].airport);
+        }
+        flightLog.insertBatch(landed, count);
+    }
+
+    void printLanding(const LandingSlot& slot)
+    {
+        setColor(COLOR_SUCCESS);
+        cout << "  " << formatTime(slot.slotTime) << "  ";
+        setColor(MENU);
+        cout << slot.aircraft.flightID;
+        setColor(COLOR_INFO);
+        cout << " landed at " << slot.airport << " runway " << slot.runway + 1 << "\n";
+        setColor(COLOR_RESET);
+    }
+
+    void landFlight()
+    {
+        LandingSlot slot;
+        if (landingScheduler.tryExtractNext(currentTime(), slot) != ATC_OK) {
+            setColor(COLOR_WARNING);
+            cout << "\n  No aircraft in landing queue\n";
+            setColor(COLOR_RESET);
+            return;
+        }
+
+        landBatch(&slot, 1);
+        Aircraft& landed = slot.aircraft;
+
+        setColor(COLOR_SUCCESS);
+        cout << "\n  Flight " << landed.flightID << " has landed safely!\n";
+        setColor(COLOR_INFO);
+        cout << "    Priority was: " << getPriorityString(landed.priority) << "\n";
+        cout << "    Landed at: " << slot.airport << " (runway " << slot.runway + 1
+            << ", from " << landed.currentNode << ")\n";
+        cout << "    Time: " << formatTime(landed.timestamp) << "\n";
+
+        setColor(COLOR_RESET);
+    }
+
+    // One tick of simulated time: every airborne aircraft burns fuel, then
+    // every flight whose runway slot falls inside the tick lands. cleared
+    // (in the scratch arena) receives the landings; returns their count.
+    int stepSimulation(LandingSlot*& cleared, bool reportEscalations)
+    {
+        // Commands queued since the last tick apply before it, even while
+        // the menu is blocked waiting for input
+        while (drainCommands() == COMMAND_BATCH) {}
+
+        long windowStart = currentTime();
+        simClock += TICK_SECONDS;
+
+        int escalated = 0;
+        auto burn = [this, &escalated, reportEscalations](Aircraft& aircraft) {
+            if (burnFuel(aircraft, TICK_SECONDS / FUEL_SECONDS_PER_PERCENT)) {
+                if (reportEscalations) reportEscalation(aircraft);
+                escalated++;
+            }
+        };
+        aircraftRegistry.modifyEach(burn);
+        if (escalated > 0 && reportEscalations) cout << "\n";
+
+        int pending = landingScheduler.getSize();
+        cleared = scratchArena().allocate<LandingSlot>(pending);
+        auto estimate = [this, windowStart](const Aircraft& queued, const string& airport, ArrivalCandidate& out) {
+            estimateArrival(queued, airport, windowStart, out);
+        };
+        int count = landingScheduler.processDueOptimized(windowStart, simClock, cleared, pending, estimate);
+        landBatch(cleared, count);
+        return count;
+    }
+
+    // Advances the simulation clock by one tick and lands every flight whose
+    // runway slot falls inside it, across all airports and runways
+    void advanceTick()
+    {
+        setColor(COLOR_HEADER);
+        cout << "\n|||===========================================================|||\n";
+        cout << "|||              SIMULATION TICK (Batch Landings)             |||\n";
+        cout << "|||===========================================================|||\n";
+        setColor(COLOR_RESET);
+
+        ScratchScope scope;
+        LandingSlot* cleared = NULL;
+        int count = stepSimulation(cleared, true);
+        for (int i = 0; i < count; i++) printLanding(cleared[i]);
+
+        setColor(COLOR_INFO);
+        cout << "\n  Clock: " << formatTime(simClock) << "  Landings this tick: ";
+        setColor(MENU);
+        cout << count << "\n";
+        setColor(COLOR_RESET);
+    }
+
+    void landNextFlights()
+    {
+        setColor(COLOR_HEADER);
+        cout << "\n|||===========================================================|||\n";
+        cout << "|||                 BATCH LANDING (Next K Flights)            |||\n";
+        cout << "|||===========================================================|||\n";
+        setColor(COLOR_RESET);
+
+        int pending = landingScheduler.getSize();
+        if (pending == 0) {
+            setColor(COLOR_WARNING);
+            cout << "  No aircraft in landing queue.\n";
+            setColor(COLOR_RESET);
+            return;
+        }
+
+        int k = readInt("  How many flights to land (1-" + toString(pending) + "): ", 1, pending);
+        ScratchScope scope;
+        LandingSlot* cleared = scratchArena().allocate<LandingSlot>(k);
+        int count = landingScheduler.extractTopK(cleared, k, currentTime());
+
+        landBatch(cleared, count);
+        for (int i = 0; i < count; i++) printLanding(cleared[i]);
+
+        setColor(COLOR_INFO);
+        cout << "\n  Landed " << count << " flight(s).\n";
+        setColor(COLOR_RESET);
+    }
+
+    void configureRunways()
+    {
+        try {
+            setColor(COLOR_HEADER);
+            cout << "\n|||===========================================================|||\n";
+            cout << "|||                 CONFIGURE AIRPORT RUNWAYS                 |||\n";
+            cout << "|||===========================================================|||\n";
+            setColor(COLOR_RESET);
+
+            for (int i = 0; i < landingScheduler.getAirportCount(); i++) {
+                AirportLanding* ap = landingScheduler.getAirportAt(i);
+                setColor(MENU);
+                cout << "  " << ap->airport;
+                setColor(COLOR_INFO);
+                cout << "  runways: " << ap->runways << "  separation: " << ap->separation
+                    << "s  queued: " << ap->queue.getSize() << "\n";
+            }
+            setColor(COLOR_RESET);
+
+            string airport = readString("\n  Airport: ");
+            if (!landingScheduler.hasAirport(airport))
+                throw InvalidInputException("Airport '" + airport + "'");
+
+            int runways = readInt("  Runways (1-8): ", 1, 8);
+            int separation = readInt("  Minimum separation in seconds (30-600): ", 30, 600);
+            landingScheduler.configureAirport(airport, runways, separation);
+
+            setColor(COLOR_SUCCESS);
+            cout << "\n  " << airport << " now has " << runways << " runway(s), "
+                << separation << "s separation.\n";
+            setColor(COLOR_RESET);
+        }
+        catch (AircraftException& e) {
+            setColor(COLOR_DANGER);
+            cout << "\n  Issue: " << e.what() << "\n";
             setColor(COLOR_RESET);
         }
     }
@@ -433,55 +2193,213 @@ public:
             cout << "|||===========================================================|||\n";
             setColor(COLOR_RESET);
 
-            string flightID = readString("  Enter Flight ID: ");
-            Aircraft* aircraft = aircraftRegistry.search(flightID);
+            string flightID = readString("  Enter Flight ID: ");
+            SnapshotReader<AirspaceSnapshot> view(snapshots);
+            const Aircraft* aircraft = view->find(flightID);
+
+            if (aircraft == NULL)
+                throw FlightNotFoundException(flightID);
+
+            setColor(COLOR_HEADER);
+            cout << "\n|||===========================================================|||\n";
+            cout << "|||                 FLIGHT INFORMATION                        |||\n";
+            cout << "|||===========================================================|||\n";
+            setColor(COLOR_RESET);
+
+            setColor(COLOR_INFO);
+            cout << "  Flight ID:    " << aircraft->flightID << endl;
+            cout << "  Model:        " << aircraft->model << endl;
+            cout << "  Fuel Level:   ";
+            if (aircraft->fuelLevel < 10) setColor(COLOR_DANGER);
+            else if (aircraft->fuelLevel < 30) setColor(COLOR_WARNING);
+            else setColor(COLOR_SUCCESS);
+            cout << aircraft->fuelLevel << "%\n";
+            setColor(COLOR_INFO);
+            cout << "  Origin:       " << aircraft->origin << endl;
+            cout << "  Destination:  " << aircraft->destination << endl;
+            cout << "  Priority:     ";
+            if (aircraft->priority == 1) setColor(COLOR_DANGER);
+            else if (aircraft->priority == 2) setColor(COLOR_WARNING);
+            else setColor(COLOR_INFO);
+            cout << getPriorityString(aircraft->priority) << endl;
+            setColor(COLOR_INFO);
+            cout << "  Status:       ";
+            if (aircraft->status == "EMERGENCY") setColor(COLOR_DANGER);
+            else if (aircraft->status == "Landed") setColor(COLOR_SUCCESS);
+            else setColor(MENU);
+            cout << aircraft->status << endl;
+            setColor(COLOR_INFO);
+            cout << "  Position:     (" << aircraft->x << ", " << aircraft->y << ")\n";
+            cout << "  Current Node: " << aircraft->currentNode << endl;
+            setColor(COLOR_RESET);
+        }
+        catch (FlightNotFoundException& e) {
+            setColor(COLOR_DANGER);
+            cout << "\n  " << e.what() << "\n";
+            setColor(COLOR_RESET);
+        }
+    }
+
+    void printFlightLog()
+    {
+        flightLog.printLog();
+
+        if (flightLog.getArchivedCount() > 0) {
+            setColor(COLOR_SUBTITLE);
+            cout << "  In memory: ";
+            setColor(COLOR_INFO);
+            cout << flightLog.getHotCount();
+            setColor(COLOR_SUBTITLE);
+            cout << "   Archived on disk: ";
+            setColor(COLOR_INFO);
+            cout << flightLog.getArchivedCount() << " in " << flightLog.getArchiveSegmentCount() << " segment(s)\n";
+            setColor(COLOR_RESET);
+        }
+    }
+
+    long startOfDay(long timestamp)
+    {
+        time_t rawtime = (time_t)timestamp;
+        struct tm timeinfo;
+        localtime_s(&timeinfo, &rawtime);
+        timeinfo.tm_hour = 0;
+        timeinfo.tm_min = 0;
+        timeinfo.tm_sec = 0;
+        return (long)mktime(&timeinfo);
+    }
+
+    // Reads a HH:MM time of day and returns it as a timestamp on dayStart's day
+    long readClockTime(const string& prompt, long dayStart)
+    {
+        while (true) {
+            string value = readString(prompt);
+            size_t colon = value.find(':');
+            if (colon != string::npos && colon > 0 && colon < value.length() - 1) {
+                int hours = atoi(value.substr(0, colon).c_str());
+                int minutes = atoi(value.substr(colon + 1).c_str());
+                if (hours >= 0 && hours <= 24 && minutes >= 0 && minutes < 60 && hours * 60 + minutes <= 1440)
+                    return dayStart + hours * 3600L + minutes * 60L;
+            }
+            setColor(COLOR_WARNING);
+            cout << "  Please enter a time as HH:MM (00:00-24:00).\n";
+            setColor(COLOR_RESET);
+        }
+    }
+
+    // Shift reports answered from the flight log's range and rank queries
+    // without walking the whole log
+    void flightLogReports()
+    {
+        setColor(COLOR_HEADER);
+        cout << "\n|||===========================================================|||\n";
+        cout << "|||                  FLIGHT LOG REPORTS                       |||\n";
+        cout << "|||===========================================================|||\n";
+        setColor(COLOR_RESET);
+
+        setColor(MENU);
+        cout << "  1. "; setColor(COLOR_RESET);
+        cout << "Landings Between Two Times (Today)\n";
+        setColor(MENU);
+        cout << "  2. "; setColor(COLOR_RESET);
+        cout << "N-th Landing of Today\n";
+        setColor(MENU);
+        cout << "  3. "; setColor(COLOR_RESET);
+        cout << "Hourly Landing Counts (Today)\n";
+        setColor(MENU);
+        cout << "  4. "; setColor(COLOR_RESET);
+        cout << "Landing History of a Flight\n";
+        setColor(MENU);
+        cout << "  5. "; setColor(COLOR_RESET);
+        cout << "Landings at an Airport\n";
+        setColor(MENU);
+        cout << "  6. "; setColor(COLOR_RESET);
+        cout << "Landings by Aircraft Model\n";
+        setColor(MENU);
+        cout << "  7. "; setColor(COLOR_RESET);
+        cout << "Landing Analytics (Rates, Priority Mix, Wait Times)\n";
+        setColor(MENU);
+        cout << "  0. "; setColor(COLOR_RESET);
+        cout << "Back\n";
+
+        int choice = readInt("\n  Enter choice: ", 0, 8);
+        long dayStart = startOfDay(currentTime());
+        long dayEnd = dayStart + 24 * 3600L;
 
-            if (aircraft == NULL)
-                throw FlightNotFoundException(flightID);
+        if (choice == 1) {
+            long from = readClockTime("  From (HH:MM): ", dayStart);
+            long to = readClockTime("  To (HH:MM): ", dayStart);
 
-            setColor(COLOR_HEADER);
-            cout << "\n|||===========================================================|||\n";
-            cout << "|||                 FLIGHT INFORMATION                        |||\n";
-            cout << "|||===========================================================|||\n";
-            setColor(COLOR_RESET);
+            cout << "\n";
+            auto print = [](const Aircraft& record) { printLogEntry(record); };
+            flightLog.forEachInRange(from, to, print);
 
+            setColor(COLOR_SUBTITLE);
+            cout << "\n  Landings in window: ";
             setColor(COLOR_INFO);
-            cout << "  Flight ID:    " << aircraft->flightID << endl;
-            cout << "  Model:        " << aircraft->model << endl;
-            cout << "  Fuel Level:   ";
-            if (aircraft->fuelLevel < 10) setColor(COLOR_DANGER);
-            else if (aircraft->fuelLevel < 30) setColor(COLOR_WARNING);
-            else setColor(COLOR_SUCCESS);
-            cout << aircraft->fuelLevel << "%\n";
-            setColor(COLOR_INFO);
-            cout << "  Origin:       " << aircraft->origin << endl;
-            cout << "  Destination:  " << aircraft->destination << endl;
-            cout << "  Priority:     ";
-            if (aircraft->priority == 1) setColor(COLOR_DANGER);
-            else if (aircraft->priority == 2) setColor(COLOR_WARNING);
-            else setColor(COLOR_INFO);
-            cout << getPriorityString(aircraft->priority) << endl;
-            setColor(COLOR_INFO);
-            cout << "  Status:       ";
-            if (aircraft->status == "EMERGENCY") setColor(COLOR_DANGER);
-            else if (aircraft->status == "Landed") setColor(COLOR_SUCCESS);
-            else setColor(MENU);
-            cout << aircraft->status << endl;
-            setColor(COLOR_INFO);
-            cout << "  Position:     (" << aircraft->x << ", " << aircraft->y << ")\n";
-            cout << "  Current Node: " << aircraft->currentNode << endl;
+            cout << flightLog.countInRange(from, to) << endl;
             setColor(COLOR_RESET);
         }
-        catch (FlightNotFoundException& e) {
-            setColor(COLOR_DANGER);
-            cout << "\n  " << e.what() << "\n";
+        else if (choice == 2) {
+            int landedToday = flightLog.countInRange(dayStart, dayEnd);
+            if (landedToday == 0) {
+                setColor(COLOR_WARNING);
+                cout << "\n  No landings recorded today.\n";
+                setColor(COLOR_RESET);
+                return;
+            }
+
+            int n = readInt("  Which landing (1-" + toString(landedToday) + "): ", 1, landedToday);
+            Aircraft record;
+            if (flightLog.select(flightLog.rank(dayStart) + n - 1, record)) {
+                cout << "\n";
+                printLogEntry(record);
+            }
+        }
+        else if (choice == 3) {
+            cout << "\n";
+            for (int hour = 0; hour < 24; hour++) {
+                long from = dayStart + hour * 3600L;
+                int count = flightLog.countInRange(from, from + 3600);
+                if (count == 0) continue;
+                setColor(COLOR_INFO);
+                cout << "  " << (hour < 10 ? "0" : "") << hour << ":00  ";
+                setColor(MENU);
+                cout << count << "\n";
+            }
+            setColor(COLOR_SUBTITLE);
+            cout << "\n  Total today: ";
+            setColor(COLOR_INFO);
+            cout << flightLog.countInRange(dayStart, dayEnd) << endl;
             setColor(COLOR_RESET);
         }
-    }
+        else if (choice == 7) {
+            displayAnalytics();
+        }
+        else if (choice >= 4) {
+            string key;
+            if (choice == 4) key = readString("  Flight ID: ");
+            else if (choice == 5) key = readString("  Airport: ");
+            else key = readString("  Aircraft Model: ");
 
-    void printFlightLog()
-    {
-        flightLog.printLog();
+            cout << "\n";
+            auto print = [](const Aircraft& record) { printLogEntry(record); };
+            int found;
+            if (choice == 4) found = flightLog.forEachByFlight(key, print);
+            else if (choice == 5) found = flightLog.forEachByAirport(key, print);
+            else found = flightLog.forEachByModel(key, print);
+
+            if (found == 0) {
+                setColor(COLOR_WARNING);
+                cout << "  No landings recorded for " << key << ".\n";
+                setColor(COLOR_RESET);
+                return;
+            }
+            setColor(COLOR_SUBTITLE);
+            cout << "\n  Landings found: ";
+            setColor(COLOR_INFO);
+            cout << found << endl;
+            setColor(COLOR_RESET);
+        }
     }
 
     void findSafeRoute()
@@ -530,12 +2448,11 @@ public:
             setColor(COLOR_RESET);
 
             string flightID = readString("  Enter Flight ID: ");
-            Aircraft* aircraft = aircraftRegistry.search(flightID);
-
-            if (aircraft == NULL)
+            Aircraft aircraft;
+            if (aircraftRegistry.tryGet(flightID, aircraft) != ATC_OK)
                 throw FlightNotFoundException(flightID);
 
-            string nearestAirport = airspace.findNearestAirport(aircraft->currentNode);
+            string nearestAirport = airspace.findNearestAirport(aircraft.currentNode);
 
             if (nearestAirport.empty()) {
                 setColor(COLOR_DANGER);
@@ -547,14 +2464,20 @@ public:
             setColor(COLOR_CRITICAL);
             cout << "\n  EMERGENCY ROUTE FOR: " << flightID << "\n";
             setColor(COLOR_INFO);
-            cout << "  Current Position: " << aircraft->currentNode << "\n";
+            cout << "  Current Position: " << aircraft.currentNode << "\n";
             cout << "  Nearest Airport: " << nearestAirport << "\n\n";
             setColor(COLOR_RESET);
 
             // Get Dijkstra path
-            string pathArray[50];
+            string* pathArray = scratchArena().allocate<string>(airspace.getNodeCount());
             int pathCount = 0;
-            airspace.getDijkstraPath(aircraft->currentNode, nearestAirport, pathArray, pathCount);
+            int distance = 0;
+            if (airspace.tryGetDijkstraPath(aircraft.currentNode, nearestAirport, pathArray, pathCount, distance) != ATC_OK) {
+                setColor(COLOR_DANGER);
+                cout << "\n  Issue: No path from " << aircraft.currentNode << " to " << nearestAirport << "\n";
+                setColor(COLOR_RESET);
+                return;
+            }
 
             // Display path
             setColor(COLOR_INFO);
@@ -597,22 +2520,22 @@ public:
                     }
 
                     // Move
-                    radar[aircraft->x][aircraft->y] = '.';
                     airspace.freeNode(currentNodeName);
 
-                    aircraft->x = nextNode->x;
-                    aircraft->y = nextNode->y;
-                    aircraft->currentNode = nextNodeName;
+                    aircraft.x = nextNode->x;
+                    aircraft.y = nextNode->y;
+                    aircraft.currentNode = nextNodeName;
 
                     airspace.occupyNode(nextNodeName, flightID);
-                    radar[aircraft->x][aircraft->y] = 'P';
 
                     setColor(COLOR_CRITICAL);
                     cout << "    Down: " << currentNodeName << " -> " << nextNodeName << "\n";
                     setColor(COLOR_RESET);
-                }
 
-                aircraftRegistry.update(flightID, *aircraft);
+                    bool escalated = burnFuel(aircraft, legFuel(currentNodeName, nextNodeName));
+                    aircraftRegistry.update(aircraft);
+                    if (escalated) reportEscalation(aircraft);
+                }
 
                 setColor(COLOR_SUCCESS);
                 cout << "\n  Emergency landing complete at " << nearestAirport << "!\n";
@@ -632,6 +2555,24 @@ public:
         }
     }
 
+    // Moves a flight one leg to node, freeing the node it leaves, and burns
+    // the fuel for the leg; escalated is set if that made it LOW FUEL.
+    // ATC_OCCUPIED if another flight holds node.
+    AtcStatus tryMoveFlight(Aircraft& aircraft, const string& node, bool& escalated)
+    {
+        escalated = false;
+        AtcStatus status = airspace.tryOccupyNode(node, aircraft.flightID);
+        if (status != ATC_OK) return status;
+        string from = aircraft.currentNode;
+        airspace.freeNode(from);
+        GraphNode* target = airspace.getNodeByName(node);
+        aircraft.x = target->x;
+        aircraft.y = target->y;
+        aircraft.currentNode = node;
+        escalated = burnFuel(aircraft, legFuel(from, node));
+        return ATC_OK;
+    }
+
     void moveFlight()
     {
         try {
@@ -642,13 +2583,12 @@ public:
             setColor(COLOR_RESET);
 
             string flightID = readString("  Enter Flight ID: ");
-            Aircraft* aircraft = aircraftRegistry.search(flightID);
-
-            if (aircraft == NULL)
+            Aircraft aircraft;
+            if (aircraftRegistry.tryGet(flightID, aircraft) != ATC_OK)
                 throw FlightNotFoundException(flightID);
 
             setColor(COLOR_INFO);
-            cout << "  Current Node: " << aircraft->currentNode << "\n";
+            cout << "  Current Node: " << aircraft.currentNode << "\n";
 
             string destination = readString("  Enter Destination Node: ");
             GraphNode* destNode = airspace.getNodeByName(destination);
@@ -657,9 +2597,15 @@ public:
                 throw InvalidInputException("Destination node not found");
 
             // Get full Dijkstra path
-            string pathArray[50];
+            string* pathArray = scratchArena().allocate<string>(airspace.getNodeCount());
             int pathCount = 0;
-            airspace.getDijkstraPath(aircraft->currentNode, destination, pathArray, pathCount);
+            int distance = 0;
+            if (airspace.tryGetDijkstraPath(aircraft.currentNode, destination, pathArray, pathCount, distance) != ATC_OK) {
+                setColor(COLOR_DANGER);
+                cout << "\n  Issue: No path from " << aircraft.currentNode << " to " << destination << "\n";
+                setColor(COLOR_RESET);
+                return;
+            }
 
             // Display path
             setColor(COLOR_INFO);
@@ -686,32 +2632,23 @@ public:
 
                 GraphNode* nextNode = airspace.getNodeByName(nextNodeName);
 
-                // Check collision at next node
-                if (airspace.isNodeOccupied(nextNodeName)) {
+                // Move to next node unless another flight holds it
+                bool escalated = false;
+                if (tryMoveFlight(aircraft, nextNodeName, escalated) != ATC_OK) {
                     setColor(COLOR_DANGER);
                     cout << "    Node " << nextNodeName << " occupied! Path blocked.\n";
                     setColor(COLOR_RESET);
                     throw CollisionException("(" + toString(nextNode->x) + ", " + toString(nextNode->y) + ")");
                 }
-
-                // Move to next node
-                radar[aircraft->x][aircraft->y] = '.';
-                airspace.freeNode(currentNodeName);
-
-                aircraft->x = nextNode->x;
-                aircraft->y = nextNode->y;
-                aircraft->currentNode = nextNodeName;
-
-                airspace.occupyNode(nextNodeName, flightID);
-                radar[aircraft->x][aircraft->y] = 'P';
+                aircraftRegistry.update(aircraft);
 
                 setColor(COLOR_SUCCESS);
                 cout << "    Step " << (step + 1) << ": " << currentNodeName << " -> " << nextNodeName
-                    << " (" << aircraft->x << ", " << aircraft->y << ")\n";
+                    << " (" << aircraft.x << ", " << aircraft.y << ")\n";
                 setColor(COLOR_RESET);
-            }
 
-            aircraftRegistry.update(flightID, *aircraft);
+                if (escalated) reportEscalation(aircraft);
+            }
 
             setColor(COLOR_SUCCESS);
             cout << "\n  Flight " << flightID << " reached " << destination << " successfully!\n";
@@ -724,87 +2661,784 @@ public:
         }
     }
 
-    void checkCollisions()
+    // Control-loop side of a queued command. Failures are counted, never
+    // thrown: the producer that queued the command is long gone.
+    void applyCommand(ControlCommand& command)
     {
-        setColor(COLOR_HEADER);
-        cout << "\n|||===========================================================|||\n";
-        cout << "|||                COLLISION DETECTION                        |||\n";
-        cout << "|||===========================================================|||\n";
+        switch (command.type) {
+        case CMD_ADD_FLIGHT:
+            try {
+                admitFlight(command.aircraft);
+            }
+            catch (AircraftException&) {
+                commandStats.failed++;
+            }
+            break;
+        case CMD_POSITION_REPORT: {
+            // Reports are observations: the flight is wherever the feed saw it
+            auto report = [this, &command](Aircraft& aircraft) {
+                bool escalated = false;
+                if (aircraft.currentNode != command.node &&
+                    tryMoveFlight(aircraft, command.node, escalated) != ATC_OK) commandStats.conflicts++;
+            };
+            if (airspace.getNodeByName(command.node) == NULL ||
+                aircraftRegistry.tryModify(command.aircraft.flightID, report) != ATC_OK) commandStats.failed++;
+            break;
+        }
+        case CMD_EMERGENCY: {
+            AtcStatus queued = ATC_NOT_FOUND;
+            auto raise = [this, &command, &queued](Aircraft& aircraft) { queued = raisePriority(aircraft, command.value); };
+            if (aircraftRegistry.tryModify(command.aircraft.flightID, raise) != ATC_OK || queued != ATC_OK)
+                commandStats.failed++;
+            break;
+        }
+        case CMD_TICK: {
+            ScratchScope scope;
+            LandingSlot* cleared = NULL;
+            commandStats.landed += stepSimulation(cleared, false);
+            break;
+        }
+        case CMD_NONE:
+            break;
+        }
+
+        long long latency = steadyMicros() - command.issuedMicros;
+        commandStats.applied++;
+        commandStats.latencyMicros += latency;
+        if (latency > commandStats.maxLatencyMicros) commandStats.maxLatencyMicros = latency;
+    }
+
+    // Applies up to one batch of queued commands; returns how many. A
+    // CMD_TICK steps the simulation, which drains too, so a nested call
+    // applies nothing.
+    int drainCommands()
+    {
+        if (applyingCommands) return 0;
+        applyingCommands = true;
+        auto apply = [this](ControlCommand& command) { applyCommand(command); };
+        int applied = commandQueue.drain(apply, COMMAND_BATCH);
+        applyingCommands = false;
+        return applied;
+    }
+
+    // Producers on their own threads (a position feed replay, a script that
+    // adds flights and declares emergencies, a tick timer) queue commands
+    // while this thread drains them in batches and redraws the radar. The
+    // producers work from a copy of the network; the replay reads live
+    // positions from the registry, which only this thread writes.
+    void commandFeed()
+    {
+        const int FRAME_MILLISECONDS = 50;
+        const int TICK_MILLISECONDS = 500;
+        const int SCRIPT_MILLISECONDS = 200;
+
+        int seconds = readInt("  Run for how many seconds (1-60): ", 1, 60);
+        int reportRate = readInt("  Position reports per second (10-1000000): ", 10, 1000000);
+        int checkpointSeconds = readInt("  Checkpoint every how many seconds (0 = never, 1-60): ", 0, 60);
+
+        int nodeCount = airspace.getNodeCount();
+        string* names = new string[nodeCount];
+        FeedNameIndex nodeIds;
+        DynamicArray<int>* neighbours = new DynamicArray<int>[nodeCount];
+        DynamicArray<int> airports;
+        for (int i = 0; i < nodeCount; i++) {
+            GraphNode* node = airspace.getNodeAt(i);
+            names[i] = node->name;
+            nodeIds.add(node->name);
+            if (node->isAirport) airports.push(i);
+            for (Edge* edge = airspace.getEdges(i); edge != NULL; edge = edge->next)
+                neighbours[i].push(airspace.getNodeIndex(edge->destination));
+        }
+
+        // Flights the feed follows: the registered ones, then each scripted
+        // flight from its origin airport once the script has queued it
+        DynamicArray<string> tracked;
+        DynamicArray<int> trackedAt;
+        auto track = [this, &tracked, &trackedAt](const Aircraft& aircraft) {
+            int at = airspace.getNodeIndex(aircraft.currentNode);
+            if (at < 0) return;
+            tracked.push(aircraft.flightID);
+            trackedAt.push(at);
+        };
+        aircraftRegistry.forEach(track);
+        int registered = tracked.size();
+        int airportCount = airports.size();
+        const int SCRIPTED_MAX = 100000;
+        tracked.reserve(registered + SCRIPTED_MAX);
+        trackedAt.reserve(registered + SCRIPTED_MAX);
+        string prefix = "F" + toString(++feedRuns) + "-";
+        for (int k = 0; k < SCRIPTED_MAX; k++) {
+            tracked.push(prefix + toString(k));
+            trackedAt.push(airports[k % airportCount]);
+        }
+
+        atomic<bool> running(true);
+        atomic<int> scripted(0);
+        atomic<long long> reportsQueued(0), scriptQueued(0), ticksQueued(0);
+        commandQueue.clearStats();
+        commandStats.clear();
+
+        // Stale reports are worthless, so a full queue drops them. A report
+        // moves a flight on from its live position, as the control loop left
+        // it; flights not admitted yet follow the replay's own track.
+        thread replay([&]() {
+            unsigned int state = 88172645u;
+            long long sent = 0;
+            chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+            Aircraft seen;
+            ControlCommand command;
+            command.type = CMD_POSITION_REPORT;
+            while (running.load(memory_order_relaxed)) {
+                long long due = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - begin).count()
+                    * reportRate / 1000000;
+                int known = registered + scripted.load(memory_order_acquire);
+                for (; sent < due && known > 0; sent++) {
+                    state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+                    int flight = (int)(state % (unsigned int)known);
+                    if (aircraftRegistry.tryGet(tracked[flight], seen) == ATC_OK) {
+                        int at = nodeIds.find(seen.currentNode.data(), (int)seen.currentNode.size());
+                        if (at >= 0) trackedAt[flight] = at;
+                    }
+                    DynamicArray<int>& next = neighbours[trackedAt[flight]];
+                    if (next.empty()) continue;
+                    trackedAt[flight] = next[(int)((state >> 12) % (unsigned int)next.size())];
+                    command.aircraft.flightID = tracked[flight];
+                    command.node = names[trackedAt[flight]];
+                    command.issuedMicros = steadyMicros();
+                    if (commandQueue.tryPush(command)) reportsQueued.fetch_add(1, memory_order_relaxed);
+                }
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+        });
+
+        // Scripted and timer commands must not be lost: they retry when full
+        auto pushRetrying = [&](ControlCommand& command) {
+            command.issuedMicros = steadyMicros();
+            while (!commandQueue.tryPush(command) && running.load(memory_order_relaxed)) this_thread::yield();
+        };
+
+        thread script([&]() {
+            ControlCommand command;
+            for (int step = 0; running.load(memory_order_relaxed); step++) {
+                int k = scripted.load(memory_order_relaxed);
+                if (step % 5 == 4 && registered + k > 0) {
+                    command.type = CMD_EMERGENCY;
+                    command.aircraft.flightID = tracked[(step * 7) % (registered + k)];
+                    command.value = 1 + step % 3;
+                }
+                else if (k < SCRIPTED_MAX) {
+                    command.type = CMD_ADD_FLIGHT;
+                    command.aircraft = Aircraft(tracked[registered + k], "AirbusA320", 30 + k % 70,
+                        names[airports[k % airportCount]], names[airports[(k + 1 + k / airportCount) % airportCount]], 4);
+                    scripted.store(k + 1, memory_order_release);
+                }
+                pushRetrying(command);
+                scriptQueued.fetch_add(1, memory_order_relaxed);
+                this_thread::sleep_for(chrono::milliseconds(SCRIPT_MILLISECONDS));
+            }
+        });
+
+        thread timer([&]() {
+            ControlCommand command;
+            command.type = CMD_TICK;
+            while (running.load(memory_order_relaxed)) {
+                this_thread::sleep_for(chrono::milliseconds(TICK_MILLISECONDS));
+                pushRetrying(command);
+                ticksQueued.fetch_add(1, memory_order_relaxed);
+            }
+        });
+
+        cout << "\x1b[2J\x1b[?25l";
+        cout.flush();
+        radarView.invalidate();
+
+        // The radar is drawn on its own thread from published snapshots; this
+        // thread only applies commands and publishes a new version for each
+        // frame in which it applied any
+        int frames = seconds * 1000 / FRAME_MILLISECONDS;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        publishSnapshot();
+        thread render([&]() {
+            string status;
+            for (int f = 0; f < frames; f++) {
+                ScratchScope scope;
+                {
+                    SnapshotReader<AirspaceSnapshot> view(snapshots);
+                    composeRadar(*view);
+                    status = "  FEED  ";
+                    status += formatTime(view->clock);
+                    status += "  version ";
+                    appendNumber(status, view->version);
+                    status += ", applied ";
+                    appendNumber(status, view->commandsApplied);
+                }
+                status += ", dropped ";
+                appendNumber(status, commandQueue.getRejected());
+                if (checkpointer.isRunning()) {
+                    status += ", saving v";
+                    appendNumber(status, checkpointer.getVersion());
+                    status += ' ';
+                    appendNumber(status, checkpointer.getPercent());
+                    status += '%';
+                }
+                status += "      ";
+                radarView.putText(VIEW_ROWS + 4, 0, status, COLOR_INFO);
+                radarView.present();
+                this_thread::sleep_until(start + chrono::milliseconds(FRAME_MILLISECONDS) * (f + 1));
+            }
+        });
+
+        // Checkpoints are written by the background writer from the snapshot
+        // just published; the frames keep their pace while it runs
+        int checkpointFrames = checkpointSeconds * 1000 / FRAME_MILLISECONDS;
+        int checkpointsSeen = checkpointer.getFinished();
+        int checkpointsSkipped = 0, checkpointsWritten = 0, checkpointsFailed = 0;
+        long long checkpointBytes = 0, checkpointMaxMicros = 0;
+        long long lateMicros = 0;
+        for (int f = 0; f < frames; f++) {
+            chrono::steady_clock::time_point nextFrame = start + chrono::milliseconds(FRAME_MILLISECONDS) * (f + 1);
+            int appliedThisFrame = 0;
+            while (chrono::steady_clock::now() < nextFrame) {
+                int applied = drainCommands();
+                if (applied == 0) this_thread::sleep_for(chrono::milliseconds(1));
+                appliedThisFrame += applied;
+            }
+            long long late = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - nextFrame).count();
+            if (late > lateMicros) lateMicros = late;
+            if (appliedThisFrame > 0) publishSnapshot();
+            else checkpointer.poll();
+            if (checkpointer.getFinished() != checkpointsSeen) {
+                // one runs at a time, so at most one finishes per publish
+                checkpointsSeen = checkpointer.getFinished();
+                const CheckpointReport& saved = checkpointer.getLast();
+                if (!saved.error.empty()) checkpointsFailed++;
+                else checkpointsWritten++;
+                checkpointBytes += saved.bytes;
+                if (saved.micros > checkpointMaxMicros) checkpointMaxMicros = saved.micros;
+            }
+            if (checkpointFrames > 0 && f % checkpointFrames == checkpointFrames - 1 && !startCheckpoint())
+                checkpointsSkipped++;
+        }
+
+        running.store(false);
+        replay.join();
+        script.join();
+        timer.join();
+        render.join();
+        while (drainCommands() > 0) {}
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cout << "\x1b[?25h\x1b[" << radarView.getHeight() + 1 << ";1H";
+        long long batches = commandQueue.getBatches();
+        setColor(COLOR_INFO);
+        cout << "\n  Queued: " << reportsQueued.load() << " position reports, " << scriptQueued.load()
+            << " scripted commands, " << ticksQueued.load() << " ticks in " << elapsed << " s\n";
+        cout << "  Applied " << commandStats.applied << " in " << batches << " batches ("
+            << (batches > 0 ? (double)commandQueue.getDrained() / batches : 0) << " per batch), "
+            << (commandStats.applied > 0 ? commandStats.latencyMicros / commandStats.applied : 0) << " us average latency, "
+            << commandStats.maxLatencyMicros << " us worst\n";
+        cout << "  " << commandStats.landed << " landed, " << commandStats.conflicts << " reports refused (node taken), "
+            << commandStats.failed << " for unknown or landed flights\n";
+        setColor(commandQueue.getRejected() > 0 ? COLOR_WARNING : COLOR_INFO);
+        cout << "  Back-pressure: " << commandQueue.getRejected() << " pushes refused, queue peak "
+            << commandQueue.getMaxDepth() << " of " << commandQueue.getCapacity() << "\n";
+        setColor(lateMicros > FRAME_MILLISECONDS * 1000 ? COLOR_WARNING : COLOR_INFO);
+        cout << "  Engine frames: worst " << lateMicros / 1000.0 << " ms behind the " << FRAME_MILLISECONDS
+            << " ms schedule\n";
+        if (checkpointSeconds > 0) {
+            setColor(checkpointsFailed > 0 ? COLOR_DANGER : COLOR_INFO);
+            cout << "  Checkpoints: " << checkpointsWritten << " written (" << checkpointBytes / 1024 << " KB, slowest "
+                << checkpointMaxMicros / 1000.0 << " ms), " << checkpointsFailed << " failed, " << checkpointsSkipped
+                << " skipped while one was still writing" << (checkpointer.isRunning() ? ", one still writing" : "")
+                << "\n";
+            if (!checkpointer.getLast().error.empty()) cout << "    " << checkpointer.getLast().error << "\n";
+        }
         setColor(COLOR_RESET);
 
-        airspace.checkAllCollisions();
+        delete[] neighbours;
+        delete[] names;
     }
 
-    void saveData()
+    // Writes a sample recording for the registered flights: each one
+    // reports every FEED_REPORT_SECONDS, walking the network at random.
+    // Written like a checkpoint, so an interrupted recording never leaves
+    // half a file under the feed's name.
+    void recordFeed()
     {
+        const int FEED_REPORT_SECONDS = 4;
+        int reports = readInt("  Position reports to record (1000-100000000): ", 1000, 100000000);
+        int format = readInt("  Format (1 = CSV, 2 = binary): ", 1, 2);
+        string filename = (format == 1) ? "position_feed.csv" : "position_feed.bin";
+
+        int nodeCount = airspace.getNodeCount();
+        DynamicArray<int>* neighbours = new DynamicArray<int>[nodeCount];
+        for (int i = 0; i < nodeCount; i++)
+            for (Edge* edge = airspace.getEdges(i); edge != NULL; edge = edge->next)
+                neighbours[i].push(airspace.getNodeIndex(edge->destination));
+        DynamicArray<string> flights;
+        DynamicArray<int> at;
+        auto airborne = [this, &flights, &at](const Aircraft& aircraft) {
+            int node = airspace.getNodeIndex(aircraft.currentNode);
+            if (aircraft.status == "Landed" || node < 0) return;
+            flights.push(aircraft.flightID);
+            at.push(node);
+        };
+        aircraftRegistry.forEach(airborne);
+        if (flights.empty()) {
+            setColor(COLOR_WARNING);
+            cout << "\n  No flights in the air to record. Add some flights first.\n";
+            setColor(COLOR_RESET);
+            delete[] neighbours;
+            return;
+        }
+
+        long long begin = steadyMicros();
+        long base = currentTime();
         try {
-            aircraftRegistry.saveToFile("aircraft_registry.txt");
-            flightLog.saveToFile("flight_log.txt");
+            CheckpointFile file(filename, NULL);
+            string chunk;
+            if (format == 1) {
+                chunk = "# time,flight,node\n";
+            }
+            else {
+                FeedFileHeader header;
+                memcpy(header.magic, FEED_MAGIC, sizeof(FEED_MAGIC));
+                header.flightCount = (unsigned int)flights.size();
+                header.nodeCount = (unsigned int)nodeCount;
+                header.reportCount = (unsigned long long)reports;
+                header.baseTime = base;
+                chunk.append(reinterpret_cast<const char*>(&header), sizeof(header));
+                for (int f = 0; f < flights.size(); f++) {
+                    chunk += (char)flights[f].length();
+                    chunk += flights[f];
+                }
+                for (int n = 0; n < nodeCount; n++) {
+                    const string& name = airspace.getNodeAt(n)->name;
+                    chunk += (char)name.length();
+                    chunk += name;
+                }
+            }
 
-            setColor(COLOR_SUCCESS);
-            cout << "\n  Data saved successfully!\n";
-            setColor(COLOR_INFO);
-            cout << "    ---> aircraft_registry.txt\n";
-            cout << "    ---> flight_log.txt\n";
-            setColor(COLOR_RESET);
+            unsigned int state = 2463534242u;
+            unsigned int fields[3];
+            for (int r = 0; r < reports; r++) {
+                int flight = r % flights.size();
+                DynamicArray<int>& next = neighbours[at[flight]];
+                state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+                if (!next.empty()) at[flight] = next[(int)(state % (unsigned int)next.size())];
+                unsigned int seconds = (unsigned int)(r / flights.size()) * FEED_REPORT_SECONDS;
+                if (format == 1) {
+                    appendNumber(chunk, base + seconds);
+                    chunk += ',';
+                    chunk += flights[flight];
+                    chunk += ',';
+                    chunk += airspace.getNodeAt(at[flight])->name;
+                    chunk += '\n';
+                }
+                else {
+                    fields[0] = seconds;
+                    fields[1] = (unsigned int)flight;
+                    fields[2] = (unsigned int)at[flight];
+                    chunk.append(reinterpret_cast<const char*>(fields), sizeof(fields));
+                }
+                if (chunk.size() >= 65536) {
+                    file.append(chunk);
+                    chunk.clear();
+                }
+            }
+            file.append(chunk);
+            file.commit();
         }
-        catch (FileOperationException& e) {
+        catch (AircraftException& e) {
             setColor(COLOR_DANGER);
             cout << "\n  Issue: " << e.what() << "\n";
             setColor(COLOR_RESET);
+            delete[] neighbours;
+            return;
         }
+        delete[] neighbours;
+
+        setColor(COLOR_SUCCESS);
+        cout << "\n  Recorded " << reports << " reports for " << flights.size() << " flights in "
+            << (steadyMicros() - begin) / 1000.0 << " ms\n";
+        setColor(COLOR_INFO);
+        cout << "    ---> " << filename << "\n";
+        setColor(COLOR_RESET);
     }
 
-    void loadData()
+    // Streams a recorded position feed into the live airspace. Slices of
+    // the memory-mapped file are parsed in parallel; this thread folds the
+    // reports of each batch per flight (latest node, fuel for every leg
+    // flown) and then moves each flight once, which updates the registry,
+    // node occupancy and the radar. Replay paces batches by the recorded
+    // timestamps; maximum speed takes one batch per parsed slice.
+    void ingestFeed()
     {
+        const int FRAME_MILLISECONDS = 50;
+
+        string filename = readLine("  Feed file (Enter for position_feed.csv): ");
+        if (filename.empty()) filename = "position_feed.csv";
+        int speed = readInt("  Replay speed (0 = as fast as possible, 1-3600 x recorded time): ", 0, 3600);
+
+        // Name tables the parsers resolve against; flight IDs index live,
+        // node IDs are the graph's node indices
+        FeedNameIndex flightIndex, nodeIndex;
+        DynamicArray<string> live;
+        DynamicArray<int> liveAt;
+        auto airborne = [this, &flightIndex, &live, &liveAt](const Aircraft& aircraft) {
+            int at = airspace.getNodeIndex(aircraft.currentNode);
+            if (aircraft.status == "Landed" || at < 0) return;
+            flightIndex.add(aircraft.flightID);
+            live.push(aircraft.flightID);
+            liveAt.push(at);
+        };
+        aircraftRegistry.forEach(airborne);
+        int nodeCount = airspace.getNodeCount();
+        for (int n = 0; n < nodeCount; n++) nodeIndex.add(airspace.getNodeAt(n)->name);
+
+        // Fuel per edge, grouped by source node, so folding a report scans
+        // only the edges leaving the previous node. O(nodes + edges) memory.
+        int* legStart = new int[nodeCount + 1];
+        DynamicArray<int> legTarget, legCost;
+        for (int a = 0; a < nodeCount; a++) {
+            legStart[a] = legTarget.size();
+            for (Edge* edge = airspace.getEdges(a); edge != NULL; edge = edge->next) {
+                int b = airspace.getNodeIndex(edge->destination);
+                if (b < 0) continue;
+                legTarget.push(b);
+                legCost.push(fuelForDistance(edge->weight));
+            }
+        }
+        legStart[nodeCount] = legTarget.size();
+        // the first edge to a node wins, as in getEdgeWeight
+        auto legFuelAt = [&](int from, int to) {
+            for (int e = legStart[from]; e < legStart[from + 1]; e++)
+                if (legTarget[e] == to) return legCost[e];
+            return fuelForDistance(-1);
+        };
+
+        int flightCount = live.size();
+        int* lastNode = new int[flightCount > 0 ? flightCount : 1];     // last node seen in the feed
+        int* pendingFuel = new int[flightCount > 0 ? flightCount : 1];
+        bool* touched = new bool[flightCount > 0 ? flightCount : 1];
+        DynamicArray<int> touchedList;
+        for (int f = 0; f < flightCount; f++) {
+            lastNode[f] = liveAt[f];
+            pendingFuel[f] = 0;
+            touched[f] = false;
+        }
+
+        int workers = (int)thread::hardware_concurrency();
+        if (workers < 1) workers = 1;
+        if (workers > 64) workers = 64;
+        DynamicArray<FeedReport>* parts = new DynamicArray<FeedReport>[workers];
+        int part = 0, offset = 0, partCount = 0;     // read position in the parsed slice
+
+        long long reports = 0, unknownFlights = 0, unknownNodes = 0, moves = 0, conflicts = 0, escalations = 0;
+        long long batches = 0, parseMicros = 0, applyMicros = 0;
+        long long firstTime = -1, feedTime = 0;
+        size_t fileBytes = 0;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
         try {
+            FeedReader reader(filename, flightIndex, nodeIndex);
+            fileBytes = reader.getSize();
+
+            cout << "\x1b[2J\x1b[?25l";
+            cout.flush();
+            radarView.invalidate();
+
+            string status;
+            chrono::steady_clock::time_point nextFrame = start;
+            for (int frame = 0; ; frame++) {
+                long long due = LLONG_MAX;
+                if (speed > 0 && firstTime >= 0) {
+                    long long elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+                    due = firstTime + elapsed * speed / 1000;
+                }
+
+                // Fold the reports due in this batch
+                bool finished = false;
+                bool sliceEnded = false;
+                long long batchStart = steadyMicros();
+                long long batchParse = 0;
+                while (true) {
+                    if (part == partCount) {
+                        // maximum speed: one batch per slice
+                        if (speed == 0 && sliceEnded) break;
+                        if (reader.isDone()) {
+                            finished = true;
+                            break;
+                        }
+                        long long parsing = steadyMicros();
+                        reader.readSlice(parts, workers);
+                        batchParse += steadyMicros() - parsing;
+                        part = 0;
+                        offset = 0;
+                        partCount = workers;
+                    }
+                    if (offset == parts[part].size()) {
+                        part++;
+                        offset = 0;
+                        sliceEnded = (part == partCount);
+                        continue;
+                    }
+                    const FeedReport& report = parts[part][offset];
+                    if (firstTime < 0) {
+                        // replay is paced from the first report
+                        firstTime = report.time;
+                        if (speed > 0) due = firstTime;
+                    }
+                    if (report.time > due) break;
+                    offset++;
+                    reports++;
+                    feedTime = report.time;
+                    if (report.flight < 0) {
+                        unknownFlights++;
+                        continue;
+                    }
+                    if (report.node < 0) {
+                        unknownNodes++;
+                        continue;
+                    }
+                    int f = report.flight;
+                    if (lastNode[f] != report.node) {
+                        if (lastNode[f] >= 0) pendingFuel[f] += legFuelAt(lastNode[f], report.node);
+                        lastNode[f] = report.node;
+                        if (!touched[f]) {
+                            touched[f] = true;
+                            touchedList.push(f);
+                        }
+                    }
+                }
+
+                // Apply the batch: each moved flight once
+                int f = 0;
+                auto apply = [&](Aircraft& aircraft) {
+                    int from = airspace.getNodeIndex(aircraft.currentNode);
+                    int to = lastNode[f];
+                    if (from != to) {
+                        if (airspace.tryOccupyAt(to, aircraft.flightID) == ATC_OK) {
+                            if (from >= 0) airspace.freeNodeAt(from);
+                            GraphNode* node = airspace.getNodeAt(to);
+                            aircraft.x = node->x;
+                            aircraft.y = node->y;
+                            aircraft.currentNode = node->name;
+                            moves++;
+                        }
+                        else {
+                            conflicts++;
+                        }
+                    }
+                    // the legs were flown whether or not the final node was free
+                    if (pendingFuel[f] > 0 && burnFuel(aircraft, pendingFuel[f])) escalations++;
+                };
+                for (int t = 0; t < touchedList.size(); t++) {
+                    f = touchedList[t];
+                    aircraftRegistry.tryModify(live[f], apply);
+                    pendingFuel[f] = 0;
+                    touched[f] = false;
+                }
+                if (touchedList.size() > 0) batches++;
+                touchedList.clear();
+                parseMicros += batchParse;
+                applyMicros += steadyMicros() - batchStart - batchParse;
+
+                bool drawn = speed > 0 || finished || chrono::steady_clock::now() >= nextFrame;
+                if (drawn) {
+                    publishSnapshot();
+                    ScratchScope scope;
+                    SnapshotReader<AirspaceSnapshot> view(snapshots);
+                    composeRadar(*view);
+                    status = "  INGEST  ";
+                    if (firstTime >= 0) status += formatTime((long)feedTime);
+                    status += "  ";
+                    appendNumber(status, reports);
+                    status += " reports";
+                    if (speed > 0) {
+                        status += ", ";
+                        appendNumber(status, speed);
+                        status += 'x';
+                    }
+                    status += "      ";
+                    radarView.putText(VIEW_ROWS + 4, 0, status, COLOR_INFO);
+                    radarView.present();
+                    nextFrame = chrono::steady_clock::now() + chrono::milliseconds(FRAME_MILLISECONDS);
+                }
+                if (finished) break;
+                if (speed > 0) this_thread::sleep_until(start + chrono::milliseconds(FRAME_MILLISECONDS) * (frame + 1));
+            }
+
+            long long malformed = reader.getMalformed();
+            double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            cout << "\x1b[?25h\x1b[" << radarView.getHeight() + 1 << ";1H";
             setColor(COLOR_INFO);
-            cout << "\n  Loading saved data...\n";
+            cout << "\n  " << (reader.isBinary() ? "Binary" : "CSV") << " feed, " << fileBytes / 1024 << " KB, "
+                << reports << " reports in " << elapsed << " s";
+            if (speed == 0 && elapsed > 0)
+                cout << " (" << reports / elapsed / 1e6 << " M reports/s, " << fileBytes / elapsed / 1e6 << " MB/s)";
+            cout << "\n";
+            cout << "  Parsing: " << parseMicros / 1000.0 << " ms on " << workers << " threads; applying: "
+                << applyMicros / 1000.0 << " ms in " << batches << " batches\n";
+            cout << "  " << moves << " moves, " << conflicts << " refused (node taken), " << escalations
+                << " low-fuel escalations\n";
+            setColor(unknownFlights + unknownNodes + malformed > 0 ? COLOR_WARNING : COLOR_INFO);
+            cout << "  Skipped: " << unknownFlights << " for flights not in the air, " << unknownNodes
+                << " for unknown nodes, " << malformed << " malformed records\n";
+            setColor(COLOR_RESET);
+        }
+        catch (AircraftException& e) {
+            setColor(COLOR_DANGER);
+            cout << "\n  Issue: " << e.what() << "\n";
+            setColor(COLOR_RESET);
+        }
 
-            // IMPORTANT: Clear heap before loading to prevent duplicates
-            MinHeap tempHeap;  // Create temporary heap
-            landingQueue = tempHeap;  // Replace with empty heap
+        delete[] parts;
+        delete[] touched;
+        delete[] pendingFuel;
+        delete[] lastNode;
+        delete[] legStart;
+    }
+
+    void feedIngestion()
+    {
+        setColor(COLOR_HEADER);
+        cout << "\n|||===========================================================|||\n";
+        cout << "|||                 RADAR FEED INGESTION                      |||\n";
+        cout << "|||===========================================================|||\n";
+        setColor(COLOR_RESET);
 
-            aircraftRegistry.loadFromFile("aircraft_registry.txt");
+        setColor(MENU);
+        cout << "  1. "; setColor(COLOR_RESET);
+        cout << "Ingest Recorded Feed (Memory-Mapped, Parallel Parsing)\n";
+        setColor(MENU);
+        cout << "  2. "; setColor(COLOR_RESET);
+        cout << "Record Sample Feed (CSV or Binary)\n";
+        setColor(MENU);
+        cout << "  0. "; setColor(COLOR_RESET);
+        cout << "Back\n";
+
+        int choice = readInt("\n  Enter choice: ", 0, 2);
+        switch (choice) {
+        case 1:
+            ingestFeed();
+            break;
+        case 2:
+            recordFeed();
+            break;
+        }
+    }
 
-            Aircraft allAircraft[100];
-            int count = 0;
-            aircraftRegistry.getAllAircraft(allAircraft, count);
+    void checkCollisions()
+    {
+        setColor(COLOR_HEADER);
+        cout << "\n|||===========================================================|||\n";
+        cout << "|||                COLLISION DETECTION                        |||\n";
+        cout << "|||===========================================================|||\n";
+        setColor(COLOR_RESET);
 
-            // Rebuild landing queue from loaded aircraft
-            for (int i = 0; i < count; i++) {
-                if (allAircraft[i].status != "Landed") {
-                    landingQueue.insert(allAircraft[i]);
-                }
-            }
+        airspace.checkAllCollisions();
+    }
 
-            flightLog.loadFromFile("flight_log.txt");
+    // Hands the latest snapshot to the background checkpoint writer; the
+    // result shows in the statistics once it has finished
+    void saveData()
+    {
+        if (!startCheckpoint()) {
+            setColor(COLOR_WARNING);
+            cout << "\n  A checkpoint is still being written (" << checkpointer.getPercent() << "% of version "
+                << checkpointer.getVersion() << "). Try again when it has finished.\n";
+            setColor(COLOR_RESET);
+            return;
+        }
+        setColor(COLOR_SUCCESS);
+        cout << "\n  Checkpoint started in the background.\n";
+        setColor(COLOR_INFO);
+        cout << "    ---> " << registryFile << "\n";
+        cout << "    ---> " << logFile << "\n";
+        setColor(COLOR_RESET);
+    }
 
-            // Rebuild radar
-            initializeRadar();
+    // Replaces the live state with the saved files: registry, landing
+    // queues rebuilt in one bulk build, flight log, analytics and node
+    // occupancy. Throws FileOperationException if there is nothing saved
+    // and CheckpointException, leaving the live state alone, if the two
+    // files come from different checkpoints. Returns the number of
+    // aircraft records loaded.
+    int restoreData()
+    {
+        long long registryVersion = Checkpointer::readVersion(registryFile);
+        long long logVersion = Checkpointer::readVersion(logFile);
+        if (registryVersion != logVersion) {
+            string reason = "version ";
+            appendNumber(reason, logVersion);
+            reason += " does not match " + registryFile + " version ";
+            appendNumber(reason, registryVersion);
+            throw CheckpointException(logFile, reason);
+        }
 
-            radar[2][2] = 'A';
-            radar[17][17] = 'A';
-            radar[10][10] = 'A';
-            radar[2][17] = 'A';
-            radar[17][2] = 'A';
+        // IMPORTANT: Clear queues before loading to prevent duplicates
+        landingScheduler.clear();
+
+        aircraftRegistry.loadFromFile(registryFile);
+
+        int count = aircraftRegistry.getCount();
+
+        // Rebuild landing queues from loaded aircraft in one bulk build
+        DynamicArray<Aircraft> queued;
+        DynamicArray<string> queuedAirport;
+        queued.reserve(count);
+        queuedAirport.reserve(count);
+        auto requeue = [this, &queued, &queuedAirport](Aircraft& aircraft) {
+            if (aircraft.status == "Landed") return;
+            if (aircraft.queuedAt == 0) aircraft.queuedAt = currentTime();
+            queued.push(aircraft);
+            queuedAirport.push(landingAirportFor(aircraft));
+        };
+        aircraftRegistry.modifyEach(requeue);
+        landingScheduler.build(queued.data(), queuedAirport.data(), queued.size());
+
+        flightLog.loadFromFile(logFile);
+        for (int i = 0; i < queued.size(); i++) flightLog.reserve(queued[i], queued.size());
+        logEpoch++;
+
+        // Analytics are not persisted; fold the restored hot window back
+        // in (archived history is not re-read at startup)
+        analytics.clear();
+        auto replay = [this](const Aircraft& record) { analytics.record(record, landingAirportFor(record)); };
+        flightLog.forEachRecent(replay);
+
+        // Re-occupy nodes in graph from the loaded registry; the radar
+        // follows occupancy
+        airspace.clearOccupancy();
+        auto occupy = [this](const Aircraft& aircraft) {
+            if (aircraft.status == "Landed") return;
+            try {
+                airspace.occupyNode(aircraft.currentNode, aircraft.flightID);
+            }
+            catch (CollisionException& e) {
+                // Log collision but continue loading; the first
+                // flight keeps the node
+                setColor(COLOR_WARNING);
+                cout << "  Warning: " << e.what() << " (collision during load)\n";
+                setColor(COLOR_RESET);
+            }
+        };
+        aircraftRegistry.forEach(occupy);
+        return count;
+    }
 
-            // Restore planes and re-occupy nodes in graph
-            for (int i = 0; i < count; i++) {
-                if (allAircraft[i].status != "Landed") {
-                    radar[allAircraft[i].x][allAircraft[i].y] = 'P';
-                    try {
-                        airspace.occupyNode(allAircraft[i].currentNode, allAircraft[i].flightID);
-                    }
-                    catch (CollisionException& e) {
-                        // Log collision but continue loading
-                        setColor(COLOR_WARNING);
-                        cout << "  Warning: " << e.what() << " (collision during load)\n";
-                        setColor(COLOR_RESET);
-                        airspace.freeNode(allAircraft[i].currentNode);
-                    }
-                }
+    void loadData()
+    {
+        try {
+            setColor(COLOR_INFO);
+            if (checkpointer.isRunning()) {
+                // load what the last save wrote, not the files it is replacing
+                cout << "\n  Waiting for the checkpoint in progress...\n";
+                checkpointer.wait();
             }
+            cout << "\n  Loading saved data...\n";
+
+            int count = restoreData();
 
             setColor(COLOR_SUCCESS);
             cout << "  Data loaded successfully!\n";
@@ -819,6 +3453,12 @@ public:
             cout << "  No saved data found. Starting fresh.\n";
             setColor(COLOR_RESET);
         }
+        catch (CheckpointException& e) {
+            setColor(COLOR_DANGER);
+            cout << "  Issue: " << e.what() << "\n";
+            cout << "  The saved files are not one checkpoint; current data kept.\n";
+            setColor(COLOR_RESET);
+        }
     }
 
     void displayMenu()
@@ -866,6 +3506,30 @@ public:
         cout << "  12. "; setColor(COLOR_RESET);
         cout << "Load System Data\n";
         setColor(MENU);
+        cout << "  13. "; setColor(COLOR_RESET);
+        cout << "Performance Diagnostics\n";
+        setColor(MENU);
+        cout << "  14. "; setColor(COLOR_RESET);
+        cout << "Advance Simulation Tick (Batch Landings)\n";
+        setColor(MENU);
+        cout << "  15. "; setColor(COLOR_RESET);
+        cout << "Configure Airport Runways\n";
+        setColor(MENU);
+        cout << "  16. "; setColor(COLOR_RESET);
+        cout << "Land Next K Flights (Batch)\n";
+        setColor(MENU);
+        cout << "  17. "; setColor(COLOR_RESET);
+        cout << "Flight Log Reports (Time Range / Rank)\n";
+        setColor(MENU);
+        cout << "  18. "; setColor(COLOR_RESET);
+        cout << "Live Radar (Running Simulation)\n";
+        setColor(MENU);
+        cout << "  19. "; setColor(COLOR_RESET);
+        cout << "Command Feed (Replay / Script / Timer Threads)\n";
+        setColor(MENU);
+        cout << "  20. "; setColor(COLOR_RESET);
+        cout << "Radar Feed Ingestion (Recorded Position Files)\n";
+        setColor(MENU);
         cout << "  0. "; setColor(COLOR_RESET);
         cout << "Exit System\n";
 
@@ -878,11 +3542,16 @@ public:
     {
         int choice;
         while (true) {
+            // Scratch allocations made by one menu operation end with it
+            ScratchScope scope;
+            // Commands queued while the menu waited for input
+            while (drainCommands() == COMMAND_BATCH) {}
+            publishSnapshot();
             displayMenu();
             displayLandingQueue();
             displayStatistics();
 
-            choice = readInt("\n  Enter choice: ", 0, 12);
+            choice = readInt("\n  Enter choice: ", 0, 20);
 
             switch (choice) {
             case 1:
@@ -922,6 +3591,30 @@ public:
             case 12:
                 loadData();
                 break;
+            case 13:
+                performanceDiagnostics();
+                break;
+            case 14:
+                advanceTick();
+                break;
+            case 15:
+                configureRunways();
+                break;
+            case 16:
+                landNextFlights();
+                break;
+            case 17:
+                flightLogReports();
+                break;
+            case 18:
+                liveRadar();
+                break;
+            case 19:
+                commandFeed();
+                break;
+            case 20:
+                feedIngestion();
+                break;
             case 0:
                 setColor(COLOR_SUCCESS);
                 cout << "\n  Shutting down SkyNet ATC. Goodbye!\n";
@@ -939,8 +3632,11 @@ public:
     }
 };
 
-int main()
+int main(int argc, char* argv[])
 {
+    // Sector process started by the federation run
+    if (argc == 4 && string(argv[1]) == "--sector") return runSectorProcess(argv[2], atoi(argv[3]));
+
     srand((unsigned)time(0));
 
     setColor(COLOR_HEADER);
@@ -5,14 +5,51 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <spawn.h>
+#endif
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 #include <cstdlib>
 #include <ctime>
 #include <sstream>
 #include <cstring>
+#include <cmath>
+#include <cstdio>
+#include <cerrno>
+#include <climits>
+#include <iterator>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <utility>
+#include <type_traits>
 
 using namespace std;
 
+#ifndef _WIN32
+// POSIX stand-in for the MSVC call used to format timestamps
+inline int localtime_s(struct tm* result, const time_t* time)
+{
+    return (localtime_r(time, result) != NULL) ? 0 : 1;
+}
+#endif
+
 // ===== COLORS =====
 const int COLOR_RESET = 7;
 const int COLOR_HEADER = 11;
@@ -24,19 +61,253 @@ const int COLOR_CRITICAL = 13;
 const int MENU = 15;
 const int COLOR_SUBTITLE = 8;
 
+// Console attribute (1 = blue, 2 = green, 4 = red, 8 = bright) as an ANSI
+// foreground colour code
+int ansiColor(int color)
+{
+    int rgb = ((color & 4) ? 1 : 0) | ((color & 2) ? 2 : 0) | ((color & 1) ? 4 : 0);
+    return ((color & 8) ? 90 : 30) + rgb;
+}
+
 void setColor(int color)
 {
+#ifdef _WIN32
     HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
     SetConsoleTextAttribute(hConsole, color);
+#else
+    cout << "\x1b[" << ansiColor(color) << "m";
+#endif
+}
+
+// Lets the Windows console interpret ANSI escapes; terminals elsewhere
+// already do
+void enableAnsiOutput()
+{
+#ifdef _WIN32
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    if (GetConsoleMode(hConsole, &mode))
+        SetConsoleMode(hConsole, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+#endif
+}
+
+// Appends the decimal digits of value without going through a stream
+void appendNumber(string& out, long long value)
+{
+    char digits[24];
+    int length = 0;
+    unsigned long long magnitude = (value < 0) ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    do {
+        digits[length++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) out += '-';
+    while (length > 0) out += digits[--length];
 }
 
 string toString(int value)
 {
-    stringstream ss;
-    ss << value;
-    return ss.str();
+    string out;
+    appendNumber(out, value);
+    return out;
+}
+
+// FNV-1a, used by the structures that need a well-spread string hash
+unsigned int hashBytes(const char* data, size_t length)
+{
+    unsigned int h = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        h ^= (unsigned char)data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+unsigned int hashString(const string& key)
+{
+    return hashBytes(key.data(), key.length());
 }
 
+// ===== FRAME RENDERER =====
+// Double-buffered character framebuffer. A frame is composed off screen in
+// the back buffer and compared with what the terminal already shows; only
+// changed cells are sent, as ANSI escapes, in a single write. A colour code
+// is emitted only where the colour changes, and the cursor only jumps over
+// unchanged stretches too long to be worth rewriting.
+class FrameRenderer
+{
+private:
+    struct Cell
+    {
+        char ch;
+        unsigned char color;
+
+        bool operator==(const Cell& other) const { return ch == other.ch && color == other.color; }
+        bool operator!=(const Cell& other) const { return !(*this == other); }
+    };
+
+    // Rewriting up to this many unchanged cells is cheaper than a cursor move
+    static const int MAX_REWRITE = 6;
+
+    Cell* front;            // what the terminal shows
+    Cell* back;             // the frame being composed
+    int width;
+    int height;
+    int originRow;          // screen row (1-based) of the frame's top line
+    bool fullRedraw;
+    string output;
+    int color;              // colour the terminal is in while writing, -1 if unknown
+    int changedCells;
+
+    void setOutputColor(int cellColor)
+    {
+        if (cellColor == color) return;
+        output += "\x1b[";
+        appendNumber(output, ansiColor(cellColor));
+        output += 'm';
+        color = cellColor;
+    }
+
+    void moveCursor(int row, int col)
+    {
+        output += "\x1b[";
+        appendNumber(output, originRow + row);
+        output += ';';
+        appendNumber(output, col + 1);
+        output += 'H';
+    }
+
+    // Blanks look the same in any foreground colour, so they never switch it
+    void writeCell(const Cell& cell)
+    {
+        if (cell.ch != ' ') setOutputColor(cell.color);
+        output += cell.ch;
+    }
+
+public:
+    FrameRenderer(int w, int h, int topRow = 1)
+        : front(NULL), back(NULL), width(0), height(0), originRow(topRow), fullRedraw(true), color(-1), changedCells(0)
+    {
+        resize(w, h);
+    }
+
+    ~FrameRenderer()
+    {
+        delete[] front;
+        delete[] back;
+    }
+
+    FrameRenderer(const FrameRenderer&) = delete;
+    FrameRenderer& operator=(const FrameRenderer&) = delete;
+
+    void resize(int w, int h)
+    {
+        if (w == width && h == height) return;
+        delete[] front;
+        delete[] back;
+        width = (w < 1) ? 1 : w;
+        height = (h < 1) ? 1 : h;
+        front = new Cell[width * height];
+        back = new Cell[width * height];
+        clear();
+        invalidate();
+    }
+
+    // Next present() repaints every cell, e.g. after the screen was cleared
+    void invalidate() { fullRedraw = true; }
+
+    void clear(char ch = ' ', int cellColor = COLOR_RESET)
+    {
+        Cell blank = { ch, (unsigned char)cellColor };
+        for (int i = 0; i < width * height; i++) back[i] = blank;
+    }
+
+    void put(int row, int col, char ch, int cellColor)
+    {
+        if (row < 0 || row >= height || col < 0 || col >= width) return;
+        Cell& cell = back[row * width + col];
+        cell.ch = ch;
+        cell.color = (unsigned char)cellColor;
+    }
+
+    // Clipped at the right edge; returns the column after the text
+    int putText(int row, int col, const char* text, int cellColor)
+    {
+        for (; *text != '\0'; text++, col++) put(row, col, *text, cellColor);
+        return col;
+    }
+
+    int putText(int row, int col, const string& text, int cellColor) { return putText(row, col, text.c_str(), cellColor); }
+
+    // Builds the escape sequence that turns the shown frame into the
+    // composed one, then makes the composed frame the shown one
+    const string& compose()
+    {
+        output.clear();
+        color = -1;
+        changedCells = 0;
+
+        for (int r = 0; r < height; r++) {
+            int cursorCol = -1;         // column the cursor sits at in this row, -1 if elsewhere
+            for (int c = 0; c < width; c++) {
+                int i = r * width + c;
+                if (!fullRedraw && back[i] == front[i]) continue;
+
+                if (cursorCol != -1 && c - cursorCol <= MAX_REWRITE) {
+                    for (int k = cursorCol; k < c; k++) writeCell(back[r * width + k]);
+                }
+                else moveCursor(r, c);
+
+                writeCell(back[i]);
+                front[i] = back[i];
+                cursorCol = c + 1;
+                changedCells++;
+            }
+        }
+        if (!output.empty()) output += "\x1b[0m";
+        fullRedraw = false;
+        return output;
+    }
+
+    // Sends the changes in one write; returns the bytes written
+    size_t present()
+    {
+        compose();
+        if (!output.empty()) {
+            cout.write(output.data(), (streamsize)output.size());
+            cout.flush();
+        }
+        return output.size();
+    }
+
+    // Writes the whole composed frame at the cursor, line by line, for
+    // output that scrolls with the rest of the console. The next present()
+    // repaints in full.
+    size_t presentInline()
+    {
+        output.clear();
+        color = -1;
+        for (int r = 0; r < height; r++) {
+            int end = width;
+            while (end > 0 && back[r * width + end - 1].ch == ' ') end--;
+            for (int c = 0; c < end; c++) writeCell(back[r * width + c]);
+            output += '\n';
+        }
+        output += "\x1b[0m";
+        cout.write(output.data(), (streamsize)output.size());
+        cout.flush();
+        fullRedraw = true;
+        return output.size();
+    }
+
+    int getWidth() { return width; }
+    int getHeight() { return height; }
+    int getChangedCells() { return changedCells; }
+};
+
 // ===== EXCEPTIONS =====
 class AircraftException
 {
@@ -63,14 +334,6 @@ public:
     }
 };
 
-class HeapOverflowException : public AircraftException
-{
-public:
-    HeapOverflowException()
-        : AircraftException("Landing queue is full") {
-    }
-};
-
 class FileOperationException : public AircraftException
 {
 public:
@@ -95,6 +358,22 @@ public:
     }
 };
 
+class SharedMemoryException : public AircraftException
+{
+public:
+    SharedMemoryException(string name, string reason)
+        : AircraftException("Shared memory " + name + ": " + reason) {
+    }
+};
+
+class CheckpointException : public AircraftException
+{
+public:
+    CheckpointException(string filename, string reason)
+        : AircraftException("Checkpoint " + filename + ": " + reason) {
+    }
+};
+
 class NoPathException : public AircraftException
 {
 public:
@@ -103,6 +382,34 @@ public:
     }
 };
 
+// ===== STATUS CODES =====
+// Outcomes the simulation loops expect to hit routinely (an empty queue, a
+// flight that is not queued, a node already taken, no route) are returned
+// by the try* calls instead of thrown. The throwing calls wrap them for the
+// interactive menus, where the exception message is what gets shown.
+enum AtcStatus
+{
+    ATC_OK,
+    ATC_NOT_FOUND,
+    ATC_EMPTY,
+    ATC_OCCUPIED,
+    ATC_NO_PATH,
+    ATC_UNKNOWN_NODE
+};
+
+const char* statusText(AtcStatus status)
+{
+    switch (status) {
+    case ATC_OK: return "OK";
+    case ATC_NOT_FOUND: return "not found";
+    case ATC_EMPTY: return "queue empty";
+    case ATC_OCCUPIED: return "occupied";
+    case ATC_NO_PATH: return "no path";
+    case ATC_UNKNOWN_NODE: return "unknown node";
+    }
+    return "unknown";
+}
+
 // ===== AIRCRAFT =====
 struct Aircraft
 {
@@ -117,12 +424,13 @@ struct Aircraft
     int y;
     long timestamp;
     string currentNode;
+    long queuedAt;      // when the flight joined the landing queue
 
-    Aircraft() : fuelLevel(0), priority(4), x(0), y(0), timestamp(0), status("In Flight") {}
+    Aircraft() : fuelLevel(0), priority(4), x(0), y(0), timestamp(0), status("In Flight"), queuedAt(0) {}
 
     Aircraft(string id, string m, int fuel, string orig, string dest, int prio)
         : flightID(id), model(m), fuelLevel(fuel), origin(orig), destination(dest),
-        priority(prio), status("In Flight"), x(0), y(0), timestamp(0) {
+        priority(prio), status("In Flight"), x(0), y(0), timestamp(0), queuedAt(0) {
     }
 
     void validate()
@@ -133,13 +441,29 @@ struct Aircraft
         if (priority < 1 || priority > 4) throw InvalidInputException("Priority");
     }
 
+    // Appends the CSV form to out, so writers can reuse one line buffer
+    void appendTo(string& out) const
+    {
+        out += flightID; out += ',';
+        out += model; out += ',';
+        appendNumber(out, fuelLevel); out += ',';
+        out += origin; out += ',';
+        out += destination; out += ',';
+        appendNumber(out, priority); out += ',';
+        out += status; out += ',';
+        appendNumber(out, x); out += ',';
+        appendNumber(out, y); out += ',';
+        out += currentNode; out += ',';
+        appendNumber(out, timestamp); out += ',';
+        appendNumber(out, queuedAt);
+    }
+
     string toString() const
     {
-        stringstream ss;
-        ss << flightID << "," << model << "," << fuelLevel << ","
-            << origin << "," << destination << "," << priority << ","
-            << status << "," << x << "," << y << "," << currentNode << "," << timestamp;
-        return ss.str();
+        string out;
+        out.reserve(96);
+        appendTo(out);
+        return out;
     }
 
     static Aircraft fromString(const string& data)
@@ -158,409 +482,720 @@ struct Aircraft
         getline(ss, token, ','); a.x = stoi(token);
         getline(ss, token, ','); a.y = stoi(token);
         getline(ss, a.currentNode, ',');
-        getline(ss, token); a.timestamp = stol(token);
+        getline(ss, token, ','); a.timestamp = stol(token);
+        // queuedAt is missing from files written by older versions
+        if (getline(ss, token) && !token.empty()) a.queuedAt = stol(token);
 
         return a;
     }
 };
 
-// ===== HASH TABLE =====
-class HashNode
+// ===== DYNAMIC ARRAY =====
+// Growable array with amortized O(1) append (capacity doubles). Iterators
+// are plain pointers, valid until the next append that grows the array.
+template <typename T>
+class DynamicArray
 {
+private:
+    T* items;
+    int count;
+    int capacity;
+
+    void grow(int needed)
+    {
+        int newCapacity = (capacity == 0) ? 8 : capacity;
+        while (newCapacity < needed) newCapacity *= 2;
+        T* bigger = new T[newCapacity];
+        for (int i = 0; i < count; i++) bigger[i] = std::move(items[i]);
+        delete[] items;
+        items = bigger;
+        capacity = newCapacity;
+    }
+
 public:
-    string key;
-    Aircraft value;
-    HashNode* next;
+    typedef T* iterator;
 
-    HashNode(string k, Aircraft v) : key(k), value(v), next(NULL) {}
-};
+    DynamicArray() : items(NULL), count(0), capacity(0) {}
+    ~DynamicArray() { delete[] items; }
 
-class HashTable
-{
-private:
-    static const int TABLE_SIZE = 100;
-    HashNode* table[100];
-    int itemCount;
+    DynamicArray(const DynamicArray&) = delete;
+    DynamicArray& operator=(const DynamicArray&) = delete;
 
-    int hashFunction(string key)
+    void push(const T& item)
     {
-        int sum = 0;
-        for (size_t i = 0; i < key.length(); i++)
-            sum += (int)key[i];
-        return sum % TABLE_SIZE;
+        if (count == capacity) grow(count + 1);
+        items[count++] = item;
     }
 
-    void clearChain(HashNode* node)
+    void pop() { if (count > 0) count--; }
+
+    void reserve(int n) { if (n > capacity) grow(n); }
+
+    // Grows to n elements; new slots keep whatever an earlier use left there
+    void resize(int n)
     {
-        while (node != NULL) {
-            HashNode* temp = node;
-            node = node->next;
-            delete temp;
-        }
+        reserve(n);
+        count = n;
     }
 
+    // Keeps the memory for reuse
+    void clear() { count = 0; }
+
+    T& operator[](int i) { return items[i]; }
+    const T& operator[](int i) const { return items[i]; }
+    T& back() { return items[count - 1]; }
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    int getCapacity() const { return capacity; }
+
+    T* data() { return items; }
+    iterator begin() { return items; }
+    iterator end() { return items + count; }
+};
+
+// ===== BITSET =====
+int popcount64(unsigned long long word)
+{
+#ifdef _MSC_VER
+    return (int)(__popcnt((unsigned int)word) + __popcnt((unsigned int)(word >> 32)));
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+// Index of the lowest set bit; word must not be zero
+int lowestBit64(unsigned long long word)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    if (_BitScanForward(&index, (unsigned long)word)) return (int)index;
+    _BitScanForward(&index, (unsigned long)(word >> 32));
+    return (int)index + 32;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+// Dense bit array, 64 bits per word. Single-bit tests are one shift and
+// mask; counts and "any set" queries over ranges or against another bitset
+// go a word at a time.
+class Bitset
+{
+private:
+    unsigned long long* words;
+    int wordCount;
+    int bitCount;
+
+    static unsigned long long bitMask(int i) { return 1ULL << (i & 63); }
+
 public:
-    HashTable() : itemCount(0)
+    Bitset() : words(NULL), wordCount(0), bitCount(0) {}
+    ~Bitset() { delete[] words; }
+
+    Bitset(const Bitset&) = delete;
+    Bitset& operator=(const Bitset&) = delete;
+
+    // Grows to hold at least bits bits; new bits are clear
+    void resize(int bits)
     {
-        for (int i = 0; i < TABLE_SIZE; i++) table[i] = NULL;
+        if (bits > bitCount) bitCount = bits;
+        int needed = (bits + 63) / 64;
+        if (needed <= wordCount) return;
+        int newCount = (wordCount == 0) ? 1 : wordCount;
+        while (newCount < needed) newCount *= 2;
+        unsigned long long* bigger = new unsigned long long[newCount];
+        for (int w = 0; w < newCount; w++) bigger[w] = (w < wordCount) ? words[w] : 0;
+        delete[] words;
+        words = bigger;
+        wordCount = newCount;
     }
 
-    void insert(string key, Aircraft value)
+    void set(int i) { words[i >> 6] |= bitMask(i); }
+    void reset(int i) { words[i >> 6] &= ~bitMask(i); }
+    bool test(int i) const { return (words[i >> 6] & bitMask(i)) != 0; }
+
+    void clear()
     {
-        int index = hashFunction(key);
-        HashNode* newNode = new HashNode(key, value);
-        newNode->next = table[index];
-        table[index] = newNode;
-        itemCount++;
+        for (int w = 0; w < wordCount; w++) words[w] = 0;
     }
 
-    Aircraft* search(string key)
+    int size() const { return bitCount; }
+
+    int count() const
     {
-        int index = hashFunction(key);
-        HashNode* current = table[index];
-        while (current != NULL) {
-            if (current->key == key) return &(current->value);
-            current = current->next;
-        }
-        return NULL;
+        int total = 0;
+        for (int w = 0; w < wordCount; w++) total += popcount64(words[w]);
+        return total;
     }
 
-    bool update(string key, Aircraft newValue)
+    bool any() const
     {
-        Aircraft* found = search(key);
-        if (found != NULL) {
-            *found = newValue;
-            return true;
-        }
+        for (int w = 0; w < wordCount; w++)
+            if (words[w] != 0) return true;
         return false;
     }
 
-    bool remove(string key)
+    // Any bit set in [from, to)
+    bool anyInRange(int from, int to) const
     {
-        int index = hashFunction(key);
-        HashNode* current = table[index];
-        HashNode* prev = NULL;
+        if (to > wordCount * 64) to = wordCount * 64;
+        if (from >= to) return false;
+        int first = from >> 6, last = (to - 1) >> 6;
+        unsigned long long head = ~0ULL << (from & 63);
+        unsigned long long tail = ~0ULL >> (63 - ((to - 1) & 63));
+        if (first == last) return (words[first] & head & tail) != 0;
+        if (words[first] & head) return true;
+        for (int w = first + 1; w < last; w++)
+            if (words[w] != 0) return true;
+        return (words[last] & tail) != 0;
+    }
 
-        while (current != NULL) {
-            if (current->key == key) {
-                if (prev == NULL) table[index] = current->next;
-                else prev->next = current->next;
-                delete current;
-                itemCount--;
-                return true;
-            }
-            prev = current;
-            current = current->next;
-        }
-        return false;
+    // Bits set in both this and other
+    int countAnd(const Bitset& other) const
+    {
+        int n = (wordCount < other.wordCount) ? wordCount : other.wordCount;
+        int total = 0;
+        for (int w = 0; w < n; w++) total += popcount64(words[w] & other.words[w]);
+        return total;
     }
 
-    void saveToFile(string filename)
+    bool intersects(const Bitset& other) const
     {
-        ofstream file(filename);
-        if (!file.is_open()) throw FileOperationException(filename);
+        int n = (wordCount < other.wordCount) ? wordCount : other.wordCount;
+        for (int w = 0; w < n; w++)
+            if (words[w] & other.words[w]) return true;
+        return false;
+    }
 
-        file << itemCount << "\n";
-        for (int i = 0; i < TABLE_SIZE; i++) {
-            HashNode* current = table[i];
-            while (current != NULL) {
-                file << current->value.toString() << "\n";
-                current = current->next;
-            }
+    // First set bit at or after from, or -1
+    int nextSet(int from) const
+    {
+        if (from < 0) from = 0;
+        int w = from >> 6;
+        if (w >= wordCount) return -1;
+        unsigned long long word = words[w] & (~0ULL << (from & 63));
+        while (true) {
+            if (word != 0) return w * 64 + lowestBit64(word);
+            if (++w >= wordCount) return -1;
+            word = words[w];
         }
-        file.close();
     }
+};
 
-    void loadFromFile(string filename)
+// ===== NODE POOL =====
+// Typed slab allocator for the nodes of the linked structures. Objects are
+// bump-allocated out of slabs and recycled through a free list, so churn
+// reuses the same memory instead of going back to the heap. reset() rewinds
+// every slab in O(1) for arena-style clears. It does not run destructors,
+// so nodes that own memory (strings) must be discard()ed first.
+template <typename T>
+class NodePool
+{
+private:
+    struct FreeSlot { FreeSlot* next; };
+
+    static const size_t SLOT_SIZE =
+        ((sizeof(T) > sizeof(FreeSlot) ? sizeof(T) : sizeof(FreeSlot)) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+    char** slabs;
+    int* slabSlots;
+    int slabCount;
+    int slabCapacity;
+    int defaultSlabSlots;
+    int current;            // bump position: slab index and slots used in it
+    int used;
+    FreeSlot* freeList;
+
+    long allocations;
+    long frees;
+    int live;
+    int peak;
+    int freeSlots;
+    long resets;
+
+    // Makes slab `pos` a fresh slab of at least `slots` slots; slabs after
+    // the bump position are all unused, so one can be inserted there
+    void addSlab(int pos, int slots)
     {
-        ifstream file(filename);
-        if (!file.is_open()) throw FileOperationException(filename);
-
-        for (int i = 0; i < TABLE_SIZE; i++) {
-            clearChain(table[i]);
-            table[i] = NULL;
+        if (slabCount == slabCapacity) {
+            int newCapacity = slabCapacity * 2;
+            char** bigger = new char*[newCapacity];
+            int* biggerSlots = new int[newCapacity];
+            for (int i = 0; i < slabCount; i++) {
+                bigger[i] = slabs[i];
+                biggerSlots[i] = slabSlots[i];
+            }
+            delete[] slabs;
+            delete[] slabSlots;
+            slabs = bigger;
+            slabSlots = biggerSlots;
+            slabCapacity = newCapacity;
         }
-        itemCount = 0;
-
-        string line;
-        getline(file, line);
-        int count = stoi(line);
-
-        for (int i = 0; i < count; i++) {
-            getline(file, line);
-            if (line.empty()) continue;
-            Aircraft aircraft = Aircraft::fromString(line);
-            insert(aircraft.flightID, aircraft);
+        for (int i = slabCount; i > pos; i--) {
+            slabs[i] = slabs[i - 1];
+            slabSlots[i] = slabSlots[i - 1];
         }
-        file.close();
+        slabs[pos] = static_cast<char*>(::operator new(SLOT_SIZE * slots));
+        slabSlots[pos] = slots;
+        slabCount++;
     }
 
-    int getCount() { return itemCount; }
-
-    void getAllAircraft(Aircraft* arr, int& count)
+    void* take()
     {
-        count = 0;
-        for (int i = 0; i < TABLE_SIZE && count < 100; i++) {
-            HashNode* current = table[i];
-            while (current != NULL && count < 100) {
-                arr[count++] = current->value;
-                current = current->next;
-            }
+        if (freeList != NULL) {
+            FreeSlot* slot = freeList;
+            freeList = slot->next;
+            freeSlots--;
+            return slot;
+        }
+        if (current < slabCount && used == slabSlots[current]) {
+            current++;
+            used = 0;
         }
+        if (current == slabCount) addSlab(slabCount, defaultSlabSlots);
+        return slabs[current] + SLOT_SIZE * used++;
     }
 
-    ~HashTable()
+public:
+    NodePool(int slabSize = 256)
+        : slabCount(0), slabCapacity(4), defaultSlabSlots(slabSize), current(0), used(0), freeList(NULL),
+        allocations(0), frees(0), live(0), peak(0), freeSlots(0), resets(0)
     {
-        for (int i = 0; i < TABLE_SIZE; i++) clearChain(table[i]);
+        slabs = new char*[slabCapacity];
+        slabSlots = new int[slabCapacity];
     }
-};
 
-// ===== MINHEAP =====
-class MinHeap
-{
-private:
-    Aircraft* heap;
-    int capacity;
-    int size;
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
 
-    int parent(int i) { return (i - 1) / 2; }
-    int leftChild(int i) { return 2 * i + 1; }
-    int rightChild(int i) { return 2 * i + 2; }
+    // Releases the slabs; live objects must have been destroyed or discarded
+    ~NodePool()
+    {
+        for (int i = 0; i < slabCount; i++) ::operator delete(slabs[i]);
+        delete[] slabs;
+        delete[] slabSlots;
+    }
 
-    void swap(Aircraft& a, Aircraft& b)
+    template <typename... Args>
+    T* create(Args&&... args)
     {
-        Aircraft temp = a;
-        a = b;
-        b = temp;
+        void* memory = take();
+        T* object = new (memory) T(std::forward<Args>(args)...);
+        allocations++;
+        live++;
+        if (live > peak) peak = live;
+        return object;
     }
 
-    void heapifyUp(int index)
+    // Destroys object and puts its slot on the free list
+    void destroy(T* object)
     {
-        while (index > 0 && heap[parent(index)].priority > heap[index].priority) {
-            swap(heap[parent(index)], heap[index]);
-            index = parent(index);
-        }
+        object->~T();
+        FreeSlot* slot = reinterpret_cast<FreeSlot*>(object);
+        slot->next = freeList;
+        freeList = slot;
+        freeSlots++;
+        frees++;
+        live--;
     }
 
-    void heapifyDown(int index)
+    // Runs the destructor only; the slot comes back with the next reset()
+    void discard(T* object)
     {
-        int smallest = index;
-        int left = leftChild(index);
-        int right = rightChild(index);
+        object->~T();
+        frees++;
+        live--;
+    }
 
-        if (left < size && heap[left].priority < heap[smallest].priority) smallest = left;
-        if (right < size && heap[right].priority < heap[smallest].priority) smallest = right;
+    // Rewinds every slab; slabs are kept for reuse
+    void reset()
+    {
+        current = 0;
+        used = 0;
+        freeList = NULL;
+        freeSlots = 0;
+        live = 0;
+        resets++;
+    }
 
-        if (smallest != index) {
-            swap(heap[index], heap[smallest]);
-            heapifyDown(smallest);
+    // Guarantees the next n allocations (with an empty free list) are
+    // adjacent in memory, for bulk builds
+    void reserve(int n)
+    {
+        if (current < slabCount && slabSlots[current] - used >= n) return;
+        int pos = (current < slabCount && used > 0) ? current + 1 : current;
+        if (pos < slabCount && slabSlots[pos] >= n) {
+            current = pos;
+            used = 0;
+            return;
         }
+        addSlab(pos, n > defaultSlabSlots ? n : defaultSlabSlots);
+        current = pos;
+        used = 0;
     }
 
-public:
-    MinHeap(int cap = 100) : capacity(cap), size(0)
+    long getAllocations() { return allocations; }
+    long getFrees() { return frees; }
+    long getResets() { return resets; }
+    int getLive() { return live; }
+    int getPeak() { return peak; }
+    int getSlabCount() { return slabCount; }
+    int getFreeSlots() { return freeSlots; }
+
+    int getCapacity()
     {
-        heap = new Aircraft[capacity];
+        int total = 0;
+        for (int i = 0; i < slabCount; i++) total += slabSlots[i];
+        return total;
     }
 
-    ~MinHeap() { delete[] heap; }
-
-    void insert(Aircraft aircraft)
+    // Share of handed-out slots that sit freed on the free list
+    double getFragmentation()
     {
-        if (size >= capacity) throw HeapOverflowException();
-        heap[size] = aircraft;
-        heapifyUp(size);
-        size++;
+        return (live + freeSlots) ? (double)freeSlots / (live + freeSlots) : 0;
     }
+};
 
-    Aircraft extractMin()
+// ===== SCRATCH ARENA =====
+// Bump allocator for temporaries that live only for one operation or
+// simulation tick (path buffers, landing batches, formatted times). A
+// ScratchScope marks the arena on entry and rewinds it on exit, running
+// destructors for anything that needs them. Blocks are kept across
+// scopes, so once warmed up a scope allocates nothing from the heap.
+class ScratchArena
+{
+public:
+    class Mark
     {
-        if (size <= 0) throw EmptyQueueException();
-        Aircraft root = heap[0];
-        heap[0] = heap[size - 1];
-        size--;
-        heapifyDown(0);
-        return root;
+    public:
+        int block;
+        size_t top;
+        void* cleanups;
+    };
+
+private:
+    static const size_t BLOCK_SIZE = 64 * 1024;
+
+    struct Cleanup
+    {
+        void (*destroy)(void*, int);
+        void* objects;
+        int count;
+        Cleanup* prev;
+    };
+
+    char** blocks;
+    size_t* blockSizes;
+    int blockCount;
+    int blockCapacity;
+    int current;
+    size_t top;
+    Cleanup* cleanups;
+    long blockAllocations;
+
+    template <typename T>
+    static void destroyArray(void* objects, int count)
+    {
+        T* typed = static_cast<T*>(objects);
+        for (int i = 0; i < count; i++) typed[i].~T();
     }
 
-    void decreaseKey(string flightID, int newPriority)
+    // Inserts a block of at least `bytes` right after the current one;
+    // later blocks are unused until the arena moves past them
+    void insertBlock(int pos, size_t bytes)
     {
-        for (int i = 0; i < size; i++) {
-            if (heap[i].flightID == flightID) {
-                heap[i].priority = newPriority;
-                heapifyUp(i);
-                return;
+        if (blockCount == blockCapacity) {
+            int newCapacity = blockCapacity * 2;
+            char** bigger = new char*[newCapacity];
+            size_t* biggerSizes = new size_t[newCapacity];
+            for (int i = 0; i < blockCount; i++) {
+                bigger[i] = blocks[i];
+                biggerSizes[i] = blockSizes[i];
             }
+            delete[] blocks;
+            delete[] blockSizes;
+            blocks = bigger;
+            blockSizes = biggerSizes;
+            blockCapacity = newCapacity;
         }
-        throw FlightNotFoundException(flightID);
+        for (int i = blockCount; i > pos; i--) {
+            blocks[i] = blocks[i - 1];
+            blockSizes[i] = blockSizes[i - 1];
+        }
+        size_t size = (bytes > BLOCK_SIZE) ? bytes : BLOCK_SIZE;
+        blocks[pos] = static_cast<char*>(::operator new(size));
+        blockSizes[pos] = size;
+        blockCount++;
+        blockAllocations++;
     }
 
-    Aircraft peek()
+    void* take(size_t bytes, size_t align)
     {
-        if (size > 0) return heap[0];
-        throw EmptyQueueException();
+        size_t start = (top + align - 1) & ~(align - 1);
+        if (current < blockCount && start + bytes <= blockSizes[current]) {
+            top = start + bytes;
+            return blocks[current] + start;
+        }
+
+        // Move on to the next block, making room if it is missing or too small
+        int next = (current < blockCount) ? current + 1 : current;
+        if (next >= blockCount || blockSizes[next] < bytes) insertBlock(next, bytes);
+        current = next;
+        top = bytes;
+        return blocks[current];
     }
 
-    int getSize() { return size; }
+public:
+    ScratchArena() : blockCount(0), blockCapacity(4), current(0), top(0), cleanups(NULL), blockAllocations(0)
+    {
+        blocks = new char*[blockCapacity];
+        blockSizes = new size_t[blockCapacity];
+    }
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    ~ScratchArena()
+    {
+        Mark start = { 0, 0, NULL };
+        rewind(start);
+        for (int i = 0; i < blockCount; i++) ::operator delete(blocks[i]);
+        delete[] blocks;
+        delete[] blockSizes;
+    }
+
+    // count default-constructed objects, valid until the enclosing scope ends
+    template <typename T>
+    T* allocate(int count)
+    {
+        if (count < 1) count = 1;
+        T* objects = static_cast<T*>(take(sizeof(T) * count, alignof(T)));
+        for (int i = 0; i < count; i++) new (&objects[i]) T();
+
+        if (!std::is_trivially_destructible<T>::value) {
+            Cleanup* cleanup = static_cast<Cleanup*>(take(sizeof(Cleanup), alignof(Cleanup)));
+            cleanup->destroy = &destroyArray<T>;
+            cleanup->objects = objects;
+            cleanup->count = count;
+            cleanup->prev = cleanups;
+            cleanups = cleanup;
+        }
+        return objects;
+    }
+
+    Mark mark()
+    {
+        Mark m = { current, top, cleanups };
+        return m;
+    }
+
+    // Destroys everything allocated since m and rewinds to it
+    void rewind(const Mark& m)
+    {
+        while (cleanups != m.cleanups) {
+            cleanups->destroy(cleanups->objects, cleanups->count);
+            cleanups = cleanups->prev;
+        }
+        current = m.block;
+        top = m.top;
+    }
+
+    long getBlockAllocations() { return blockAllocations; }
+
+    size_t getCapacity()
+    {
+        size_t total = 0;
+        for (int i = 0; i < blockCount; i++) total += blockSizes[i];
+        return total;
+    }
 };
 
-// ===== AVL TREE =====
-class AVLNode
+// One arena per thread
+ScratchArena& scratchArena()
+{
+    static thread_local ScratchArena arena;
+    return arena;
+}
+
+// Everything taken from the scratch arena while a ScratchScope is alive is
+// released when it goes out of scope
+class ScratchScope
 {
+private:
+    ScratchArena& arena;
+    ScratchArena::Mark saved;
+
 public:
-    Aircraft data;
-    AVLNode* left;
-    AVLNode* right;
-    int height;
+    ScratchScope() : arena(scratchArena()), saved(arena.mark()) {}
+    ~ScratchScope() { arena.rewind(saved); }
 
-    AVLNode(Aircraft d) : data(d), left(NULL), right(NULL), height(1) {}
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
 };
 
-class AVLTree
+// ===== HASH TABLE =====
+class HashNode
 {
-private:
-    AVLNode* root;
-    int nodeCount;
+public:
+    string key;
+    Aircraft value;
+    HashNode* next;
 
-    int height(AVLNode* node) { return node ? node->height : 0; }
-    int getBalance(AVLNode* node) { return node ? height(node->left) - height(node->right) : 0; }
-    int maxVal(int a, int b) { return (a > b) ? a : b; }
+    HashNode(string k, Aircraft v) : key(k), value(v), next(NULL) {}
+};
 
-    AVLNode* rightRotate(AVLNode* y)
+// Separate chaining over a power-of-two bucket array. The table doubles
+// and rehashes once it holds more entries than buckets, so chains stay O(1)
+// long however many aircraft are registered.
+class HashTable
+{
+private:
+    static const int INITIAL_BUCKETS = 128;
+    HashNode** table;
+    int tableSize;
+    int itemCount;
+    NodePool<HashNode> pool;
+
+    int hashFunction(const string& key)
     {
-        AVLNode* x = y->left;
-        AVLNode* T2 = x->right;
-        x->right = y;
-        y->left = T2;
-        y->height = maxVal(height(y->left), height(y->right)) + 1;
-        x->height = maxVal(height(x->left), height(x->right)) + 1;
-        return x;
+        return (int)(hashString(key) & (unsigned int)(tableSize - 1));
     }
 
-    AVLNode* leftRotate(AVLNode* x)
+    // Relinks every node into a table of newSize buckets; nodes do not move
+    void rehash(int newSize)
     {
-        AVLNode* y = x->right;
-        AVLNode* T2 = y->left;
-        y->left = x;
-        x->right = T2;
-        x->height = maxVal(height(x->left), height(x->right)) + 1;
-        y->height = maxVal(height(y->left), height(y->right)) + 1;
-        return y;
+        HashNode** bigger = new HashNode*[newSize];
+        for (int i = 0; i < newSize; i++) bigger[i] = NULL;
+        for (int i = 0; i < tableSize; i++) {
+            HashNode* current = table[i];
+            while (current != NULL) {
+                HashNode* next = current->next;
+                int index = (int)(hashString(current->key) & (unsigned int)(newSize - 1));
+                current->next = bigger[index];
+                bigger[index] = current;
+                current = next;
+            }
+        }
+        delete[] table;
+        table = bigger;
+        tableSize = newSize;
     }
 
-    AVLNode* insertNode(AVLNode* node, Aircraft data)
+    void clearChain(HashNode* node)
     {
-        if (node == NULL) {
-            nodeCount++;
-            return new AVLNode(data);
+        while (node != NULL) {
+            HashNode* temp = node;
+            node = node->next;
+            pool.discard(temp);
         }
+    }
 
-        if (data.timestamp < node->data.timestamp)
-            node->left = insertNode(node->left, data);
-        else
-            node->right = insertNode(node->right, data);
-
-        node->height = 1 + maxVal(height(node->left), height(node->right));
-
-        int balance = getBalance(node);
+public:
+    // Walks every registered aircraft, bucket by bucket
+    class Iterator
+    {
+    private:
+        HashTable* owner;
+        int bucket;
+        HashNode* node;
+
+        void skipEmpty()
+        {
+            while (node == NULL && ++bucket < owner->tableSize) node = owner->table[bucket];
+        }
 
-        if (balance > 1 && data.timestamp < node->left->data.timestamp)
-            return rightRotate(node);
+    public:
+        Iterator(HashTable* table, int start) : owner(table), bucket(start), node(NULL)
+        {
+            if (bucket < owner->tableSize) {
+                node = owner->table[bucket];
+                skipEmpty();
+            }
+        }
 
-        if (balance < -1 && data.timestamp >= node->right->data.timestamp)
-            return leftRotate(node);
+        Aircraft& operator*() { return node->value; }
+        Aircraft* operator->() { return &node->value; }
 
-        if (balance > 1 && data.timestamp >= node->left->data.timestamp) {
-            node->left = leftRotate(node->left);
-            return rightRotate(node);
+        Iterator& operator++()
+        {
+            node = node->next;
+            skipEmpty();
+            return *this;
         }
 
-        if (balance < -1 && data.timestamp < node->right->data.timestamp) {
-            node->right = rightRotate(node->right);
-            return leftRotate(node);
-        }
+        bool operator==(const Iterator& other) const { return node == other.node; }
+        bool operator!=(const Iterator& other) const { return node != other.node; }
+    };
 
-        return node;
+    HashTable() : tableSize(INITIAL_BUCKETS), itemCount(0)
+    {
+        table = new HashNode*[tableSize];
+        for (int i = 0; i < tableSize; i++) table[i] = NULL;
     }
 
-    void inOrderTraversal(AVLNode* node)
-    {
-        if (node != NULL) {
-            inOrderTraversal(node->left);
-            setColor(COLOR_INFO);
-            cout << "  [";
+    HashTable(const HashTable&) = delete;
+    HashTable& operator=(const HashTable&) = delete;
 
-            // Convert timestamp to readable format
-            time_t rawtime = (time_t)node->data.timestamp;
-            struct tm timeinfo;
-            localtime_s(&timeinfo, &rawtime);
-            char buffer[80];
-            strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &timeinfo);
+    Iterator begin() { return Iterator(this, 0); }
+    Iterator end() { return Iterator(this, tableSize); }
 
-            cout << buffer << "] ";
-            setColor(MENU);
-            cout << node->data.flightID;
-            setColor(COLOR_SUBTITLE);
-            cout << " -> ";
-            if (node->data.status == "Landed") setColor(COLOR_SUCCESS);
-            else setColor(COLOR_WARNING);
-            cout << node->data.status;
-            setColor(COLOR_RESET);
-            cout << endl;
-            inOrderTraversal(node->right);
-        }
+    void insert(string key, Aircraft value)
+    {
+        if (itemCount >= tableSize) rehash(tableSize * 2);
+        int index = hashFunction(key);
+        HashNode* newNode = pool.create(key, value);
+        newNode->next = table[index];
+        table[index] = newNode;
+        itemCount++;
     }
 
-    void clearTree(AVLNode* node)
+    // NULL when the key is absent; never throws
+    Aircraft* search(const string& key)
     {
-        if (node != NULL) {
-            clearTree(node->left);
-            clearTree(node->right);
-            delete node;
+        int index = hashFunction(key);
+        HashNode* current = table[index];
+        while (current != NULL) {
+            if (current->key == key) return &(current->value);
+            current = current->next;
         }
+        return NULL;
     }
 
-    void storeInOrder(AVLNode* node, Aircraft* flights, int& index)
+    AtcStatus trySearch(const string& key, Aircraft*& found)
     {
-        if (node != NULL) {
-            storeInOrder(node->left, flights, index);
-            flights[index++] = node->data;
-            storeInOrder(node->right, flights, index);
-        }
+        found = search(key);
+        return (found != NULL) ? ATC_OK : ATC_NOT_FOUND;
     }
 
-public:
-    AVLTree() : root(NULL), nodeCount(0) {}
-
-    ~AVLTree() { clearTree(root); }
-
-    void insert(Aircraft data)
+    bool update(string key, Aircraft newValue)
     {
-        root = insertNode(root, data);
+        Aircraft* found = search(key);
+        if (found != NULL) {
+            *found = newValue;
+            return true;
+        }
+        return false;
     }
 
-    void printLog()
+    bool remove(string key)
     {
-        setColor(COLOR_HEADER);
-        cout << "\n|||===========================================================|||\n";
-        cout << "|||           FLIGHT LOG (Chronological Order)                |||\n";
-        cout << "|||===========================================================|||\n";
-        setColor(COLOR_RESET);
+        int index = hashFunction(key);
+        HashNode* current = table[index];
+        HashNode* prev = NULL;
 
-        if (root == NULL) {
-            setColor(COLOR_WARNING);
-            cout << "\n  No flights recorded yet.\n";
-            setColor(COLOR_RESET);
-        }
-        else {
-            inOrderTraversal(root);
+        while (current != NULL) {
+            if (current->key == key) {
+                if (prev == NULL) table[index] = current->next;
+                else prev->next = current->next;
+                pool.destroy(current);
+                itemCount--;
+                return true;
+            }
+            prev = current;
+            current = current->next;
         }
-
-        setColor(COLOR_SUBTITLE);
-        cout << "\n  Total Flights Logged: ";
-        setColor(COLOR_INFO);
-        cout << nodeCount << endl;
-        setColor(COLOR_RESET);
+        return false;
     }
 
     void saveToFile(string filename)
@@ -568,17 +1203,17 @@ public:
         ofstream file(filename);
         if (!file.is_open()) throw FileOperationException(filename);
 
-        file << nodeCount << "\n";
-
-        if (nodeCount > 0) {
-            Aircraft* flights = new Aircraft[nodeCount];
-            int index = 0;
-            storeInOrder(root, flights, index);
-
-            for (int i = 0; i < nodeCount; i++)
-                file << flights[i].toString() << "\n";
-
-            delete[] flights;
+        file << itemCount << "\n";
+        string line;
+        for (int i = 0; i < tableSize; i++) {
+            HashNode* current = table[i];
+            while (current != NULL) {
+                line.clear();
+                current->value.appendTo(line);
+                line += '\n';
+                file << line;
+                current = current->next;
+            }
         }
         file.close();
     }
@@ -588,395 +1223,8175 @@ public:
         ifstream file(filename);
         if (!file.is_open()) throw FileOperationException(filename);
 
-        clearTree(root);
-        root = NULL;
-        nodeCount = 0;
+        for (int i = 0; i < tableSize; i++) {
+            clearChain(table[i]);
+            table[i] = NULL;
+        }
+        pool.reset();
+        itemCount = 0;
 
         string line;
         getline(file, line);
         int count = stoi(line);
 
+        // Size the table and the pool once for the whole file
+        int buckets = tableSize;
+        while (buckets < count) buckets *= 2;
+        if (buckets != tableSize) {
+            delete[] table;
+            table = new HashNode*[buckets];
+            for (int i = 0; i < buckets; i++) table[i] = NULL;
+            tableSize = buckets;
+        }
+        pool.reserve(count);
+
         for (int i = 0; i < count; i++) {
             getline(file, line);
             if (line.empty()) continue;
             Aircraft aircraft = Aircraft::fromString(line);
-            insert(aircraft);
+            insert(aircraft.flightID, aircraft);
         }
         file.close();
     }
 
-    int getCount() { return nodeCount; }
-};
+    int getCount() { return itemCount; }
+    int getBucketCount() { return tableSize; }
+    NodePool<HashNode>& getNodePool() { return pool; }
 
-// ===== GRAPH =====
-class GraphNode
-{
-public:
-    string name;
-    int x;
-    int y;
-    bool isAirport;
-    bool occupied;
-    string occupiedBy;
+    // Calls visit(Aircraft&) for every registered aircraft
+    template <typename Visitor>
+    void forEach(Visitor& visit)
+    {
+        for (Iterator it = begin(); it != end(); ++it) visit(*it);
+    }
 
-    GraphNode(string n, int px, int py, bool airport = false)
-        : name(n), x(px), y(py), isAirport(airport), occupied(false) {
+    ~HashTable()
+    {
+        for (int i = 0; i < tableSize; i++) clearChain(table[i]);
+        delete[] table;
     }
 };
 
-class Edge
+// ===== LANDING ORDER =====
+// Waiting flights age: effective priority = priority - wait / LANDING_AGING_SECONDS,
+// never better than HIGH. CRITICAL flights always go first. For everything
+// else, comparing effective priorities at any moment gives the same answer
+// as comparing priority * LANDING_AGING_SECONDS + queuedAt, which does not
+// change over time. The queues therefore never need re-sorting as flights age.
+const long LANDING_AGING_SECONDS = 900;
+
+long agedKey(const Aircraft& a)
 {
-public:
-    string destination;
-    int weight;
-    Edge* next;
+    return (long)a.priority * LANDING_AGING_SECONDS + a.queuedAt;
+}
 
-    Edge(string dest, int w) : destination(dest), weight(w), next(NULL) {}
-};
+bool landsBefore(const Aircraft& a, const Aircraft& b)
+{
+    bool aCritical = (a.priority <= 1);
+    bool bCritical = (b.priority <= 1);
+    if (aCritical != bCritical) return aCritical;
+    if (aCritical) return a.queuedAt < b.queuedAt;
+    return agedKey(a) < agedKey(b);
+}
 
-class Graph
+int effectivePriority(const Aircraft& a, long now)
+{
+    if (a.priority <= 2 || now <= a.queuedAt) return a.priority;
+    int aged = a.priority - (int)((now - a.queuedAt) / LANDING_AGING_SECONDS);
+    return (aged < 2) ? 2 : aged;
+}
+
+// ===== MINHEAP =====
+class MinHeap
 {
 private:
-    static const int MAX_NODES = 50;
-    GraphNode* nodes[50];
-    Edge* adjList[50];
-    int nodeCount;
+    Aircraft* heap;
+    int capacity;
+    int size;
 
-    int findNodeIndex(string name)
-    {
-        for (int i = 0; i < nodeCount; i++)
-            if (nodes[i]->name == name) return i;
-        return -1;
-    }
+    int parent(int i) { return (i - 1) / 2; }
+    int leftChild(int i) { return 2 * i + 1; }
+    int rightChild(int i) { return 2 * i + 2; }
+
+    void swap(Aircraft& a, Aircraft& b)
+    {
+        Aircraft temp = a;
+        a = b;
+        b = temp;
+    }
+
+    void heapifyUp(int index)
+    {
+        while (index > 0 && landsBefore(heap[index], heap[parent(index)])) {
+            swap(heap[parent(index)], heap[index]);
+            index = parent(index);
+        }
+    }
+
+    void heapifyDown(int index)
+    {
+        int smallest = index;
+        int left = leftChild(index);
+        int right = rightChild(index);
+
+        if (left < size && landsBefore(heap[left], heap[smallest])) smallest = left;
+        if (right < size && landsBefore(heap[right], heap[smallest])) smallest = right;
+
+        if (smallest != index) {
+            swap(heap[index], heap[smallest]);
+            heapifyDown(smallest);
+        }
+    }
+
+    // Doubles the array; amortized O(1) per insert
+    void grow()
+    {
+        Aircraft* bigger = new Aircraft[capacity * 2];
+        for (int i = 0; i < size; i++) bigger[i] = std::move(heap[i]);
+        delete[] heap;
+        heap = bigger;
+        capacity *= 2;
+    }
+
+public:
+    MinHeap(int cap = 100) : capacity(cap < 1 ? 1 : cap), size(0)
+    {
+        heap = new Aircraft[capacity];
+    }
+
+    ~MinHeap() { delete[] heap; }
+
+    MinHeap(const MinHeap&) = delete;
+    MinHeap& operator=(const MinHeap&) = delete;
+
+    void insert(Aircraft aircraft)
+    {
+        if (size >= capacity) grow();
+        heap[size] = aircraft;
+        heapifyUp(size);
+        size++;
+    }
+
+    AtcStatus tryExtractMin(Aircraft& out)
+    {
+        if (size <= 0) return ATC_EMPTY;
+        out = heap[0];
+        size--;
+        if (size > 0) {
+            swap(heap[0], heap[size]);
+            heapifyDown(0);
+        }
+        return ATC_OK;
+    }
+
+    Aircraft extractMin()
+    {
+        Aircraft root;
+        if (tryExtractMin(root) != ATC_OK) throw EmptyQueueException();
+        return root;
+    }
+
+    // Replaces the contents with arr and heapifies bottom-up in O(n)
+    void build(Aircraft* arr, int count)
+    {
+        if (count > capacity) {
+            delete[] heap;
+            capacity = count;
+            heap = new Aircraft[capacity];
+        }
+        for (int i = 0; i < count; i++) heap[i] = arr[i];
+        size = count;
+        for (int i = size / 2 - 1; i >= 0; i--) heapifyDown(i);
+    }
+
+    // Removes up to k aircraft in landing order; returns how many were written
+    int extractTopK(Aircraft* out, int k)
+    {
+        int count = 0;
+        while (count < k && tryExtractMin(out[count]) == ATC_OK) count++;
+        return count;
+    }
+
+    AtcStatus tryDecreaseKey(const string& flightID, int newPriority)
+    {
+        for (int i = 0; i < size; i++) {
+            if (heap[i].flightID == flightID) {
+                heap[i].priority = newPriority;
+                heapifyUp(i);
+                heapifyDown(i);
+                return ATC_OK;
+            }
+        }
+        return ATC_NOT_FOUND;
+    }
+
+    void decreaseKey(string flightID, int newPriority)
+    {
+        if (tryDecreaseKey(flightID, newPriority) != ATC_OK) throw FlightNotFoundException(flightID);
+    }
+
+    AtcStatus tryPeek(Aircraft& out)
+    {
+        if (size <= 0) return ATC_EMPTY;
+        out = heap[0];
+        return ATC_OK;
+    }
+
+    // The flight that lands first, NULL if empty; valid until the queue changes
+    const Aircraft* top() { return size > 0 ? &heap[0] : NULL; }
+
+    Aircraft peek()
+    {
+        Aircraft top;
+        if (tryPeek(top) != ATC_OK) throw EmptyQueueException();
+        return top;
+    }
+
+    bool contains(string flightID)
+    {
+        for (int i = 0; i < size; i++)
+            if (heap[i].flightID == flightID) return true;
+        return false;
+    }
+
+    bool remove(string flightID)
+    {
+        for (int i = 0; i < size; i++) {
+            if (heap[i].flightID == flightID) {
+                heap[i] = heap[size - 1];
+                size--;
+                if (i < size) {
+                    heapifyDown(i);
+                    heapifyUp(i);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Copies the queued aircraft (in heap order) into arr
+    void getAll(Aircraft* arr, int& count)
+    {
+        count = 0;
+        for (int i = 0; i < size; i++) arr[count++] = heap[i];
+    }
+
+    int getSize() { return size; }
+
+    void clear() { size = 0; }
+};
+
+// ===== BUCKET QUEUE =====
+// Alternative landing queue: one FIFO per priority level plus a bitmask of
+// non-empty levels. Same interface as MinHeap; equal priorities land
+// first-come-first-served. A flight queued no earlier than its level's tail
+// (the usual case) is appended in O(1). One that would land ahead of newer
+// flights (a re-prioritized flight keeps its older queuedAt) goes to the
+// level's small heap of late entries instead, O(log late). A level's most
+// aged flight is the earlier of its FIFO head and its heap top, and aging is
+// resolved lazily by comparing just those.
+class BucketNode
+{
+public:
+    Aircraft data;
+    int prev;
+    int next;
+    int hashNext;
+    int level;
+    int heapSlot;       // position in the level's late heap, -1 while in the FIFO
+
+    BucketNode() : prev(-1), next(-1), hashNext(-1), level(-1), heapSlot(-1) {}
+};
+
+class BucketQueue
+{
+private:
+    static const int LEVELS = 4;
+
+    BucketNode* nodes;
+    int capacity;
+    int freeHead;
+    int size;
+
+    int head[LEVELS];
+    int tail[LEVELS];
+    DynamicArray<int> late[LEVELS];     // min-heaps by queuedAt
+    unsigned int nonEmpty;
+
+    // flightID -> node index, chained through BucketNode::hashNext
+    int* index;
+    int indexSize;
+
+    static int firstLevel(unsigned int mask)
+    {
+        static const int lowestBit[16] = { -1, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0 };
+        return lowestBit[mask & 15];
+    }
+
+    static int levelOf(int priority)
+    {
+        if (priority < 1) return 0;
+        if (priority > LEVELS) return LEVELS - 1;
+        return priority - 1;
+    }
+
+    int bucketOf(const string& flightID) { return (int)(hashString(flightID) & (unsigned int)(indexSize - 1)); }
+
+    void buildFreeList(int from)
+    {
+        for (int i = from; i < capacity - 1; i++) nodes[i].next = i + 1;
+        nodes[capacity - 1].next = -1;
+        freeHead = from;
+    }
+
+    void rebuildIndex()
+    {
+        for (int i = 0; i < indexSize; i++) index[i] = -1;
+        for (int i = 0; i < capacity; i++) {
+            if (nodes[i].level == -1) continue;
+            int b = bucketOf(nodes[i].data.flightID);
+            nodes[i].hashNext = index[b];
+            index[b] = i;
+        }
+    }
+
+    bool queuedEarlier(int a, int b) { return nodes[a].data.queuedAt < nodes[b].data.queuedAt; }
+
+    void placeLate(int level, int slot, int i)
+    {
+        late[level][slot] = i;
+        nodes[i].heapSlot = slot;
+    }
+
+    void siftLateUp(int level, int slot)
+    {
+        DynamicArray<int>& heap = late[level];
+        int i = heap[slot];
+        while (slot > 0 && queuedEarlier(i, heap[(slot - 1) / 2])) {
+            placeLate(level, slot, heap[(slot - 1) / 2]);
+            slot = (slot - 1) / 2;
+        }
+        placeLate(level, slot, i);
+    }
+
+    void siftLateDown(int level, int slot)
+    {
+        DynamicArray<int>& heap = late[level];
+        int i = heap[slot];
+        while (true) {
+            int child = slot * 2 + 1;
+            if (child >= heap.size()) break;
+            if (child + 1 < heap.size() && queuedEarlier(heap[child + 1], heap[child])) child++;
+            if (!queuedEarlier(heap[child], i)) break;
+            placeLate(level, slot, heap[child]);
+            slot = child;
+        }
+        placeLate(level, slot, i);
+    }
+
+    // Most aged flight of a level, -1 if it is empty
+    int levelHead(int level)
+    {
+        int first = head[level];
+        if (late[level].empty()) return first;
+        int top = late[level][0];
+        return (first == -1 || queuedEarlier(top, first)) ? top : first;
+    }
+
+    void grow()
+    {
+        int newCapacity = capacity * 2;
+        BucketNode* bigger = new BucketNode[newCapacity];
+        for (int i = 0; i < capacity; i++) bigger[i] = nodes[i];
+        delete[] nodes;
+        nodes = bigger;
+
+        int oldCapacity = capacity;
+        capacity = newCapacity;
+        buildFreeList(oldCapacity);
+
+        if (indexSize < capacity) {
+            delete[] index;
+            while (indexSize < capacity) indexSize *= 2;
+            index = new int[indexSize];
+            rebuildIndex();
+        }
+    }
+
+    // Appends node i to its level's FIFO when that keeps it in queuedAt
+    // order, O(1); otherwise pushes it on the level's late heap, O(log late)
+    void linkOrdered(int i, int level)
+    {
+        nodes[i].level = level;
+        nonEmpty |= (1u << level);
+        int last = tail[level];
+        if (last != -1 && queuedEarlier(i, last)) {
+            nodes[i].prev = nodes[i].next = -1;
+            late[level].push(i);
+            siftLateUp(level, late[level].size() - 1);
+            return;
+        }
+        nodes[i].heapSlot = -1;
+        nodes[i].prev = last;
+        nodes[i].next = -1;
+        if (last != -1) nodes[last].next = i;
+        else head[level] = i;
+        tail[level] = i;
+    }
+
+    // Bottom-up merge sort of one level's list by queuedAt
+    void sortLevel(int level)
+    {
+        int length = 0;
+        for (int i = head[level]; i != -1; i = nodes[i].next) length++;
+
+        for (int width = 1; width < length; width *= 2) {
+            int merged = -1;
+            int mergedTail = -1;
+            int rest = head[level];
+            while (rest != -1) {
+                int left = rest;
+                int right = left;
+                for (int s = 0; s < width && right != -1; s++) right = nodes[right].next;
+                int leftCount = width;
+                int rightCount = width;
+
+                while ((leftCount > 0 && left != right) || (rightCount > 0 && right != -1)) {
+                    int take;
+                    bool leftOpen = (leftCount > 0 && left != right);
+                    bool rightOpen = (rightCount > 0 && right != -1);
+                    if (leftOpen && (!rightOpen || nodes[left].data.queuedAt <= nodes[right].data.queuedAt)) {
+                        take = left;
+                        left = nodes[left].next;
+                        leftCount--;
+                    }
+                    else {
+                        take = right;
+                        right = nodes[right].next;
+                        rightCount--;
+                    }
+                    nodes[take].prev = mergedTail;
+                    if (mergedTail != -1) nodes[mergedTail].next = take;
+                    else merged = take;
+                    mergedTail = take;
+                }
+                rest = right;
+            }
+            nodes[mergedTail].next = -1;
+            head[level] = merged;
+            tail[level] = mergedTail;
+        }
+    }
+
+    // Head that lands first once aging is taken into account
+    int topNode()
+    {
+        int first = firstLevel(nonEmpty);
+        if (first <= 0) return levelHead(0);
+
+        int best = levelHead(first);
+        for (int level = first + 1; level < LEVELS; level++) {
+            int candidate = levelHead(level);
+            if (candidate != -1 && landsBefore(nodes[candidate].data, nodes[best].data))
+                best = candidate;
+        }
+        return best;
+    }
+
+    void unlink(int i)
+    {
+        int level = nodes[i].level;
+        int slot = nodes[i].heapSlot;
+        if (slot != -1) {
+            DynamicArray<int>& heap = late[level];
+            int moved = heap.back();
+            heap.pop();
+            nodes[i].heapSlot = -1;
+            if (moved != i) {
+                placeLate(level, slot, moved);
+                siftLateDown(level, slot);
+                siftLateUp(level, nodes[moved].heapSlot);
+            }
+        }
+        else {
+            if (nodes[i].prev != -1) nodes[nodes[i].prev].next = nodes[i].next;
+            else head[level] = nodes[i].next;
+            if (nodes[i].next != -1) nodes[nodes[i].next].prev = nodes[i].prev;
+            else tail[level] = nodes[i].prev;
+        }
+        nodes[i].level = -1;
+        if (head[level] == -1 && late[level].empty()) nonEmpty &= ~(1u << level);
+    }
+
+    int findNode(const string& flightID)
+    {
+        for (int i = index[bucketOf(flightID)]; i != -1; i = nodes[i].hashNext)
+            if (nodes[i].data.flightID == flightID) return i;
+        return -1;
+    }
+
+    void unindex(int i)
+    {
+        int b = bucketOf(nodes[i].data.flightID);
+        if (index[b] == i) {
+            index[b] = nodes[i].hashNext;
+            return;
+        }
+        for (int j = index[b]; j != -1; j = nodes[j].hashNext) {
+            if (nodes[j].hashNext == i) {
+                nodes[j].hashNext = nodes[i].hashNext;
+                return;
+            }
+        }
+    }
+
+public:
+    BucketQueue(int cap = 100) : capacity(cap < 1 ? 1 : cap), size(0), nonEmpty(0), indexSize(1)
+    {
+        nodes = new BucketNode[capacity];
+        buildFreeList(0);
+        for (int level = 0; level < LEVELS; level++) head[level] = tail[level] = -1;
+        while (indexSize < capacity) indexSize *= 2;
+        index = new int[indexSize];
+        for (int i = 0; i < indexSize; i++) index[i] = -1;
+    }
+
+    BucketQueue(const BucketQueue&) = delete;
+    BucketQueue& operator=(const BucketQueue&) = delete;
+
+    ~BucketQueue()
+    {
+        delete[] nodes;
+        delete[] index;
+    }
+
+    void insert(Aircraft aircraft)
+    {
+        if (freeHead == -1) grow();
+        int i = freeHead;
+        freeHead = nodes[i].next;
+
+        nodes[i].data = aircraft;
+        linkOrdered(i, levelOf(aircraft.priority));
+
+        int b = bucketOf(aircraft.flightID);
+        nodes[i].hashNext = index[b];
+        index[b] = i;
+        size++;
+    }
+
+    AtcStatus tryExtractMin(Aircraft& out)
+    {
+        if (size <= 0) return ATC_EMPTY;
+        int i = topNode();
+        out = nodes[i].data;
+
+        unlink(i);
+        unindex(i);
+        nodes[i].next = freeHead;
+        freeHead = i;
+        size--;
+        return ATC_OK;
+    }
+
+    Aircraft extractMin()
+    {
+        Aircraft root;
+        if (tryExtractMin(root) != ATC_OK) throw EmptyQueueException();
+        return root;
+    }
+
+    // Replaces the contents with arr. Each flight is appended to its level in
+    // O(1); only a level whose input was not in queuedAt order gets sorted.
+    void build(Aircraft* arr, int count)
+    {
+        while (capacity < count) grow();
+        clear();
+
+        for (int c = 0; c < count; c++) {
+            int i = freeHead;
+            freeHead = nodes[i].next;
+            nodes[i].data = arr[c];
+
+            int level = levelOf(arr[c].priority);
+            nodes[i].level = level;
+            nodes[i].heapSlot = -1;
+            nodes[i].next = -1;
+            nodes[i].prev = tail[level];
+            if (tail[level] != -1) nodes[tail[level]].next = i;
+            else head[level] = i;
+            tail[level] = i;
+            nonEmpty |= (1u << level);
+
+            int b = bucketOf(arr[c].flightID);
+            nodes[i].hashNext = index[b];
+            index[b] = i;
+        }
+        size = count;
+
+        for (int level = 0; level < LEVELS; level++) {
+            bool ordered = true;
+            for (int i = head[level]; i != -1 && nodes[i].next != -1 && ordered; i = nodes[i].next)
+                ordered = (nodes[i].data.queuedAt <= nodes[nodes[i].next].data.queuedAt);
+            if (!ordered) sortLevel(level);
+        }
+    }
+
+    // Removes up to k aircraft in landing order; returns how many were written
+    int extractTopK(Aircraft* out, int k)
+    {
+        int count = 0;
+        while (count < k && tryExtractMin(out[count]) == ATC_OK) count++;
+        return count;
+    }
+
+    // Re-prioritize; the flight keeps the wait time it has already built up
+    AtcStatus tryDecreaseKey(const string& flightID, int newPriority)
+    {
+        int i = findNode(flightID);
+        if (i == -1) return ATC_NOT_FOUND;
+
+        unlink(i);
+        nodes[i].data.priority = newPriority;
+        linkOrdered(i, levelOf(newPriority));
+        return ATC_OK;
+    }
+
+    void decreaseKey(string flightID, int newPriority)
+    {
+        if (tryDecreaseKey(flightID, newPriority) != ATC_OK) throw FlightNotFoundException(flightID);
+    }
+
+    AtcStatus tryPeek(Aircraft& out)
+    {
+        if (size <= 0) return ATC_EMPTY;
+        out = nodes[topNode()].data;
+        return ATC_OK;
+    }
+
+    // The flight that lands first, NULL if empty; valid until the queue changes
+    const Aircraft* top() { return size > 0 ? &nodes[topNode()].data : NULL; }
+
+    Aircraft peek()
+    {
+        Aircraft top;
+        if (tryPeek(top) != ATC_OK) throw EmptyQueueException();
+        return top;
+    }
+
+    bool contains(string flightID) { return findNode(flightID) != -1; }
+
+    bool remove(string flightID)
+    {
+        int i = findNode(flightID);
+        if (i == -1) return false;
+
+        unlink(i);
+        unindex(i);
+        nodes[i].next = freeHead;
+        freeHead = i;
+        size--;
+        return true;
+    }
+
+    // Copies the queued aircraft into arr in landing order
+    void getAll(Aircraft* arr, int& count)
+    {
+        count = 0;
+        DynamicArray<int> pending;
+        for (int level = 0; level < LEVELS; level++) {
+            // merge the FIFO with the late entries, popped from a copy of the heap
+            pending.clear();
+            for (int k = 0; k < late[level].size(); k++) pending.push(late[level][k]);
+            int i = head[level];
+            while (i != -1 || !pending.empty()) {
+                if (i != -1 && (pending.empty() || !queuedEarlier(pending[0], i))) {
+                    arr[count++] = nodes[i].data;
+                    i = nodes[i].next;
+                    continue;
+                }
+                arr[count++] = nodes[pending[0]].data;
+                int moved = pending.back();
+                pending.pop();
+                int slot = 0;
+                while (slot * 2 + 1 < pending.size()) {
+                    int child = slot * 2 + 1;
+                    if (child + 1 < pending.size() && queuedEarlier(pending[child + 1], pending[child])) child++;
+                    if (!queuedEarlier(pending[child], moved)) break;
+                    pending[slot] = pending[child];
+                    slot = child;
+                }
+                if (!pending.empty()) pending[slot] = moved;
+            }
+        }
+    }
+
+    int getSize() { return size; }
+
+    void clear()
+    {
+        for (int level = 0; level < LEVELS; level++) {
+            head[level] = tail[level] = -1;
+            late[level].clear();
+        }
+        for (int i = 0; i < capacity; i++) {
+            nodes[i].level = -1;
+            nodes[i].heapSlot = -1;
+        }
+        for (int i = 0; i < indexSize; i++) index[i] = -1;
+        nonEmpty = 0;
+        size = 0;
+        buildFreeList(0);
+    }
+};
+
+// Landing queue engine used by SkyNetATC; swap to MinHeap to compare the two
+typedef BucketQueue LandingQueue;
+
+// ===== ARRIVAL MANAGER =====
+// Computes a landing sequence and runway slot times for one airport that
+// minimizes weighted delay plus a penalty for landing past the fuel deadline.
+// Starts from first-come order by ETA, then improves it with a bounded local
+// search in which no flight moves more than MAX_SHIFT places from that order
+// (constrained position shifting).
+class ArrivalCandidate
+{
+public:
+    long eta;           // earliest time the flight can reach the runway
+    long fuelDeadline;  // latest time it can land before eating into reserve fuel
+    int weight;         // cost of one second of delay, from its priority class
+
+    ArrivalCandidate() : eta(0), fuelDeadline(0), weight(1) {}
+};
+
+class ArrivalManager
+{
+private:
+    static const int MAX_SHIFT = 3;
+    static const int MAX_PASSES = 4;
+    static const int FUEL_PENALTY = 10000;
+
+    const ArrivalCandidate* cand;
+    int count;
+    int runways;
+    int separation;
+    long horizon;
+
+    int capacity;
+    int runwayCapacity;
+    int* order;         // candidate index at each sequence position
+    int* fcfsPos;       // position of each candidate in ETA order
+    int* scratch;
+    int* runwayOf;
+    long* slotTime;
+    long* prefixFree;   // runway free times before each position, (count + 1) * runways
+    long long* prefixCost;
+    long* trialFree;
+    long long initialCost;
+
+    void reserve(int n, int r)
+    {
+        if (n > capacity) {
+            delete[] order; delete[] fcfsPos; delete[] scratch;
+            delete[] runwayOf; delete[] slotTime; delete[] prefixCost;
+            while (capacity < n) capacity *= 2;
+            order = new int[capacity];
+            fcfsPos = new int[capacity];
+            scratch = new int[capacity];
+            runwayOf = new int[capacity];
+            slotTime = new long[capacity];
+            prefixCost = new long long[capacity + 1];
+            runwayCapacity = 0;
+        }
+        if ((long)(capacity + 1) * r > runwayCapacity) {
+            delete[] prefixFree;
+            delete[] trialFree;
+            runwayCapacity = (capacity + 1) * r;
+            prefixFree = new long[runwayCapacity];
+            trialFree = new long[r > 8 ? r : 8];
+        }
+    }
+
+    bool etaBefore(int a, int b)
+    {
+        if (cand[a].eta != cand[b].eta) return cand[a].eta < cand[b].eta;
+        if (cand[a].weight != cand[b].weight) return cand[a].weight > cand[b].weight;
+        return a < b;
+    }
+
+    void mergeSort(int lo, int hi)
+    {
+        if (hi - lo < 2) return;
+        int mid = (lo + hi) / 2;
+        mergeSort(lo, mid);
+        mergeSort(mid, hi);
+
+        int i = lo, j = mid, k = lo;
+        while (i < mid && j < hi) scratch[k++] = etaBefore(order[j], order[i]) ? order[j++] : order[i++];
+        while (i < mid) scratch[k++] = order[i++];
+        while (j < hi) scratch[k++] = order[j++];
+        for (k = lo; k < hi; k++) order[k] = scratch[k];
+    }
+
+    // Lands candidate c on the runway that frees up first; returns its cost
+    long long place(int c, long* freeAt, int& runway, long& when)
+    {
+        runway = 0;
+        for (int r = 1; r < runways; r++)
+            if (freeAt[r] < freeAt[runway]) runway = r;
+
+        when = cand[c].eta;
+        if (freeAt[runway] > when) when = freeAt[runway];
+        if (horizon > when) when = horizon;
+        freeAt[runway] = when + separation;
+
+        long long cost = (long long)cand[c].weight * (when - cand[c].eta);
+        if (when > cand[c].fuelDeadline)
+            cost += (long long)FUEL_PENALTY * (when - cand[c].fuelDeadline);
+        return cost;
+    }
+
+    void evaluateFrom(int pos)
+    {
+        for (int p = pos; p < count; p++) {
+            long* freeAt = prefixFree + (long)(p + 1) * runways;
+            for (int r = 0; r < runways; r++) freeAt[r] = prefixFree[(long)p * runways + r];
+            prefixCost[p + 1] = prefixCost[p] + place(order[p], freeAt, runwayOf[p], slotTime[p]);
+        }
+    }
+
+    // Candidate at position p if the flight at position from moved to position to
+    int movedAt(int p, int from, int to)
+    {
+        if (p == to) return order[from];
+        if (from < to && p >= from && p < to) return order[p + 1];
+        if (from > to && p > to && p <= from) return order[p - 1];
+        return order[p];
+    }
+
+    // Total cost of the sequence with one flight moved, or -1 if the move
+    // breaks the position-shift bound. Stops replaying as soon as the runway
+    // state matches the committed one again.
+    long long tryMove(int from, int to)
+    {
+        int lo = (from < to) ? from : to;
+        int hi = (from < to) ? to : from;
+
+        for (int p = lo; p <= hi; p++) {
+            int shift = p - fcfsPos[movedAt(p, from, to)];
+            if (shift > MAX_SHIFT || shift < -MAX_SHIFT) return -1;
+        }
+
+        for (int r = 0; r < runways; r++) trialFree[r] = prefixFree[(long)lo * runways + r];
+        long long cost = prefixCost[lo];
+        int runway;
+        long when;
+
+        for (int p = lo; p < count; p++) {
+            if (p > hi) {
+                bool same = true;
+                for (int r = 0; r < runways && same; r++)
+                    same = (trialFree[r] == prefixFree[(long)p * runways + r]);
+                if (same) return cost + (prefixCost[count] - prefixCost[p]);
+            }
+            cost += place(movedAt(p, from, to), trialFree, runway, when);
+        }
+        return cost;
+    }
+
+    void applyMove(int from, int to)
+    {
+        int moving = order[from];
+        if (from < to)
+            for (int p = from; p < to; p++) order[p] = order[p + 1];
+        else
+            for (int p = from; p > to; p--) order[p] = order[p - 1];
+        order[to] = moving;
+        evaluateFrom(from < to ? from : to);
+    }
+
+public:
+    ArrivalManager()
+        : cand(NULL), count(0), runways(1), separation(0), horizon(0),
+        capacity(16), runwayCapacity(0), prefixFree(NULL), trialFree(NULL), initialCost(0)
+    {
+        order = new int[capacity];
+        fcfsPos = new int[capacity];
+        scratch = new int[capacity];
+        runwayOf = new int[capacity];
+        slotTime = new long[capacity];
+        prefixCost = new long long[capacity + 1];
+    }
+
+    ArrivalManager(const ArrivalManager&) = delete;
+    ArrivalManager& operator=(const ArrivalManager&) = delete;
+
+    ~ArrivalManager()
+    {
+        delete[] order; delete[] fcfsPos; delete[] scratch;
+        delete[] runwayOf; delete[] slotTime; delete[] prefixCost;
+        delete[] prefixFree; delete[] trialFree;
+    }
+
+    static int classWeight(int priority)
+    {
+        switch (priority) {
+        case 1: return 50;
+        case 2: return 20;
+        case 3: return 5;
+        default: return 2;
+        }
+    }
+
+    // Sequences n candidates onto runways whose next free times are given.
+    // No slot is placed before start. Returns the optimized total cost.
+    long long sequence(const ArrivalCandidate* candidates, int n, int runwayCount,
+        int separationSeconds, const long* runwayFree, long start)
+    {
+        cand = candidates;
+        count = n;
+        runways = runwayCount < 1 ? 1 : runwayCount;
+        separation = separationSeconds;
+        horizon = start;
+        reserve(n > 0 ? n : 1, runways);
+
+        for (int i = 0; i < n; i++) order[i] = i;
+        mergeSort(0, n);
+        for (int p = 0; p < n; p++) fcfsPos[order[p]] = p;
+
+        for (int r = 0; r < runways; r++) prefixFree[r] = runwayFree[r];
+        prefixCost[0] = 0;
+        evaluateFrom(0);
+        initialCost = prefixCost[n];
+
+        for (int pass = 0; pass < MAX_PASSES; pass++) {
+            bool improved = false;
+            for (int from = 0; from < n; from++) {
+                for (int to = from - MAX_SHIFT; to <= from + MAX_SHIFT; to++) {
+                    if (to < 0 || to >= n || to == from) continue;
+                    long long cost = tryMove(from, to);
+                    if (cost >= 0 && cost < prefixCost[n]) {
+                        applyMove(from, to);
+                        improved = true;
+                    }
+                }
+            }
+            if (!improved) break;
+        }
+        return prefixCost[n];
+    }
+
+    int getCount() { return count; }
+    int getCandidate(int pos) { return order[pos]; }
+    int getRunway(int pos) { return runwayOf[pos]; }
+    long getSlotTime(int pos) { return slotTime[pos]; }
+    long long getInitialCost() { return initialCost; }
+    long long getCost() { return prefixCost[count]; }
+};
+
+// ===== LANDING SCHEDULER =====
+// Landing queues partitioned by airport. Each airport has its own runways
+// and minimum separation; the scheduler hands out landing slots across all
+// runways and releases every landing that falls due in a time window.
+class LandingSlot
+{
+public:
+    Aircraft aircraft;
+    string airport;
+    int runway;
+    long slotTime;
+
+    LandingSlot() : runway(0), slotTime(0) {}
+};
+
+class AirportLanding
+{
+public:
+    string airport;
+    int runways;
+    int separation;     // minimum seconds between landings on one runway
+    long* runwayFree;   // earliest time each runway can take its next landing
+    LandingQueue queue;
+
+    // The scheduler's copy of the queue head's landing order, kept current
+    // on every change so picking the next airport never touches the queues
+    int heapSlot;       // -1 while the queue is empty
+    bool headCritical;
+    long headKey;       // queuedAt if critical, otherwise the aged key
+    long headFree;      // when the earliest runway is free
+
+    AirportLanding(string name, int runwayCount, int separationSeconds)
+        : airport(name), runways(runwayCount), separation(separationSeconds), heapSlot(-1), headCritical(false),
+        headKey(0), headFree(0)
+    {
+        runwayFree = new long[runways];
+        for (int i = 0; i < runways; i++) runwayFree[i] = 0;
+    }
+
+    ~AirportLanding() { delete[] runwayFree; }
+
+    void setRunways(int runwayCount, int separationSeconds)
+    {
+        long* resized = new long[runwayCount];
+        for (int i = 0; i < runwayCount; i++)
+            resized[i] = (i < runways) ? runwayFree[i] : 0;
+        delete[] runwayFree;
+        runwayFree = resized;
+        runways = runwayCount;
+        separation = separationSeconds;
+    }
+
+    int earliestRunway()
+    {
+        int best = 0;
+        for (int i = 1; i < runways; i++)
+            if (runwayFree[i] < runwayFree[best]) best = i;
+        return best;
+    }
+};
+
+class LandingScheduler
+{
+private:
+    DynamicArray<AirportLanding*> airports;
+    int* airportSlots;      // airport index by name hash, -1 empty
+    int airportSlotMask;
+
+    DynamicArray<int> order;    // airports with queued flights, heap by next landing
+
+    ArrivalManager arrivalManager;
+    Aircraft* planned;
+    ArrivalCandidate* candidates;
+    int planCapacity;
+
+    void reservePlan(int n)
+    {
+        if (n <= planCapacity) return;
+        delete[] planned;
+        delete[] candidates;
+        while (planCapacity < n) planCapacity *= 2;
+        planned = new Aircraft[planCapacity];
+        candidates = new ArrivalCandidate[planCapacity];
+    }
+
+    int findAirportIndex(const string& name)
+    {
+        for (int i = (int)(hashString(name) & (unsigned int)airportSlotMask); airportSlots[i] != -1;
+            i = (i + 1) & airportSlotMask)
+            if (airports[airportSlots[i]]->airport == name) return airportSlots[i];
+        return -1;
+    }
+
+    // Keeps the name index at most half full
+    void indexAirports()
+    {
+        int size = airportSlotMask + 1;
+        while (size < airports.size() * 2) size *= 2;
+        if (size != airportSlotMask + 1) {
+            delete[] airportSlots;
+            airportSlots = new int[size];
+            airportSlotMask = size - 1;
+        }
+        for (int i = 0; i < size; i++) airportSlots[i] = -1;
+        for (int a = 0; a < airports.size(); a++) {
+            int i = (int)(hashString(airports[a]->airport) & (unsigned int)airportSlotMask);
+            while (airportSlots[i] != -1) i = (i + 1) & airportSlotMask;
+            airportSlots[i] = a;
+        }
+    }
+
+    // Whether airport a's next landing goes before airport b's: landing
+    // order of the heads, then whichever has a runway free soonest
+    bool landsFirst(int a, int b)
+    {
+        AirportLanding* x = airports[a];
+        AirportLanding* y = airports[b];
+        if (x->headCritical != y->headCritical) return x->headCritical;
+        if (x->headKey != y->headKey) return x->headKey < y->headKey;
+        if (x->headFree != y->headFree) return x->headFree < y->headFree;
+        return a < b;
+    }
+
+    void placeAirport(int slot, int a)
+    {
+        order[slot] = a;
+        airports[a]->heapSlot = slot;
+    }
+
+    void siftAirportUp(int slot)
+    {
+        int a = order[slot];
+        while (slot > 0 && landsFirst(a, order[(slot - 1) / 2])) {
+            placeAirport(slot, order[(slot - 1) / 2]);
+            slot = (slot - 1) / 2;
+        }
+        placeAirport(slot, a);
+    }
+
+    void siftAirportDown(int slot)
+    {
+        int a = order[slot];
+        while (true) {
+            int child = slot * 2 + 1;
+            if (child >= order.size()) break;
+            if (child + 1 < order.size() && landsFirst(order[child + 1], order[child])) child++;
+            if (!landsFirst(order[child], a)) break;
+            placeAirport(slot, order[child]);
+            slot = child;
+        }
+        placeAirport(slot, a);
+    }
+
+    // Re-reads airport a's queue head and runways after any change to them
+    // and moves it to its place in the heap. O(log airports).
+    void refreshAirport(int a)
+    {
+        AirportLanding* ap = airports[a];
+        const Aircraft* head = ap->queue.top();
+        if (head == NULL) {
+            int slot = ap->heapSlot;
+            if (slot == -1) return;
+            int moved = order.back();
+            order.pop();
+            ap->heapSlot = -1;
+            if (moved != a) {
+                placeAirport(slot, moved);
+                siftAirportDown(slot);
+                siftAirportUp(airports[moved]->heapSlot);
+            }
+            return;
+        }
+        ap->headCritical = (head->priority <= 1);
+        ap->headKey = ap->headCritical ? head->queuedAt : agedKey(*head);
+        ap->headFree = ap->runwayFree[ap->earliestRunway()];
+        if (ap->heapSlot == -1) {
+            order.push(a);
+            ap->heapSlot = order.size() - 1;
+        }
+        siftAirportUp(ap->heapSlot);
+        siftAirportDown(ap->heapSlot);
+    }
+
+    // Airport whose next landing should go first, -1 if none is queued
+    int bestAirport() { return order.empty() ? -1 : order[0]; }
+
+public:
+    LandingScheduler() : airportSlotMask(15), planCapacity(16)
+    {
+        airportSlots = new int[airportSlotMask + 1];
+        for (int i = 0; i <= airportSlotMask; i++) airportSlots[i] = -1;
+        planned = new Aircraft[planCapacity];
+        candidates = new ArrivalCandidate[planCapacity];
+    }
+
+    LandingScheduler(const LandingScheduler&) = delete;
+    LandingScheduler& operator=(const LandingScheduler&) = delete;
+
+    ~LandingScheduler()
+    {
+        for (int i = 0; i < airports.size(); i++) delete airports[i];
+        delete[] airportSlots;
+        delete[] planned;
+        delete[] candidates;
+    }
+
+    void configureAirport(string name, int runways, int separation)
+    {
+        if (runways < 1) throw InvalidInputException("Runway count");
+        if (separation < 1) throw InvalidInputException("Runway separation");
+
+        int idx = findAirportIndex(name);
+        if (idx != -1) {
+            airports[idx]->setRunways(runways, separation);
+            refreshAirport(idx);
+            return;
+        }
+        airports.push(new AirportLanding(name, runways, separation));
+        indexAirports();
+    }
+
+    bool hasAirport(string name) { return findAirportIndex(name) != -1; }
+
+    AirportLanding* getAirport(string name)
+    {
+        int idx = findAirportIndex(name);
+        return (idx != -1) ? airports[idx] : NULL;
+    }
+
+    int getAirportCount() { return airports.size(); }
+    AirportLanding* getAirportAt(int i) { return airports[i]; }
+
+    void insert(string airport, Aircraft aircraft)
+    {
+        int idx = findAirportIndex(airport);
+        if (idx == -1) throw InvalidInputException("Landing airport " + airport);
+        airports[idx]->queue.insert(aircraft);
+        refreshAirport(idx);
+    }
+
+    // Rebuilds every airport queue in bulk: arr[i] lands at airportOf[i].
+    // Aircraft are grouped per airport with one counting pass, O(n + airports),
+    // keeping their input order, and each queue is built in O(n).
+    void build(Aircraft* arr, string* airportOf, int count)
+    {
+        int airportCount = airports.size();
+        int* group = new int[count > 0 ? count : 1];
+        int* start = new int[airportCount + 1];
+        for (int a = 0; a <= airportCount; a++) start[a] = 0;
+        for (int i = 0; i < count; i++) {
+            group[i] = findAirportIndex(airportOf[i]);
+            if (group[i] == -1) {
+                delete[] group;
+                delete[] start;
+                throw InvalidInputException("Landing airport " + airportOf[i]);
+            }
+            start[group[i] + 1]++;
+        }
+        for (int a = 0; a < airportCount; a++) start[a + 1] += start[a];
+
+        reservePlan(count > 0 ? count : 1);
+        for (int i = 0; i < count; i++) planned[start[group[i]]++] = arr[i];
+        // start[a] now ends airport a's run, which is where a + 1 begins
+        for (int a = 0; a < airportCount; a++) {
+            int first = (a > 0) ? start[a - 1] : 0;
+            airports[a]->queue.build(planned + first, start[a] - first);
+            for (int r = 0; r < airports[a]->runways; r++) airports[a]->runwayFree[r] = 0;
+            refreshAirport(a);
+        }
+        delete[] start;
+        delete[] group;
+    }
+
+    // Controller override for k flights at once: lands the best k across all
+    // airports right now. Returns the number written to out.
+    int extractTopK(LandingSlot* out, int k, long now)
+    {
+        int count = 0;
+        while (count < k && tryExtractNext(now, out[count]) == ATC_OK) count++;
+        return count;
+    }
+
+    AtcStatus tryDecreaseKey(const string& flightID, int newPriority)
+    {
+        for (int i = 0; i < airports.size(); i++) {
+            if (airports[i]->queue.tryDecreaseKey(flightID, newPriority) == ATC_OK) {
+                refreshAirport(i);
+                return ATC_OK;
+            }
+        }
+        return ATC_NOT_FOUND;
+    }
+
+    void decreaseKey(string flightID, int newPriority)
+    {
+        if (tryDecreaseKey(flightID, newPriority) != ATC_OK) throw FlightNotFoundException(flightID);
+    }
+
+    // Next landing across all airports, without taking it off its queue
+    AtcStatus tryPeek(LandingSlot& slot)
+    {
+        int idx = bestAirport();
+        if (idx == -1) return ATC_EMPTY;
+
+        airports[idx]->queue.tryPeek(slot.aircraft);
+        slot.airport = airports[idx]->airport;
+        slot.runway = airports[idx]->earliestRunway();
+        slot.slotTime = airports[idx]->runwayFree[slot.runway];
+        return ATC_OK;
+    }
+
+    LandingSlot peek()
+    {
+        LandingSlot slot;
+        if (tryPeek(slot) != ATC_OK) throw EmptyQueueException();
+        return slot;
+    }
+
+    // Controller override: land the best flight right now on the earliest
+    // free runway of its airport, pushing that runway's next slot back
+    AtcStatus tryExtractNext(long now, LandingSlot& slot)
+    {
+        int idx = bestAirport();
+        if (idx == -1) return ATC_EMPTY;
+
+        AirportLanding* ap = airports[idx];
+        ap->queue.tryExtractMin(slot.aircraft);
+        slot.airport = ap->airport;
+        slot.runway = ap->earliestRunway();
+        slot.slotTime = now;
+        long freeAt = (ap->runwayFree[slot.runway] > now) ? ap->runwayFree[slot.runway] : now;
+        ap->runwayFree[slot.runway] = freeAt + ap->separation;
+        refreshAirport(idx);
+        return ATC_OK;
+    }
+
+    LandingSlot extractNext(long now)
+    {
+        LandingSlot slot;
+        if (tryExtractNext(now, slot) != ATC_OK) throw EmptyQueueException();
+        return slot;
+    }
+
+    // Assigns slots in [windowStart, now] on every runway of every airport and
+    // releases all landings that fall due; a runway idle since before the
+    // window gets windowStart itself. Returns the number written to cleared.
+    int processDue(long windowStart, long now, LandingSlot* cleared, int maxCleared)
+    {
+        int count = 0;
+        for (int i = 0; i < airports.size() && count < maxCleared; i++) {
+            AirportLanding* ap = airports[i];
+            while (ap->queue.getSize() > 0 && count < maxCleared) {
+                int r = ap->earliestRunway();
+                long slotTime = (ap->runwayFree[r] > windowStart) ? ap->runwayFree[r] : windowStart;
+                if (slotTime > now) break;
+
+                LandingSlot& slot = cleared[count++];
+                ap->queue.tryExtractMin(slot.aircraft);
+                slot.airport = ap->airport;
+                slot.runway = r;
+                slot.slotTime = slotTime;
+                ap->runwayFree[r] = slotTime + ap->separation;
+            }
+            refreshAirport(i);
+        }
+        return count;
+    }
+
+    // Same as processDue, but each airport's queue is re-sequenced by the
+    // arrival manager first. estimate(aircraft, airport, candidate) supplies
+    // the ETA, fuel deadline and weight of every queued flight. Only slots
+    // that fall due are committed; the rest are re-planned next tick.
+    template <typename Estimator>
+    int processDueOptimized(long windowStart, long now, LandingSlot* cleared, int maxCleared,
+        Estimator& estimate)
+    {
+        int count = 0;
+        for (int i = 0; i < airports.size() && count < maxCleared; i++) {
+            AirportLanding* ap = airports[i];
+            int n = ap->queue.getSize();
+            if (n == 0) continue;
+
+            reservePlan(n);
+            ap->queue.getAll(planned, n);
+            for (int c = 0; c < n; c++) estimate(planned[c], ap->airport, candidates[c]);
+
+            arrivalManager.sequence(candidates, n, ap->runways, ap->separation, ap->runwayFree, windowStart);
+
+            for (int p = 0; p < n && count < maxCleared; p++) {
+                long slotTime = arrivalManager.getSlotTime(p);
+                if (slotTime > now) continue;
+
+                int c = arrivalManager.getCandidate(p);
+                int r = arrivalManager.getRunway(p);
+                LandingSlot& slot = cleared[count++];
+                slot.aircraft = planned[c];
+                slot.airport = ap->airport;
+                slot.runway = r;
+                slot.slotTime = slotTime;
+                ap->queue.remove(planned[c].flightID);
+                if (slotTime + ap->separation > ap->runwayFree[r])
+                    ap->runwayFree[r] = slotTime + ap->separation;
+            }
+            refreshAirport(i);
+        }
+        return count;
+    }
+
+    int getSize()
+    {
+        int total = 0;
+        for (int i = 0; i < airports.size(); i++) total += airports[i]->queue.getSize();
+        return total;
+    }
+
+    void clear()
+    {
+        for (int i = 0; i < airports.size(); i++) {
+            airports[i]->queue.clear();
+            for (int r = 0; r < airports[i]->runways; r++) airports[i]->runwayFree[r] = 0;
+            airports[i]->heapSlot = -1;
+        }
+        order.clear();
+    }
+};
+
+// ===== FLIGHT LOG OUTPUT =====
+void printLogHeader()
+{
+    setColor(COLOR_HEADER);
+    cout << "\n|||===========================================================|||\n";
+    cout << "|||           FLIGHT LOG (Chronological Order)                |||\n";
+    cout << "|||===========================================================|||\n";
+    setColor(COLOR_RESET);
+}
+
+void printLogEntry(const Aircraft& record)
+{
+    setColor(COLOR_INFO);
+    cout << "  [";
+
+    // Convert timestamp to readable format
+    time_t rawtime = (time_t)record.timestamp;
+    struct tm timeinfo;
+    localtime_s(&timeinfo, &rawtime);
+    char buffer[80];
+    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &timeinfo);
+
+    cout << buffer << "] ";
+    setColor(MENU);
+    cout << record.flightID;
+    setColor(COLOR_SUBTITLE);
+    cout << " -> ";
+    if (record.status == "Landed") setColor(COLOR_SUCCESS);
+    else setColor(COLOR_WARNING);
+    cout << record.status;
+    setColor(COLOR_RESET);
+    cout << endl;
+}
+
+void printLogFooter(int count)
+{
+    setColor(COLOR_SUBTITLE);
+    cout << "\n  Total Flights Logged: ";
+    setColor(COLOR_INFO);
+    cout << count << endl;
+    setColor(COLOR_RESET);
+}
+
+void printEmptyLog()
+{
+    setColor(COLOR_WARNING);
+    cout << "\n  No flights recorded yet.\n";
+    setColor(COLOR_RESET);
+}
+
+// ===== FLIGHT LOG INDEX =====
+// Secondary indexes over the flight log by flight ID, airport and model.
+// Each distinct key maps to a posting list of (landing time, sequence
+// number) pairs; matching records are fetched from the log directly by
+// sequence number, in time order. A Bloom filter in front of the flight-ID index answers
+// most "never landed" lookups without probing the index.
+class StringDictionary
+{
+private:
+    string* values;     // code -> string
+    int count;
+    int capacity;
+    int* slots;         // open addressing: code + 1, 0 = empty
+    int slotCount;
+
+    void rehash(int newSlotCount)
+    {
+        delete[] slots;
+        slotCount = newSlotCount;
+        slots = new int[slotCount];
+        for (int i = 0; i < slotCount; i++) slots[i] = 0;
+        for (int code = 0; code < count; code++) {
+            unsigned int i = hashString(values[code]) & (unsigned int)(slotCount - 1);
+            while (slots[i] != 0) i = (i + 1) & (unsigned int)(slotCount - 1);
+            slots[i] = code + 1;
+        }
+    }
+
+public:
+    StringDictionary() : count(0), capacity(64), slots(NULL)
+    {
+        values = new string[capacity];
+        rehash(128);
+    }
+
+    StringDictionary(const StringDictionary&) = delete;
+    StringDictionary& operator=(const StringDictionary&) = delete;
+
+    ~StringDictionary()
+    {
+        delete[] values;
+        delete[] slots;
+    }
+
+    int encode(const string& value)
+    {
+        unsigned int i = hashString(value) & (unsigned int)(slotCount - 1);
+        while (slots[i] != 0) {
+            if (values[slots[i] - 1] == value) return slots[i] - 1;
+            i = (i + 1) & (unsigned int)(slotCount - 1);
+        }
+
+        if (count == capacity) {
+            string* bigger = new string[capacity * 2];
+            for (int c = 0; c < count; c++) bigger[c].swap(values[c]);
+            delete[] values;
+            values = bigger;
+            capacity *= 2;
+        }
+        values[count] = value;
+        slots[i] = count + 1;
+        count++;
+        if (count * 2 > slotCount) rehash(slotCount * 2);
+        return count - 1;
+    }
+
+    // Code of value, or -1 if it has never been encoded
+    int find(const string& value)
+    {
+        unsigned int i = hashString(value) & (unsigned int)(slotCount - 1);
+        while (slots[i] != 0) {
+            if (values[slots[i] - 1] == value) return slots[i] - 1;
+            i = (i + 1) & (unsigned int)(slotCount - 1);
+        }
+        return -1;
+    }
+
+    const string& decode(int code) { return values[code]; }
+    int getCount() { return count; }
+
+    void clear()
+    {
+        count = 0;
+        for (int i = 0; i < slotCount; i++) slots[i] = 0;
+    }
+};
+
+unsigned int hashStringAlt(const string& key)
+{
+    unsigned int h = 5381;
+    for (size_t i = 0; i < key.length(); i++)
+        h = h * 33 + (unsigned char)key[i];
+    return h | 1;
+}
+
+class BloomFilter
+{
+private:
+    static const int HASHES = 4;
+    static const int BITS_PER_KEY = 16;
+
+    unsigned int* words;
+    unsigned int bitCount;      // power of two
+    int keyCapacity;
+
+    unsigned int bitFor(unsigned int h1, unsigned int h2, int i) { return (h1 + i * h2) & (bitCount - 1); }
+
+public:
+    BloomFilter(int expectedKeys = 1024) : words(NULL) { reset(expectedKeys); }
+
+    BloomFilter(const BloomFilter&) = delete;
+    BloomFilter& operator=(const BloomFilter&) = delete;
+
+    ~BloomFilter() { delete[] words; }
+
+    // Empties the filter and sizes it for expectedKeys keys
+    void reset(int expectedKeys)
+    {
+        delete[] words;
+        keyCapacity = (expectedKeys < 64) ? 64 : expectedKeys;
+        bitCount = 64;
+        while (bitCount < (unsigned int)keyCapacity * BITS_PER_KEY) bitCount *= 2;
+        words = new unsigned int[bitCount / 32];
+        for (unsigned int i = 0; i < bitCount / 32; i++) words[i] = 0;
+    }
+
+    int getKeyCapacity() { return keyCapacity; }
+
+    void add(const string& key)
+    {
+        unsigned int h1 = hashString(key);
+        unsigned int h2 = hashStringAlt(key);
+        for (int i = 0; i < HASHES; i++) {
+            unsigned int bit = bitFor(h1, h2, i);
+            words[bit >> 5] |= (1u << (bit & 31));
+        }
+    }
+
+    bool mightContain(const string& key)
+    {
+        unsigned int h1 = hashString(key);
+        unsigned int h2 = hashStringAlt(key);
+        for (int i = 0; i < HASHES; i++) {
+            unsigned int bit = bitFor(h1, h2, i);
+            if ((words[bit >> 5] & (1u << (bit & 31))) == 0) return false;
+        }
+        return true;
+    }
+
+    // The bit array as hex, eight digits per word, for text files
+    string toHex()
+    {
+        static const char digits[] = "0123456789abcdef";
+        string out;
+        out.reserve(bitCount / 4);
+        for (unsigned int w = 0; w < bitCount / 32; w++)
+            for (int shift = 28; shift >= 0; shift -= 4) out += digits[(words[w] >> shift) & 15];
+        return out;
+    }
+
+    // Restores a filter written by toHex; false if hex is not one
+    bool fromHex(const string& hex)
+    {
+        unsigned int bits = (unsigned int)hex.length() * 4;
+        if (bits < 64 || (bits & (bits - 1)) != 0) return false;
+        unsigned int* loaded = new unsigned int[bits / 32];
+        for (unsigned int w = 0; w < bits / 32; w++) {
+            unsigned int word = 0;
+            for (int d = 0; d < 8; d++) {
+                char c = hex[w * 8 + d];
+                int value = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1;
+                if (value < 0) {
+                    delete[] loaded;
+                    return false;
+                }
+                word = (word << 4) | (unsigned int)value;
+            }
+            loaded[w] = word;
+        }
+        delete[] words;
+        words = loaded;
+        bitCount = bits;
+        keyCapacity = (int)(bits / BITS_PER_KEY);
+        return true;
+    }
+};
+
+// Timestamps and log sequence numbers of the records behind one key.
+// Entries are appended in O(1); records that arrive out of time order are
+// only sorted into place when the list is next read.
+class PostingList
+{
+public:
+    long* times;
+    int* ids;
+    int count;
+    int capacity;
+    int sortedCount;    // leading entries already in time order
+
+    PostingList() : times(NULL), ids(NULL), count(0), capacity(0), sortedCount(0) {}
+
+    PostingList(const PostingList&) = delete;
+    PostingList& operator=(const PostingList&) = delete;
+
+    ~PostingList()
+    {
+        delete[] times;
+        delete[] ids;
+    }
+
+    void add(long ts, int id)
+    {
+        if (count == capacity) {
+            capacity = (capacity == 0) ? 4 : capacity * 2;
+            long* biggerTimes = new long[capacity];
+            int* biggerIds = new int[capacity];
+            for (int i = 0; i < count; i++) {
+                biggerTimes[i] = times[i];
+                biggerIds[i] = ids[i];
+            }
+            delete[] times;
+            delete[] ids;
+            times = biggerTimes;
+            ids = biggerIds;
+        }
+        if (sortedCount == count && (count == 0 || times[count - 1] <= ts)) sortedCount++;
+        times[count] = ts;
+        ids[count] = id;
+        count++;
+    }
+
+    // Stably sorts the unsorted tail and merges it behind the sorted
+    // prefix, so equal timestamps stay in insertion order, which is the
+    // order the logs keep them in. O(k + t log t) for a tail of t entries.
+    void sortByTime()
+    {
+        if (sortedCount == count) return;
+        long* tmpTimes = new long[count];
+        int* tmpIds = new int[count];
+        int tail = count - sortedCount;
+        long* tailTimes = times + sortedCount;
+        int* tailIds = ids + sortedCount;
+        for (int width = 1; width < tail; width *= 2) {
+            for (int lo = 0; lo < tail; lo += width * 2) {
+                int mid = (lo + width < tail) ? lo + width : tail;
+                int hi = (lo + width * 2 < tail) ? lo + width * 2 : tail;
+                int a = lo, b = mid, out = lo;
+                while (a < mid || b < hi) {
+                    int from = (b == hi || (a < mid && tailTimes[a] <= tailTimes[b])) ? a++ : b++;
+                    tmpTimes[out] = tailTimes[from];
+                    tmpIds[out++] = tailIds[from];
+                }
+            }
+            for (int i = 0; i < tail; i++) {
+                tailTimes[i] = tmpTimes[i];
+                tailIds[i] = tmpIds[i];
+            }
+        }
+
+        int a = 0, b = sortedCount;
+        for (int out = 0; out < count; out++) {
+            int from = (b == count || (a < sortedCount && times[a] <= times[b])) ? a++ : b++;
+            tmpTimes[out] = times[from];
+            tmpIds[out] = ids[from];
+        }
+        delete[] times;
+        delete[] ids;
+        times = tmpTimes;
+        ids = tmpIds;
+        capacity = count;
+        sortedCount = count;
+    }
+};
+
+class KeyIndex
+{
+private:
+    StringDictionary keys;
+    PostingList** lists;
+    int listCapacity;
+    int lastCode;       // code of the last key added, compared before hashing
+
+public:
+    KeyIndex() : listCapacity(64), lastCode(-1)
+    {
+        lists = new PostingList*[listCapacity];
+        for (int i = 0; i < listCapacity; i++) lists[i] = NULL;
+    }
+
+    KeyIndex(const KeyIndex&) = delete;
+    KeyIndex& operator=(const KeyIndex&) = delete;
+
+    ~KeyIndex()
+    {
+        for (int i = 0; i < listCapacity; i++) delete lists[i];
+        delete[] lists;
+    }
+
+    // Returns true if key was seen for the first time
+    bool add(const string& key, long ts, int id)
+    {
+        int before = keys.getCount();
+        int code = (lastCode != -1 && keys.decode(lastCode) == key) ? lastCode : keys.encode(key);
+        lastCode = code;
+        if (code >= listCapacity) {
+            int newCapacity = listCapacity * 2;
+            PostingList** bigger = new PostingList*[newCapacity];
+            for (int i = 0; i < newCapacity; i++) bigger[i] = (i < listCapacity) ? lists[i] : NULL;
+            delete[] lists;
+            lists = bigger;
+            listCapacity = newCapacity;
+        }
+        if (lists[code] == NULL) lists[code] = new PostingList();
+        lists[code]->add(ts, id);
+        return keys.getCount() > before;
+    }
+
+    PostingList* find(const string& key)
+    {
+        int code = keys.find(key);
+        return (code == -1) ? NULL : lists[code];
+    }
+
+    int getKeyCount() { return keys.getCount(); }
+    const string& keyAt(int code) { return keys.decode(code); }
+
+    void clear()
+    {
+        for (int i = 0; i < listCapacity; i++) {
+            delete lists[i];
+            lists[i] = NULL;
+        }
+        keys.clear();
+        lastCode = -1;
+    }
+};
+
+class FlightLogIndex
+{
+private:
+    KeyIndex byFlight;
+    KeyIndex byAirport;
+    KeyIndex byModel;
+    BloomFilter flightFilter;
+
+    // Bloom filters cannot grow, so rebuild from the known IDs when full
+    void growFilter()
+    {
+        flightFilter.reset(flightFilter.getKeyCapacity() * 2);
+        for (int i = 0; i < byFlight.getKeyCount(); i++) flightFilter.add(byFlight.keyAt(i));
+    }
+
+public:
+    // id is the record's sequence number in the log that holds it
+    void add(const Aircraft& record, int id)
+    {
+        if (byFlight.add(record.flightID, record.timestamp, id)) {
+            if (byFlight.getKeyCount() > flightFilter.getKeyCapacity()) growFilter();
+            else flightFilter.add(record.flightID);
+        }
+        byAirport.add(record.destination, record.timestamp, id);
+        if (record.currentNode != record.destination)
+            byAirport.add(record.currentNode, record.timestamp, id);
+        byModel.add(record.model, record.timestamp, id);
+    }
+
+    bool mightHaveLanded(const string& flightID) { return flightFilter.mightContain(flightID); }
+
+    PostingList* flightPostings(const string& flightID)
+    {
+        if (!flightFilter.mightContain(flightID)) return NULL;
+        return byFlight.find(flightID);
+    }
+
+    PostingList* airportPostings(const string& airport) { return byAirport.find(airport); }
+    PostingList* modelPostings(const string& model) { return byModel.find(model); }
+
+    void clear()
+    {
+        byFlight.clear();
+        byAirport.clear();
+        byModel.clear();
+        flightFilter.reset(1024);
+    }
+};
+
+// Fetches the records behind a posting list from log by sequence number
+// and passes the ones accepted by match to visit, in timestamp order.
+// O(k) for k postings once the list is sorted.
+template <typename Log, typename Match, typename Visitor>
+int visitPostings(Log& log, PostingList* list, Match& match, Visitor& visit)
+{
+    if (list == NULL) return 0;
+    int found = 0;
+    auto filter = [&](const Aircraft& record) {
+        if (match(record)) {
+            visit(record);
+            found++;
+        }
+    };
+    list->sortByTime();
+    for (int i = 0; i < list->count; i++) log.visitRecord(list->ids[i], filter);
+    return found;
+}
+
+// ===== AVL TREE =====
+class AVLNode
+{
+public:
+    Aircraft data;
+    AVLNode* left;
+    AVLNode* right;
+    int height;
+    int size;       // nodes in this subtree, for rank/select
+
+    AVLNode(Aircraft d) : data(d), left(NULL), right(NULL), height(1), size(1) {}
+};
+
+class AVLTree
+{
+private:
+    AVLNode* root;
+    int nodeCount;
+    FlightLogIndex index;
+    NodePool<AVLNode> pool;
+    DynamicArray<AVLNode*> bySequence;  // node of each record, in insertion order
+    AVLNode* created;                   // node made by the last insertNode
+
+    int height(AVLNode* node) { return node ? node->height : 0; }
+    int getBalance(AVLNode* node) { return node ? height(node->left) - height(node->right) : 0; }
+    int maxVal(int a, int b) { return (a > b) ? a : b; }
+    int sizeOf(AVLNode* node) { return node ? node->size : 0; }
+
+    void update(AVLNode* node)
+    {
+        node->height = maxVal(height(node->left), height(node->right)) + 1;
+        node->size = sizeOf(node->left) + sizeOf(node->right) + 1;
+    }
+
+    AVLNode* rightRotate(AVLNode* y)
+    {
+        AVLNode* x = y->left;
+        AVLNode* T2 = x->right;
+        x->right = y;
+        y->left = T2;
+        update(y);
+        update(x);
+        return x;
+    }
+
+    AVLNode* leftRotate(AVLNode* x)
+    {
+        AVLNode* y = x->right;
+        AVLNode* T2 = y->left;
+        y->left = x;
+        x->right = T2;
+        update(x);
+        update(y);
+        return y;
+    }
+
+    AVLNode* insertNode(AVLNode* node, Aircraft data)
+    {
+        if (node == NULL) {
+            nodeCount++;
+            created = pool.create(data);
+            return created;
+        }
+
+        if (data.timestamp < node->data.timestamp)
+            node->left = insertNode(node->left, data);
+        else
+            node->right = insertNode(node->right, data);
+
+        update(node);
+
+        int balance = getBalance(node);
+
+        if (balance > 1 && data.timestamp < node->left->data.timestamp)
+            return rightRotate(node);
+
+        if (balance < -1 && data.timestamp >= node->right->data.timestamp)
+            return leftRotate(node);
+
+        if (balance > 1 && data.timestamp >= node->left->data.timestamp) {
+            node->left = leftRotate(node->left);
+            return rightRotate(node);
+        }
+
+        if (balance < -1 && data.timestamp < node->right->data.timestamp) {
+            node->right = rightRotate(node->right);
+            return leftRotate(node);
+        }
+
+        return node;
+    }
+
+    void inOrderTraversal(AVLNode* node)
+    {
+        if (node != NULL) {
+            inOrderTraversal(node->left);
+            printLogEntry(node->data);
+            inOrderTraversal(node->right);
+        }
+    }
+
+    template <typename Visitor>
+    void visitInOrder(AVLNode* node, Visitor& visit)
+    {
+        if (node != NULL) {
+            visitInOrder(node->left, visit);
+            visit(node->data);
+            visitInOrder(node->right, visit);
+        }
+    }
+
+    // Visits records with from <= timestamp < to, skipping subtrees that
+    // lie entirely outside the range
+    template <typename Visitor>
+    void visitRange(AVLNode* node, long from, long to, Visitor& visit)
+    {
+        if (node == NULL) return;
+        if (node->data.timestamp >= from) visitRange(node->left, from, to, visit);
+        if (node->data.timestamp >= from && node->data.timestamp < to) visit(node->data);
+        if (node->data.timestamp < to) visitRange(node->right, from, to, visit);
+    }
+
+    template <typename Collector>
+    void collectInOrder(AVLNode* node, Collector& collect)
+    {
+        if (node != NULL) {
+            collectInOrder(node->left, collect);
+            collect(node);
+            collectInOrder(node->right, collect);
+        }
+    }
+
+    void clearTree(AVLNode* node)
+    {
+        if (node != NULL) {
+            clearTree(node->left);
+            clearTree(node->right);
+            pool.discard(node);
+        }
+    }
+
+    // Destroys every node and rewinds the pool in one step
+    void releaseNodes()
+    {
+        clearTree(root);
+        pool.reset();
+        root = NULL;
+        nodeCount = 0;
+        bySequence.clear();
+    }
+
+    // Gives node the next sequence number and indexes its record
+    void addSequence(AVLNode* node)
+    {
+        index.add(node->data, bySequence.size());
+        bySequence.push(node);
+    }
+
+    // Stable bottom-up merge sort of nodes by timestamp; scratch holds count
+    void sortNodes(AVLNode** nodes, AVLNode** scratch, int count)
+    {
+        for (int width = 1; width < count; width *= 2) {
+            for (int lo = 0; lo < count; lo += width * 2) {
+                int mid = (lo + width < count) ? lo + width : count;
+                int hi = (lo + width * 2 < count) ? lo + width * 2 : count;
+                int a = lo, b = mid, out = lo;
+                while (a < mid || b < hi) {
+                    if (b == hi || (a < mid && nodes[a]->data.timestamp <= nodes[b]->data.timestamp))
+                        scratch[out++] = nodes[a++];
+                    else
+                        scratch[out++] = nodes[b++];
+                }
+            }
+            for (int i = 0; i < count; i++) nodes[i] = scratch[i];
+        }
+    }
+
+    // Links sorted nodes[lo..hi] into a perfectly balanced subtree. O(n).
+    AVLNode* buildBalanced(AVLNode** nodes, int lo, int hi)
+    {
+        if (lo > hi) return NULL;
+        int mid = lo + (hi - lo) / 2;
+        AVLNode* node = nodes[mid];
+        node->left = buildBalanced(nodes, lo, mid - 1);
+        node->right = buildBalanced(nodes, mid + 1, hi);
+        update(node);
+        return node;
+    }
+
+public:
+    AVLTree() : root(NULL), nodeCount(0), created(NULL) {}
+
+    AVLTree(const AVLTree&) = delete;
+    AVLTree& operator=(const AVLTree&) = delete;
+
+    ~AVLTree() { releaseNodes(); }
+
+    void insert(Aircraft data)
+    {
+        root = insertNode(root, data);
+        addSequence(created);
+    }
+
+    // Adds count records at once. A batch that is small next to the tree
+    // (count * log2 n < n) is inserted one by one, O(count log n); a larger
+    // one is sorted, merged with the tree's nodes in order and relinked as a
+    // balanced tree by buildBalanced, O(n + count log count). Records with
+    // equal timestamps keep the order a run of single inserts gives them.
+    void insertBatch(Aircraft* records, int count)
+    {
+        if (count <= 0) return;
+        int depth = 1;
+        while ((1 << depth) <= nodeCount) depth++;
+        if ((long long)count * depth < nodeCount) {
+            for (int i = 0; i < count; i++) {
+                root = insertNode(root, records[i]);
+                addSequence(created);
+            }
+            return;
+        }
+
+        // New nodes, stably merge-sorted by timestamp
+        pool.reserve(count);
+        AVLNode** added = new AVLNode*[count];
+        AVLNode** scratch = new AVLNode*[count > nodeCount ? count : nodeCount + 1];
+        for (int i = 0; i < count; i++) {
+            added[i] = pool.create(records[i]);
+            addSequence(added[i]);
+        }
+        sortNodes(added, scratch, count);
+
+        // Existing nodes in order, then the merge; an existing record goes
+        // first on a tie, as insertNode sends equal timestamps right
+        int existing = 0;
+        auto collect = [&scratch, &existing](AVLNode* node) { scratch[existing++] = node; };
+        collectInOrder(root, collect);
+        int total = existing + count;
+        AVLNode** merged = new AVLNode*[total];
+        int a = 0, b = 0;
+        for (int out = 0; out < total; out++) {
+            if (b == count || (a < existing && scratch[a]->data.timestamp <= added[b]->data.timestamp))
+                merged[out] = scratch[a++];
+            else
+                merged[out] = added[b++];
+        }
+        root = buildBalanced(merged, 0, total - 1);
+        nodeCount = total;
+        delete[] merged;
+        delete[] scratch;
+        delete[] added;
+    }
+
+    void printLog()
+    {
+        printLogHeader();
+        if (root == NULL) printEmptyLog();
+        else inOrderTraversal(root);
+        printLogFooter(nodeCount);
+    }
+
+    // Calls visit(const Aircraft&) for every record in timestamp order
+    template <typename Visitor>
+    void forEach(Visitor& visit)
+    {
+        visitInOrder(root, visit);
+    }
+
+    // Calls visit(const Aircraft&) for records with from <= timestamp < to,
+    // in timestamp order. O(log n + k).
+    template <typename Visitor>
+    void forEachInRange(long from, long to, Visitor& visit)
+    {
+        visitRange(root, from, to, visit);
+    }
+
+    // Number of records with timestamp < ts. O(log n).
+    int rank(long ts)
+    {
+        int below = 0;
+        AVLNode* node = root;
+        while (node != NULL) {
+            if (node->data.timestamp < ts) {
+                below += sizeOf(node->left) + 1;
+                node = node->right;
+            }
+            else node = node->left;
+        }
+        return below;
+    }
+
+    // The k-th record (0-based) in timestamp order. O(log n).
+    bool select(int k, Aircraft& out)
+    {
+        if (k < 0 || k >= nodeCount) return false;
+        AVLNode* node = root;
+        while (node != NULL) {
+            int leftSize = sizeOf(node->left);
+            if (k < leftSize) node = node->left;
+            else if (k == leftSize) {
+                out = node->data;
+                return true;
+            }
+            else {
+                k -= leftSize + 1;
+                node = node->right;
+            }
+        }
+        return false;
+    }
+
+    int countInRange(long from, long to)
+    {
+        return (to > from) ? rank(to) - rank(from) : 0;
+    }
+
+    // Calls visit(const Aircraft&) for every landing of flightID, oldest
+    // first; returns the number of matches
+    template <typename Visitor>
+    int forEachByFlight(const string& flightID, Visitor& visit)
+    {
+        auto match = [&flightID](const Aircraft& record) { return record.flightID == flightID; };
+        return visitPostings(*this, index.flightPostings(flightID), match, visit);
+    }
+
+    // Landings whose destination or final node is airport
+    template <typename Visitor>
+    int forEachByAirport(const string& airport, Visitor& visit)
+    {
+        auto match = [&airport](const Aircraft& record) {
+            return record.destination == airport || record.currentNode == airport;
+        };
+        return visitPostings(*this, index.airportPostings(airport), match, visit);
+    }
+
+    template <typename Visitor>
+    int forEachByModel(const string& model, Visitor& visit)
+    {
+        auto match = [&model](const Aircraft& record) { return record.model == model; };
+        return visitPostings(*this, index.modelPostings(model), match, visit);
+    }
+
+    bool hasLanded(const string& flightID) { return index.flightPostings(flightID) != NULL; }
+
+    // Calls visit(const Aircraft&) for the record with sequence number id. O(1).
+    template <typename Visitor>
+    void visitRecord(int id, Visitor& visit)
+    {
+        visit(bySequence[id]->data);
+    }
+
+    void saveToFile(string filename)
+    {
+        ofstream file(filename);
+        if (!file.is_open()) throw FileOperationException(filename);
+
+        file << nodeCount << "\n";
+
+        // Stream straight from the tree in timestamp order
+        string line;
+        auto write = [&file, &line](const Aircraft& record) {
+            line.clear();
+            record.appendTo(line);
+            line += '\n';
+            file << line;
+        };
+        visitInOrder(root, write);
+        file.close();
+    }
+
+    void loadFromFile(string filename)
+    {
+        ifstream file(filename);
+        if (!file.is_open()) throw FileOperationException(filename);
+
+        releaseNodes();
+        index.clear();
+
+        string line;
+        getline(file, line);
+        int count = stoi(line);
+
+        // Parse straight into nodes reserved as one contiguous run of the
+        // pool. saveToFile writes in timestamp order, so the nodes are
+        // normally sorted and become a balanced tree in O(n) with no rotations.
+        pool.reserve(count);
+        AVLNode** nodes = new AVLNode*[count > 0 ? count : 1];
+        int loaded = 0;
+        bool sorted = true;
+        for (int i = 0; i < count; i++) {
+            if (!getline(file, line)) break;
+            if (line.empty()) continue;
+            nodes[loaded] = pool.create(Aircraft::fromString(line));
+            if (loaded > 0 && nodes[loaded]->data.timestamp < nodes[loaded - 1]->data.timestamp)
+                sorted = false;
+            addSequence(nodes[loaded]);
+            loaded++;
+        }
+        file.close();
+
+        // An edited file is stably sorted first, so equal timestamps keep
+        // file order as a run of single inserts would
+        if (!sorted) {
+            AVLNode** scratch = new AVLNode*[loaded > 0 ? loaded : 1];
+            sortNodes(nodes, scratch, loaded);
+            delete[] scratch;
+        }
+        root = buildBalanced(nodes, 0, loaded - 1);
+        nodeCount = loaded;
+        delete[] nodes;
+    }
+
+    int getCount() { return nodeCount; }
+    NodePool<AVLNode>& getNodePool() { return pool; }
+};
+
+// ===== FLIGHT LOG STORE =====
+// Append-only, time-partitioned columnar flight log. Records live in
+// segments of up to SEGMENT_ROWS rows, one array per field, with all
+// string fields dictionary-coded. Landing timestamps are nearly monotonic,
+// so an insert is normally an append to the last segment; an out-of-order
+// record is placed into the segment covering its time, which is split
+// when full. Same insert/print/save API as AVLTree.
+class LogSegment
+{
+public:
+    static const int SEGMENT_ROWS = 4096;
+
+    int count;
+    long* timestamp;
+    long* queuedAt;
+    int* flightID;
+    int* model;
+    int* origin;
+    int* destination;
+    int* status;
+    int* currentNode;
+    int* x;
+    int* y;
+    unsigned char* fuelLevel;
+    unsigned char* priority;
+    int* sequence;      // the store's sequence number of each row
+
+    LogSegment() : count(0)
+    {
+        timestamp = new long[SEGMENT_ROWS];
+        queuedAt = new long[SEGMENT_ROWS];
+        flightID = new int[SEGMENT_ROWS];
+        model = new int[SEGMENT_ROWS];
+        origin = new int[SEGMENT_ROWS];
+        destination = new int[SEGMENT_ROWS];
+        status = new int[SEGMENT_ROWS];
+        currentNode = new int[SEGMENT_ROWS];
+        x = new int[SEGMENT_ROWS];
+        y = new int[SEGMENT_ROWS];
+        fuelLevel = new unsigned char[SEGMENT_ROWS];
+        priority = new unsigned char[SEGMENT_ROWS];
+        sequence = new int[SEGMENT_ROWS];
+    }
+
+    LogSegment(const LogSegment&) = delete;
+    LogSegment& operator=(const LogSegment&) = delete;
+
+    ~LogSegment()
+    {
+        delete[] timestamp; delete[] queuedAt;
+        delete[] flightID; delete[] model; delete[] origin; delete[] destination;
+        delete[] status; delete[] currentNode; delete[] x; delete[] y;
+        delete[] fuelLevel; delete[] priority; delete[] sequence;
+    }
+
+    bool isFull() { return count == SEGMENT_ROWS; }
+    long minTime() { return timestamp[0]; }
+    long maxTime() { return timestamp[count - 1]; }
+
+    // Moves n rows starting at from to position to, within this segment or into another
+    static void copyRows(LogSegment* src, int from, LogSegment* dst, int to, int n)
+    {
+        memmove(dst->timestamp + to, src->timestamp + from, n * sizeof(long));
+        memmove(dst->queuedAt + to, src->queuedAt + from, n * sizeof(long));
+        memmove(dst->flightID + to, src->flightID + from, n * sizeof(int));
+        memmove(dst->model + to, src->model + from, n * sizeof(int));
+        memmove(dst->origin + to, src->origin + from, n * sizeof(int));
+        memmove(dst->destination + to, src->destination + from, n * sizeof(int));
+        memmove(dst->status + to, src->status + from, n * sizeof(int));
+        memmove(dst->currentNode + to, src->currentNode + from, n * sizeof(int));
+        memmove(dst->x + to, src->x + from, n * sizeof(int));
+        memmove(dst->y + to, src->y + from, n * sizeof(int));
+        memmove(dst->fuelLevel + to, src->fuelLevel + from, n);
+        memmove(dst->priority + to, src->priority + from, n);
+        memmove(dst->sequence + to, src->sequence + from, n * sizeof(int));
+    }
+
+    // First row whose timestamp is greater than ts
+    int upperBound(long ts)
+    {
+        int lo = 0, hi = count;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (timestamp[mid] <= ts) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+};
+
+// Where the record with a given sequence number currently lives
+struct RowLocation
+{
+    LogSegment* segment;
+    int row;
+};
+
+class FlightLogStore
+{
+private:
+    LogSegment** segments;
+    int segmentCount;
+    int segmentCapacity;
+    int recordCount;
+    int* segmentStart;      // rows before each segment, valid below firstStale
+    int firstStale;
+    StringDictionary dictionary;
+    FlightLogIndex index;
+    int indexedCount;       // rows with a lower sequence number are in the index
+    DynamicArray<RowLocation> locations;    // by sequence number, for the index
+    LogSegment* spare;      // allocated ahead by reserve for the next new segment
+    Aircraft scratch;
+    int scratchCodes[6];    // dictionary codes currently decoded into scratch
+    int writeCodes[6];      // dictionary codes of the last row written
+
+    LogSegment* takeSegment()
+    {
+        if (spare == NULL) return new LogSegment();
+        LogSegment* segment = spare;
+        spare = NULL;
+        segment->count = 0;
+        return segment;
+    }
+
+    void insertSegmentAt(int pos, LogSegment* segment)
+    {
+        if (segmentCount == segmentCapacity) {
+            LogSegment** bigger = new LogSegment*[segmentCapacity * 2];
+            int* biggerStart = new int[segmentCapacity * 2];
+            for (int i = 0; i < segmentCount; i++) {
+                bigger[i] = segments[i];
+                biggerStart[i] = segmentStart[i];
+            }
+            delete[] segments;
+            delete[] segmentStart;
+            segments = bigger;
+            segmentStart = biggerStart;
+            segmentCapacity *= 2;
+        }
+        for (int i = segmentCount; i > pos; i--) segments[i] = segments[i - 1];
+        segments[pos] = segment;
+        segmentCount++;
+        markStale(pos);
+    }
+
+    void markStale(int s)
+    {
+        if (s < firstStale) firstStale = s;
+    }
+
+    // Brings segmentStart up to date. Appends never invalidate it, so this
+    // only does work after an out-of-order insert or a split.
+    void refreshStarts()
+    {
+        if (firstStale >= segmentCount) return;
+        int start = (firstStale > 0) ? segmentStart[firstStale - 1] + segments[firstStale - 1]->count : 0;
+        for (int s = firstStale; s < segmentCount; s++) {
+            segmentStart[s] = start;
+            start += segments[s]->count;
+        }
+        firstStale = segmentCount;
+    }
+
+    // First row in segment s whose timestamp is >= ts
+    int lowerBound(int s, long ts)
+    {
+        LogSegment* seg = segments[s];
+        int lo = 0, hi = seg->count;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (seg->timestamp[mid] < ts) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    // Segment and row of the first record with timestamp >= ts
+    void seek(long ts, int& s, int& row)
+    {
+        int lo = 0, hi = segmentCount;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (segments[mid]->maxTime() < ts) lo = mid + 1;
+            else hi = mid;
+        }
+        s = lo;
+        row = (s < segmentCount) ? lowerBound(s, ts) : 0;
+    }
+
+    // Consecutive landings mostly repeat the previous row's model, airports
+    // and status, so a column first compares against its last value and
+    // only hashes into the dictionary when that differs
+    int encodeColumn(int column, const string& value)
+    {
+        int code = writeCodes[column];
+        if (code == -1 || dictionary.decode(code) != value) {
+            code = dictionary.encode(value);
+            writeCodes[column] = code;
+        }
+        return code;
+    }
+
+    void writeRow(LogSegment* seg, int row, const Aircraft& data)
+    {
+        seg->timestamp[row] = data.timestamp;
+        seg->queuedAt[row] = data.queuedAt;
+        seg->flightID[row] = encodeColumn(0, data.flightID);
+        seg->model[row] = encodeColumn(1, data.model);
+        seg->origin[row] = encodeColumn(2, data.origin);
+        seg->destination[row] = encodeColumn(3, data.destination);
+        seg->status[row] = encodeColumn(4, data.status);
+        seg->currentNode[row] = encodeColumn(5, data.currentNode);
+        seg->x[row] = data.x;
+        seg->y[row] = data.y;
+        seg->fuelLevel[row] = (unsigned char)data.fuelLevel;
+        seg->priority[row] = (unsigned char)data.priority;
+    }
+
+    // Points the location of every row in seg[from, to) back at it, after
+    // the rows were shifted or moved there
+    void relocate(LogSegment* seg, int from, int to)
+    {
+        for (int row = from; row < to; row++) {
+            RowLocation& where = locations[seg->sequence[row]];
+            where.segment = seg;
+            where.row = row;
+        }
+    }
+
+    // Last segment whose first timestamp is <= ts (0 if none)
+    int segmentFor(long ts)
+    {
+        int lo = 0, hi = segmentCount;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (segments[mid]->minTime() <= ts) lo = mid + 1;
+            else hi = mid;
+        }
+        return (lo > 0) ? lo - 1 : 0;
+    }
+
+    void splitSegment(int s)
+    {
+        LogSegment* full = segments[s];
+        LogSegment* upper = takeSegment();
+        int half = full->count / 2;
+        LogSegment::copyRows(full, half, upper, 0, full->count - half);
+        upper->count = full->count - half;
+        full->count = half;
+        relocate(upper, 0, upper->count);
+        insertSegmentAt(s + 1, upper);
+    }
+
+    void clearSegments()
+    {
+        for (int i = 0; i < segmentCount; i++) delete segments[i];
+        segmentCount = 0;
+        recordCount = 0;
+        firstStale = 0;
+        dictionary.clear();
+        index.clear();
+        indexedCount = 0;
+        locations.clear();
+        for (int i = 0; i < 6; i++) scratchCodes[i] = writeCodes[i] = -1;
+    }
+
+public:
+    FlightLogStore() : segmentCount(0), segmentCapacity(16), recordCount(0), firstStale(0), indexedCount(0),
+        spare(NULL)
+    {
+        segments = new LogSegment*[segmentCapacity];
+        segmentStart = new int[segmentCapacity];
+        for (int i = 0; i < 6; i++) scratchCodes[i] = writeCodes[i] = -1;
+    }
+
+    FlightLogStore(const FlightLogStore&) = delete;
+    FlightLogStore& operator=(const FlightLogStore&) = delete;
+
+    ~FlightLogStore()
+    {
+        clearSegments();
+        delete spare;
+        delete[] segments;
+        delete[] segmentStart;
+    }
+
+    // Rows are indexed on the first lookup after they were inserted, so a
+    // landing tick only appends
+    void catchUpIndex()
+    {
+        for (; indexedCount < locations.size(); indexedCount++) {
+            const RowLocation& where = locations[indexedCount];
+            index.add(readRow(where.segment, where.row), indexedCount);
+        }
+    }
+
+    // Encodes a queued flight's strings and makes room for pending more
+    // rows, so landing them appends without allocating
+    void reserve(const Aircraft& incoming, int pending)
+    {
+        dictionary.encode(incoming.flightID);
+        dictionary.encode(incoming.model);
+        dictionary.encode(incoming.origin);
+        dictionary.encode(incoming.destination);
+        dictionary.encode(incoming.currentNode);
+        locations.reserve(locations.size() + pending);
+        int room = (segmentCount == 0) ? 0 : LogSegment::SEGMENT_ROWS - segments[segmentCount - 1]->count;
+        if (spare == NULL && room < pending) spare = new LogSegment();
+    }
+
+    void insert(const Aircraft& data)
+    {
+        int id = locations.size();
+
+        // Common case: at or after the newest record, append
+        if (segmentCount == 0 || data.timestamp >= segments[segmentCount - 1]->maxTime()) {
+            if (segmentCount == 0 || segments[segmentCount - 1]->isFull())
+                insertSegmentAt(segmentCount, takeSegment());
+            LogSegment* last = segments[segmentCount - 1];
+            RowLocation where = { last, last->count };
+            last->sequence[last->count] = id;
+            writeRow(last, last->count++, data);
+            locations.push(where);
+            recordCount++;
+            return;
+        }
+
+        int s = segmentFor(data.timestamp);
+        if (segments[s]->isFull()) {
+            splitSegment(s);
+            if (data.timestamp >= segments[s + 1]->minTime()) s++;
+        }
+
+        LogSegment* seg = segments[s];
+        int row = seg->upperBound(data.timestamp);
+        LogSegment::copyRows(seg, row, seg, row + 1, seg->count - row);
+        writeRow(seg, row, data);
+        seg->sequence[row] = id;
+        seg->count++;
+        RowLocation where = { seg, row };
+        locations.push(where);
+        relocate(seg, row + 1, seg->count);
+        recordCount++;
+        markStale(s + 1);
+    }
+
+    void insertBatch(Aircraft* records, int count)
+    {
+        for (int i = 0; i < count; i++) insert(records[i]);
+    }
+
+    void decodeInto(string& field, int& cached, int code)
+    {
+        if (cached != code) {
+            field = dictionary.decode(code);
+            cached = code;
+        }
+    }
+
+    // Rebuilds the record at (segment, row) into scratch. String fields are
+    // only re-decoded when their code differs from the previous row's.
+    const Aircraft& readRow(int s, int row) { return readRow(segments[s], row); }
+
+    const Aircraft& readRow(LogSegment* seg, int row)
+    {
+        scratch.timestamp = seg->timestamp[row];
+        scratch.queuedAt = seg->queuedAt[row];
+        decodeInto(scratch.flightID, scratchCodes[0], seg->flightID[row]);
+        decodeInto(scratch.model, scratchCodes[1], seg->model[row]);
+        decodeInto(scratch.origin, scratchCodes[2], seg->origin[row]);
+        decodeInto(scratch.destination, scratchCodes[3], seg->destination[row]);
+        decodeInto(scratch.status, scratchCodes[4], seg->status[row]);
+        decodeInto(scratch.currentNode, scratchCodes[5], seg->currentNode[row]);
+        scratch.x = seg->x[row];
+        scratch.y = seg->y[row];
+        scratch.fuelLevel = seg->fuelLevel[row];
+        scratch.priority = seg->priority[row];
+        return scratch;
+    }
+
+    // Calls visit(const Aircraft&) for every record in timestamp order. The
+    // record passed in is reused between calls, so copy it to keep it.
+    template <typename Visitor>
+    void forEach(Visitor& visit)
+    {
+        for (int s = 0; s < segmentCount; s++)
+            for (int row = 0; row < segments[s]->count; row++)
+                visit(readRow(s, row));
+    }
+
+    // Calls visit(const Aircraft&) for records with from <= timestamp < to,
+    // in timestamp order. O(log n + k).
+    template <typename Visitor>
+    void forEachInRange(long from, long to, Visitor& visit)
+    {
+        int s, row;
+        seek(from, s, row);
+        for (; s < segmentCount; s++, row = 0) {
+            LogSegment* seg = segments[s];
+            for (; row < seg->count; row++) {
+                if (seg->timestamp[row] >= to) return;
+                visit(readRow(s, row));
+            }
+        }
+    }
+
+    // Number of records with timestamp < ts. O(log n).
+    int rank(long ts)
+    {
+        refreshStarts();
+        int s, row;
+        seek(ts, s, row);
+        return (s < segmentCount) ? segmentStart[s] + row : recordCount;
+    }
+
+    // The k-th record (0-based) in timestamp order. O(log n).
+    bool select(int k, Aircraft& out)
+    {
+        if (k < 0 || k >= recordCount) return false;
+        refreshStarts();
+
+        int lo = 0, hi = segmentCount - 1;
+        while (lo < hi) {
+            int mid = (lo + hi + 1) / 2;
+            if (segmentStart[mid] <= k) lo = mid;
+            else hi = mid - 1;
+        }
+        out = readRow(lo, k - segmentStart[lo]);
+        return true;
+    }
+
+    int countInRange(long from, long to)
+    {
+        return (to > from) ? rank(to) - rank(from) : 0;
+    }
+
+    // Calls visit(const Aircraft&) for every landing of flightID, oldest
+    // first; returns the number of matches
+    template <typename Visitor>
+    int forEachByFlight(const string& flightID, Visitor& visit)
+    {
+        auto match = [&flightID](const Aircraft& record) { return record.flightID == flightID; };
+        catchUpIndex();
+        return visitPostings(*this, index.flightPostings(flightID), match, visit);
+    }
+
+    // Landings whose destination or final node is airport
+    template <typename Visitor>
+    int forEachByAirport(const string& airport, Visitor& visit)
+    {
+        auto match = [&airport](const Aircraft& record) {
+            return record.destination == airport || record.currentNode == airport;
+        };
+        catchUpIndex();
+        return visitPostings(*this, index.airportPostings(airport), match, visit);
+    }
+
+    template <typename Visitor>
+    int forEachByModel(const string& model, Visitor& visit)
+    {
+        auto match = [&model](const Aircraft& record) { return record.model == model; };
+        catchUpIndex();
+        return visitPostings(*this, index.modelPostings(model), match, visit);
+    }
+
+    bool hasLanded(const string& flightID)
+    {
+        catchUpIndex();
+        return index.flightPostings(flightID) != NULL;
+    }
+
+    // Calls visit(const Aircraft&) for the record with sequence number id.
+    // Its location follows the row through shifts and splits, so this is O(1).
+    template <typename Visitor>
+    void visitRecord(int id, Visitor& visit)
+    {
+        const RowLocation& where = locations[id];
+        visit(readRow(where.segment, where.row));
+    }
+
+    // Calls visit(const LogSegment&) per segment for column-at-a-time scans
+    template <typename Visitor>
+    void forEachSegment(Visitor& visit)
+    {
+        for (int s = 0; s < segmentCount; s++) visit((const LogSegment&)*segments[s]);
+    }
+
+    void printLog()
+    {
+        printLogHeader();
+        if (recordCount == 0) printEmptyLog();
+        else {
+            auto print = [](const Aircraft& record) { printLogEntry(record); };
+            forEach(print);
+        }
+        printLogFooter(recordCount);
+    }
+
+    void saveToFile(string filename)
+    {
+        ofstream file(filename);
+        if (!file.is_open()) throw FileOperationException(filename);
+
+        file << recordCount << "\n";
+        string line;
+        auto write = [&file, &line](const Aircraft& record) {
+            line.clear();
+            record.appendTo(line);
+            line += '\n';
+            file << line;
+        };
+        forEach(write);
+        file.close();
+    }
+
+    void loadFromFile(string filename)
+    {
+        ifstream file(filename);
+        if (!file.is_open()) throw FileOperationException(filename);
+
+        clearSegments();
+
+        string line;
+        getline(file, line);
+        int count = stoi(line);
+
+        for (int i = 0; i < count; i++) {
+            getline(file, line);
+            if (line.empty()) continue;
+            insert(Aircraft::fromString(line));
+        }
+        file.close();
+    }
+
+    // Timestamp of the last record in the oldest segment (0 if empty)
+    long oldestSegmentEnd() { return segmentCount ? segments[0]->maxTime() : 0; }
+
+    // Moves every record with timestamp < cutoff into out, in timestamp
+    // order, and returns how many moved; out must hold rank(cutoff) records.
+    // The remaining records are re-inserted so the dictionary and indexes
+    // only cover what is still held. O(n).
+    int evictBefore(long cutoff, Aircraft* out)
+    {
+        Aircraft* all = new Aircraft[recordCount > 0 ? recordCount : 1];
+        int count = 0;
+        auto collect = [&all, &count](const Aircraft& record) { all[count++] = record; };
+        forEach(collect);
+
+        clearSegments();
+        int evicted = 0;
+        for (int i = 0; i < count; i++) {
+            if (all[i].timestamp < cutoff) out[evicted++] = all[i];
+            else insert(all[i]);
+        }
+        delete[] all;
+        return evicted;
+    }
+
+    void clear() { clearSegments(); }
+
+    int getCount() { return recordCount; }
+    int getSegmentCount() { return segmentCount; }
+};
+
+// ===== DURABLE FILES =====
+// One file written durably: the bytes go to "<name>.tmp" through a large
+// buffer, are flushed to the disk and only then renamed over <name>, so an
+// interrupted save leaves the previous file whole
+class CheckpointFile
+{
+private:
+    static const int BUFFER_BYTES = 1 << 20;
+    string filename;
+    string temp;
+#ifdef _WIN32
+    HANDLE handle;
+#else
+    int fd;
+#endif
+    char* buffer;
+    int used;
+    std::atomic<long long>* progress;   // bytes handed to the OS so far, may be NULL
+    bool committed;
+
+    void flushBuffer()
+    {
+        int offset = 0;
+        while (offset < used) {
+#ifdef _WIN32
+            DWORD written = 0;
+            if (!WriteFile(handle, buffer + offset, (DWORD)(used - offset), &written, NULL))
+                throw CheckpointException(temp, "write failed");
+#else
+            ssize_t written = ::write(fd, buffer + offset, (size_t)(used - offset));
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                throw CheckpointException(temp, "write failed");
+            }
+#endif
+            offset += (int)written;
+        }
+        if (progress != NULL) progress->fetch_add(used, std::memory_order_relaxed);
+        used = 0;
+    }
+
+    void closeFile()
+    {
+#ifdef _WIN32
+        if (handle != INVALID_HANDLE_VALUE) CloseHandle(handle);
+        handle = INVALID_HANDLE_VALUE;
+#else
+        if (fd != -1) ::close(fd);
+        fd = -1;
+#endif
+    }
+
+public:
+    CheckpointFile(const string& name, std::atomic<long long>* bytesWritten)
+        : filename(name), temp(name + ".tmp"), buffer(NULL), used(0), progress(bytesWritten), committed(false)
+    {
+#ifdef _WIN32
+        handle = CreateFileA(temp.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (handle == INVALID_HANDLE_VALUE) throw FileOperationException(temp);
+#else
+        fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd == -1) throw FileOperationException(temp);
+#endif
+        buffer = new char[BUFFER_BYTES];
+    }
+
+    CheckpointFile(const CheckpointFile&) = delete;
+    CheckpointFile& operator=(const CheckpointFile&) = delete;
+
+    void append(const char* data, int length)
+    {
+        while (length > 0) {
+            int room = BUFFER_BYTES - used;
+            int chunk = (length < room) ? length : room;
+            memcpy(buffer + used, data, chunk);
+            used += chunk;
+            data += chunk;
+            length -= chunk;
+            if (used == BUFFER_BYTES) flushBuffer();
+        }
+    }
+
+    void append(const string& text) { append(text.data(), (int)text.size()); }
+
+    // Flushes the data to the disk, then replaces the target in one step
+    void commit()
+    {
+        flushBuffer();
+#ifdef _WIN32
+        if (!FlushFileBuffers(handle)) throw CheckpointException(temp, "cannot flush to disk");
+        closeFile();
+        if (!MoveFileExA(temp.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+            throw CheckpointException(filename, "cannot replace");
+#else
+        if (fsync(fd) != 0) throw CheckpointException(temp, "cannot flush to disk");
+        closeFile();
+        if (rename(temp.c_str(), filename.c_str()) != 0) throw CheckpointException(filename, "cannot replace");
+        // the rename is only durable once its directory is flushed too
+        size_t slash = filename.find_last_of('/');
+        string directory = (slash == string::npos) ? string(".") : filename.substr(0, slash + 1);
+        int dirFd = ::open(directory.c_str(), O_RDONLY);
+        if (dirFd != -1) {
+            fsync(dirFd);
+            ::close(dirFd);
+        }
+#endif
+        committed = true;
+    }
+
+    ~CheckpointFile()
+    {
+        closeFile();
+        if (!committed) remove(temp.c_str());
+        delete[] buffer;
+    }
+};
+
+// ===== FLIGHT LOG ARCHIVE =====
+// Cold tier of the flight log: immutable, compressed segment files on disk
+// listed by a manifest. A segment stores its rows column by column, with
+// delta-encoded timestamps and dictionary-coded string columns. All
+// integers are written as varints. Segments cover disjoint time ranges, so
+// read in manifest order they are in timestamp order. Small segments are
+// merged by a background compaction thread. Only one decoded segment is
+// held in memory at a time; the manifest keeps a Bloom filter of each
+// segment's flight IDs, airports and models so key lookups skip segments
+// without reading them. Segments and manifest are written through
+// CheckpointFile, and a segment is durable before the manifest names it.
+
+void appendVarint(string& out, unsigned long long value)
+{
+    while (value >= 0x80) {
+        out += (char)((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += (char)value;
+}
+
+unsigned long long readVarint(const char*& p, const char* end)
+{
+    unsigned long long value = 0;
+    int shift = 0;
+    while (p < end) {
+        unsigned char byte = (unsigned char)*p++;
+        value |= (unsigned long long)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return value;
+        shift += 7;
+    }
+    throw AircraftException("Archive segment is truncated");
+}
+
+// Zig-zag mapping so small negative deltas stay short
+unsigned long long zigzag(long long value) { return ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63); }
+long long unzigzag(unsigned long long value) { return (long long)(value >> 1) ^ -(long long)(value & 1); }
+
+// One archived segment decoded back into columns
+class ArchiveSegment
+{
+public:
+    static const int STRING_COLUMNS = 6;
+
+    int count;
+    int dictionaryCount;
+    string* dictionary;
+    long* timestamp;
+    long* queuedAt;
+    int* codes[STRING_COLUMNS];    // flightID, model, origin, destination, status, currentNode
+    int* x;
+    int* y;
+    int* fuelLevel;
+    int* priority;
+
+    ArchiveSegment() : count(0), dictionaryCount(0), dictionary(NULL), timestamp(NULL), queuedAt(NULL),
+        x(NULL), y(NULL), fuelLevel(NULL), priority(NULL)
+    {
+        for (int c = 0; c < STRING_COLUMNS; c++) codes[c] = NULL;
+    }
+
+    ArchiveSegment(const ArchiveSegment&) = delete;
+    ArchiveSegment& operator=(const ArchiveSegment&) = delete;
+
+    ~ArchiveSegment() { release(); }
+
+    void release()
+    {
+        delete[] dictionary;
+        delete[] timestamp;
+        delete[] queuedAt;
+        for (int c = 0; c < STRING_COLUMNS; c++) {
+            delete[] codes[c];
+            codes[c] = NULL;
+        }
+        delete[] x;
+        delete[] y;
+        delete[] fuelLevel;
+        delete[] priority;
+        dictionary = NULL;
+        timestamp = queuedAt = NULL;
+        x = y = fuelLevel = priority = NULL;
+        count = dictionaryCount = 0;
+    }
+
+    // Encodes rows (sorted by timestamp) into the segment file format
+    static string encode(const Aircraft* rows, int n)
+    {
+        StringDictionary dict;
+        int* rowCodes = new int[n * STRING_COLUMNS];
+        for (int i = 0; i < n; i++) {
+            const Aircraft& a = rows[i];
+            int* c = rowCodes + i * STRING_COLUMNS;
+            c[0] = dict.encode(a.flightID);
+            c[1] = dict.encode(a.model);
+            c[2] = dict.encode(a.origin);
+            c[3] = dict.encode(a.destination);
+            c[4] = dict.encode(a.status);
+            c[5] = dict.encode(a.currentNode);
+        }
+
+        string out = "SKYSEG1";
+        appendVarint(out, n);
+        appendVarint(out, dict.getCount());
+        for (int d = 0; d < dict.getCount(); d++) {
+            const string& value = dict.decode(d);
+            appendVarint(out, value.length());
+            out += value;
+        }
+
+        long previous = 0;
+        for (int i = 0; i < n; i++) {
+            appendVarint(out, zigzag(rows[i].timestamp - previous));
+            previous = rows[i].timestamp;
+        }
+        for (int i = 0; i < n; i++) appendVarint(out, zigzag(rows[i].timestamp - rows[i].queuedAt));
+        for (int c = 0; c < STRING_COLUMNS; c++)
+            for (int i = 0; i < n; i++) appendVarint(out, rowCodes[i * STRING_COLUMNS + c]);
+        for (int i = 0; i < n; i++) appendVarint(out, zigzag(rows[i].x));
+        for (int i = 0; i < n; i++) appendVarint(out, zigzag(rows[i].y));
+        for (int i = 0; i < n; i++) appendVarint(out, zigzag(rows[i].fuelLevel));
+        for (int i = 0; i < n; i++) appendVarint(out, zigzag(rows[i].priority));
+
+        delete[] rowCodes;
+        return out;
+    }
+
+    // Decodes a segment file. With dictionaryOnly, stops after the
+    // dictionary so key lookups can skip segments cheaply.
+    void load(const string& filename, bool dictionaryOnly = false)
+    {
+        release();
+        ifstream file(filename, ios::binary);
+        if (!file.is_open()) throw FileOperationException(filename);
+        string bytes((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+        file.close();
+
+        const char* p = bytes.data();
+        const char* end = p + bytes.size();
+        if (bytes.compare(0, 7, "SKYSEG1") != 0) throw FileOperationException(filename);
+        p += 7;
+
+        int n = (int)readVarint(p, end);
+        dictionaryCount = (int)readVarint(p, end);
+        dictionary = new string[dictionaryCount > 0 ? dictionaryCount : 1];
+        for (int d = 0; d < dictionaryCount; d++) {
+            size_t length = (size_t)readVarint(p, end);
+            if (length > (size_t)(end - p)) throw FileOperationException(filename);
+            dictionary[d].assign(p, length);
+            p += length;
+        }
+        if (dictionaryOnly) return;
+
+        int size = n > 0 ? n : 1;
+        timestamp = new long[size];
+        queuedAt = new long[size];
+        for (int c = 0; c < STRING_COLUMNS; c++) codes[c] = new int[size];
+        x = new int[size];
+        y = new int[size];
+        fuelLevel = new int[size];
+        priority = new int[size];
+
+        long previous = 0;
+        for (int i = 0; i < n; i++) {
+            previous += (long)unzigzag(readVarint(p, end));
+            timestamp[i] = previous;
+        }
+        for (int i = 0; i < n; i++) queuedAt[i] = timestamp[i] - (long)unzigzag(readVarint(p, end));
+        for (int c = 0; c < STRING_COLUMNS; c++)
+            for (int i = 0; i < n; i++) codes[c][i] = (int)readVarint(p, end);
+        for (int i = 0; i < n; i++) x[i] = (int)unzigzag(readVarint(p, end));
+        for (int i = 0; i < n; i++) y[i] = (int)unzigzag(readVarint(p, end));
+        for (int i = 0; i < n; i++) fuelLevel[i] = (int)unzigzag(readVarint(p, end));
+        for (int i = 0; i < n; i++) priority[i] = (int)unzigzag(readVarint(p, end));
+        count = n;
+    }
+
+    void readRow(int i, Aircraft& out)
+    {
+        out.timestamp = timestamp[i];
+        out.queuedAt = queuedAt[i];
+        out.flightID = dictionary[codes[0][i]];
+        out.model = dictionary[codes[1][i]];
+        out.origin = dictionary[codes[2][i]];
+        out.destination = dictionary[codes[3][i]];
+        out.status = dictionary[codes[4][i]];
+        out.currentNode = dictionary[codes[5][i]];
+        out.x = x[i];
+        out.y = y[i];
+        out.fuelLevel = fuelLevel[i];
+        out.priority = priority[i];
+    }
+
+    // Rows with timestamp < ts
+    int countBefore(long ts)
+    {
+        int lo = 0, hi = count;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (timestamp[mid] < ts) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+};
+
+class ArchiveEntry
+{
+public:
+    int id;
+    long minTime;
+    long maxTime;
+    int rows;
+    BloomFilter* keys;      // searchable values in the segment, owned by the archive
+
+    ArchiveEntry() : id(0), minTime(0), maxTime(0), rows(0), keys(NULL) {}
+};
+
+class FlightLogArchive
+{
+public:
+    static const int COMPACT_FANIN = 4;         // segments merged per compaction
+    static const int MAX_SEGMENT_ROWS = 65536;  // compaction never builds larger segments
+
+private:
+    string prefix;
+    ArchiveEntry* entries;      // sorted by minTime
+    int entryCount;
+    int entryCapacity;
+    int nextId;
+    long boundary;              // archived through: hot records are all >= boundary
+    int recordCount;
+    ArchiveSegment decoded;     // one segment at a time for queries
+    int decodedId;
+
+    std::mutex lock;            // guards the manifest; queries hold it while reading files
+    std::thread compactor;
+    std::atomic<bool> compacting;
+
+    string segmentFile(int id) { return prefix + "_" + toString(id) + ".seg"; }
+    string manifestFile() { return prefix + ".manifest"; }
+
+    void addEntry(const ArchiveEntry& entry)
+    {
+        if (entryCount == entryCapacity) {
+            ArchiveEntry* bigger = new ArchiveEntry[entryCapacity * 2];
+            for (int i = 0; i < entryCount; i++) bigger[i] = entries[i];
+            delete[] entries;
+            entries = bigger;
+            entryCapacity *= 2;
+        }
+        int i = entryCount;
+        while (i > 0 && entries[i - 1].minTime > entry.minTime) {
+            entries[i] = entries[i - 1];
+            i--;
+        }
+        entries[i] = entry;
+        entryCount++;
+        recordCount += entry.rows;
+    }
+
+    void removeEntry(int id)
+    {
+        for (int i = 0; i < entryCount; i++) {
+            if (entries[i].id != id) continue;
+            recordCount -= entries[i].rows;
+            delete entries[i].keys;
+            for (int j = i; j < entryCount - 1; j++) entries[j] = entries[j + 1];
+            entryCount--;
+            return;
+        }
+    }
+
+    void clearEntries()
+    {
+        for (int i = 0; i < entryCount; i++) delete entries[i].keys;
+        entryCount = 0;
+        recordCount = 0;
+    }
+
+    // Replaces the manifest in one durable step; the old one stays whole
+    // until the new one is on disk
+    void saveManifest()
+    {
+        CheckpointFile file(manifestFile(), NULL);
+        string line = "SKYNET-ARCHIVE 2\n";
+        appendNumber(line, nextId);
+        line += ' ';
+        appendNumber(line, boundary);
+        line += ' ';
+        appendNumber(line, entryCount);
+        line += '\n';
+        file.append(line);
+        for (int i = 0; i < entryCount; i++) {
+            const ArchiveEntry& entry = entries[i];
+            line.clear();
+            appendNumber(line, entry.id);
+            line += ' ';
+            appendNumber(line, entry.minTime);
+            line += ' ';
+            appendNumber(line, entry.maxTime);
+            line += ' ';
+            appendNumber(line, entry.rows);
+            line += ' ';
+            line += entry.keys->toHex();
+            line += '\n';
+            file.append(line);
+        }
+        file.commit();
+    }
+
+    void writeSegment(const ArchiveEntry& entry, const Aircraft* rows)
+    {
+        CheckpointFile file(segmentFile(entry.id), NULL);
+        file.append(ArchiveSegment::encode(rows, entry.rows));
+        file.commit();
+    }
+
+    // Bloom filter over the values forEachWithKey searches by
+    static BloomFilter* buildKeyFilter(const Aircraft* rows, int n)
+    {
+        StringDictionary values;
+        for (int i = 0; i < n; i++) {
+            values.encode(rows[i].flightID);
+            values.encode(rows[i].model);
+            values.encode(rows[i].destination);
+            values.encode(rows[i].currentNode);
+        }
+        BloomFilter* filter = new BloomFilter(values.getCount());
+        for (int d = 0; d < values.getCount(); d++) filter->add(values.decode(d));
+        return filter;
+    }
+
+    // For manifests written before filters were kept: every value in the
+    // segment's dictionary, read once when the archive is opened
+    BloomFilter* readKeyFilter(int id)
+    {
+        ArchiveSegment header;
+        header.load(segmentFile(id), true);
+        BloomFilter* filter = new BloomFilter(header.dictionaryCount);
+        for (int d = 0; d < header.dictionaryCount; d++) filter->add(header.dictionary[d]);
+        return filter;
+    }
+
+    // Writes rows as a new segment and lists it. Caller holds lock.
+    void appendSegment(const Aircraft* rows, int n)
+    {
+        ArchiveEntry entry;
+        entry.id = nextId++;
+        entry.rows = n;
+        entry.minTime = rows[0].timestamp;
+        entry.maxTime = rows[n - 1].timestamp;
+        writeSegment(entry, rows);
+        entry.keys = buildKeyFilter(rows, n);
+        addEntry(entry);
+    }
+
+    // Merges segment's rows into the sorted merged[0, mergedCount), through
+    // temp; the two buffers are swapped
+    static void mergeSegment(ArchiveSegment& segment, Aircraft*& merged, Aircraft*& temp, int& mergedCount)
+    {
+        int a = 0, b = 0, out = 0;
+        while (a < mergedCount || b < segment.count) {
+            if (b == segment.count || (a < mergedCount && merged[a].timestamp <= segment.timestamp[b]))
+                temp[out++] = merged[a++];
+            else
+                segment.readRow(b++, temp[out++]);
+        }
+        Aircraft* swap = merged;
+        merged = temp;
+        temp = swap;
+        mergedCount = out;
+    }
+
+    // Manifests written before late records were merged into their segment
+    // can list overlapping single-row segments; each overlapping run is
+    // merged into one segment. Caller holds lock.
+    void mergeOverlaps()
+    {
+        int start = 0;
+        while (start < entryCount) {
+            int end = start + 1;
+            long maxTime = entries[start].maxTime;
+            int total = entries[start].rows;
+            while (end < entryCount && entries[end].minTime <= maxTime) {
+                if (entries[end].maxTime > maxTime) maxTime = entries[end].maxTime;
+                total += entries[end].rows;
+                end++;
+            }
+            if (end - start == 1) {
+                start++;
+                continue;
+            }
+
+            int runLength = end - start;
+            int* ids = new int[runLength];
+            Aircraft* merged = new Aircraft[total];
+            Aircraft* temp = new Aircraft[total];
+            int mergedCount = 0;
+            for (int i = 0; i < runLength; i++) {
+                ids[i] = entries[start + i].id;
+                mergeSegment(decode(ids[i]), merged, temp, mergedCount);
+            }
+            try {
+                appendSegment(merged, mergedCount);
+            }
+            catch (AircraftException&) {
+                delete[] ids;
+                delete[] merged;
+                delete[] temp;
+                throw;
+            }
+            for (int i = 0; i < runLength; i++) removeEntry(ids[i]);
+            saveManifest();
+            decodedId = -1;
+            for (int i = 0; i < runLength; i++) remove(segmentFile(ids[i]).c_str());
+            delete[] ids;
+            delete[] merged;
+            delete[] temp;
+            start++;
+        }
+    }
+
+    // Caller holds lock
+    bool isListed(int id)
+    {
+        for (int i = 0; i < entryCount; i++)
+            if (entries[i].id == id) return true;
+        return false;
+    }
+
+    // Caller holds lock
+    ArchiveSegment& decode(int id)
+    {
+        if (decodedId != id) {
+            decodedId = -1;
+            decoded.load(segmentFile(id));
+            decodedId = id;
+        }
+        return decoded;
+    }
+
+    // Picks the oldest run of COMPACT_FANIN adjacent segments that fits in
+    // MAX_SEGMENT_ROWS. Caller holds lock.
+    bool pickVictims(int* ids)
+    {
+        for (int start = 0; start + COMPACT_FANIN <= entryCount; start++) {
+            int rows = 0;
+            for (int i = 0; i < COMPACT_FANIN; i++) rows += entries[start + i].rows;
+            if (rows > MAX_SEGMENT_ROWS) continue;
+            for (int i = 0; i < COMPACT_FANIN; i++) ids[i] = entries[start + i].id;
+            return true;
+        }
+        return false;
+    }
+
+    // Background compaction: merges runs of small segments into one sorted
+    // segment. Reading and writing happen outside the lock; segment files
+    // are immutable. If insertLate replaced a victim meanwhile, the merge
+    // is discarded and the run picked again.
+    void compactLoop()
+    {
+        while (true) {
+            int victims[COMPACT_FANIN];
+            int total = 0;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                if (!pickVictims(victims)) break;
+                for (int v = 0; v < COMPACT_FANIN; v++)
+                    for (int i = 0; i < entryCount; i++)
+                        if (entries[i].id == victims[v]) total += entries[i].rows;
+            }
+
+            Aircraft* merged = new Aircraft[total > 0 ? total : 1];
+            Aircraft* temp = new Aircraft[total > 0 ? total : 1];
+            int mergedCount = 0;
+            try {
+                ArchiveSegment segment;
+                for (int v = 0; v < COMPACT_FANIN; v++) {
+                    segment.load(segmentFile(victims[v]));
+                    mergeSegment(segment, merged, temp, mergedCount);
+                }
+
+                ArchiveEntry entry;
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    entry.id = nextId++;
+                }
+                entry.rows = mergedCount;
+                entry.minTime = merged[0].timestamp;
+                entry.maxTime = merged[mergedCount - 1].timestamp;
+                writeSegment(entry, merged);
+                entry.keys = buildKeyFilter(merged, mergedCount);
+
+                std::lock_guard<std::mutex> guard(lock);
+                bool current = true;
+                for (int v = 0; v < COMPACT_FANIN; v++)
+                    if (!isListed(victims[v])) current = false;
+                if (current) {
+                    for (int v = 0; v < COMPACT_FANIN; v++) removeEntry(victims[v]);
+                    addEntry(entry);
+                    saveManifest();
+                    decodedId = -1;
+                    for (int v = 0; v < COMPACT_FANIN; v++) remove(segmentFile(victims[v]).c_str());
+                }
+                else {
+                    delete entry.keys;
+                    remove(segmentFile(entry.id).c_str());
+                }
+            }
+            catch (AircraftException&) {
+                // Leave the segments as they are; a later compaction retries
+                delete[] merged;
+                delete[] temp;
+                break;
+            }
+            delete[] merged;
+            delete[] temp;
+        }
+        compacting = false;
+    }
+
+public:
+    FlightLogArchive(const string& filePrefix = "flight_archive")
+        : prefix(filePrefix), entryCount(0), entryCapacity(16), nextId(1), boundary(0), recordCount(0),
+        decodedId(-1), compacting(false)
+    {
+        entries = new ArchiveEntry[entryCapacity];
+    }
+
+    FlightLogArchive(const FlightLogArchive&) = delete;
+    FlightLogArchive& operator=(const FlightLogArchive&) = delete;
+
+    ~FlightLogArchive()
+    {
+        waitForCompaction();
+        clearEntries();
+        delete[] entries;
+    }
+
+    // Reads the manifest from disk; a missing manifest means an empty archive
+    void open()
+    {
+        waitForCompaction();
+        std::lock_guard<std::mutex> guard(lock);
+        clearEntries();
+        nextId = 1;
+        boundary = 0;
+        decodedId = -1;
+
+        ifstream file(manifestFile());
+        if (!file.is_open()) return;
+        string magic;
+        getline(file, magic);
+        bool hasFilters = (magic != "SKYNET-ARCHIVE 1");
+        int count = 0;
+        file >> nextId >> boundary >> count;
+        string hex;
+        for (int i = 0; i < count; i++) {
+            ArchiveEntry entry;
+            if (!(file >> entry.id >> entry.minTime >> entry.maxTime >> entry.rows)) break;
+            entry.keys = new BloomFilter();
+            if (!hasFilters || !(file >> hex) || !entry.keys->fromHex(hex)) {
+                delete entry.keys;
+                entry.keys = readKeyFilter(entry.id);
+            }
+            addEntry(entry);
+        }
+        file.close();
+        mergeOverlaps();
+    }
+
+    // Archives rows (sorted by timestamp) as a new segment. Rows that were
+    // evicted from the hot tier move the boundary up to newBoundary.
+    void append(const Aircraft* rows, int n, long newBoundary)
+    {
+        if (n <= 0) return;
+        std::lock_guard<std::mutex> guard(lock);
+        appendSegment(rows, n);
+        if (newBoundary > boundary) boundary = newBoundary;
+        saveManifest();
+    }
+
+    // Archives records older than the boundary, sorted by timestamp. Each
+    // segment covering some of them is rewritten once with its share merged
+    // in, after any equal timestamps, so segments never overlap.
+    // O(rows of the rewritten segments + n).
+    void insertLate(const Aircraft* records, int n)
+    {
+        if (n <= 0) return;
+        std::lock_guard<std::mutex> guard(lock);
+        if (entryCount == 0) {
+            appendSegment(records, n);
+            saveManifest();
+            return;
+        }
+
+        DynamicArray<int> replaced;
+        int first = 0;
+        while (first < n) {
+            int e = 0;
+            while (e + 1 < entryCount && entries[e + 1].minTime <= records[first].timestamp) e++;
+            int last = first + 1;
+            if (e + 1 < entryCount)
+                while (last < n && records[last].timestamp < entries[e + 1].minTime) last++;
+            else
+                last = n;
+
+            int oldId = entries[e].id;
+            ArchiveSegment& segment = decode(oldId);
+            int total = segment.count + (last - first);
+            Aircraft* rows = new Aircraft[total];
+            int a = 0, b = first, out = 0;
+            while (a < segment.count || b < last) {
+                if (b == last || (a < segment.count && segment.timestamp[a] <= records[b].timestamp))
+                    segment.readRow(a++, rows[out++]);
+                else
+                    rows[out++] = records[b++];
+            }
+
+            try {
+                appendSegment(rows, total);
+            }
+            catch (AircraftException&) {
+                delete[] rows;
+                throw;
+            }
+            delete[] rows;
+            removeEntry(oldId);
+            decodedId = -1;
+            replaced.push(oldId);
+            first = last;
+        }
+
+        saveManifest();
+        for (int i = 0; i < replaced.size(); i++) remove(segmentFile(replaced[i]).c_str());
+    }
+
+    void insertLate(const Aircraft& record) { insertLate(&record, 1); }
+
+    // Starts background compaction if enough small segments have piled up
+    void maybeCompact()
+    {
+        if (compacting) return;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            int ids[COMPACT_FANIN];
+            if (!pickVictims(ids)) return;
+        }
+        if (compactor.joinable()) compactor.join();
+        compacting = true;
+        compactor = std::thread(&FlightLogArchive::compactLoop, this);
+    }
+
+    void waitForCompaction()
+    {
+        if (compactor.joinable()) compactor.join();
+    }
+
+    // Deletes every segment file and the manifest, leaving an empty archive
+    void removeFiles()
+    {
+        waitForCompaction();
+        std::lock_guard<std::mutex> guard(lock);
+        for (int i = 0; i < entryCount; i++) remove(segmentFile(entries[i].id).c_str());
+        remove(manifestFile().c_str());
+        clearEntries();
+        nextId = 1;
+        boundary = 0;
+        decodedId = -1;
+    }
+
+    template <typename Visitor>
+    void forEachInRange(long from, long to, Visitor& visit)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        Aircraft record;
+        for (int e = 0; e < entryCount; e++) {
+            if (entries[e].maxTime < from || entries[e].minTime >= to) continue;
+            ArchiveSegment& segment = decode(entries[e].id);
+            for (int i = segment.countBefore(from); i < segment.count && segment.timestamp[i] < to; i++) {
+                segment.readRow(i, record);
+                visit((const Aircraft&)record);
+            }
+        }
+    }
+
+    // Visits records accepted by match in segments whose key filter may
+    // hold key; other segments are skipped without being read
+    template <typename Match, typename Visitor>
+    int forEachWithKey(const string& key, Match& match, Visitor& visit)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        int found = 0;
+        Aircraft record;
+        for (int e = 0; e < entryCount; e++) {
+            if (!entries[e].keys->mightContain(key)) continue;
+            ArchiveSegment& segment = decode(entries[e].id);
+            for (int i = 0; i < segment.count; i++) {
+                segment.readRow(i, record);
+                if (match((const Aircraft&)record)) {
+                    visit((const Aircraft&)record);
+                    found++;
+                }
+            }
+        }
+        return found;
+    }
+
+    int rank(long ts)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        int below = 0;
+        for (int e = 0; e < entryCount; e++) {
+            if (entries[e].maxTime < ts) below += entries[e].rows;
+            else if (entries[e].minTime < ts) below += decode(entries[e].id).countBefore(ts);
+        }
+        return below;
+    }
+
+    // k-th archived record in timestamp order
+    bool select(int k, Aircraft& out)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (k < 0) return false;
+        for (int e = 0; e < entryCount; e++) {
+            if (k < entries[e].rows) {
+                decode(entries[e].id).readRow(k, out);
+                return true;
+            }
+            k -= entries[e].rows;
+        }
+        return false;
+    }
+
+    long getBoundary() { return boundary; }
+
+    int getCount()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return recordCount;
+    }
+
+    int getSegmentCount()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return entryCount;
+    }
+};
+
+// The flight log SkyNetATC uses: a bounded hot window in a FlightLogStore
+// in front of the on-disk archive. Once the hot tier holds more than
+// HOT_SEGMENTS segments, its oldest segment is archived. saveToFile writes
+// only the hot window, so save and load cost stay bounded however much
+// history is archived. Queries cover both tiers.
+class TieredFlightLog
+{
+public:
+    static const int HOT_SEGMENTS = 4;
+
+private:
+    FlightLogStore hot;
+    FlightLogArchive archive;
+
+    void spill()
+    {
+        long cutoff = hot.oldestSegmentEnd();
+        if (hot.rank(cutoff) == 0) cutoff++;    // whole segment shares one timestamp
+        Aircraft* rows = new Aircraft[hot.rank(cutoff)];
+        int evicted = hot.evictBefore(cutoff, rows);
+        try {
+            archive.append(rows, evicted, cutoff);
+        }
+        catch (FileOperationException&) {
+            // Keep the records in memory rather than lose them
+            hot.insertBatch(rows, evicted);
+            delete[] rows;
+            throw;
+        }
+        delete[] rows;
+        archive.maybeCompact();
+    }
+
+public:
+    TieredFlightLog(const string& archivePrefix = "flight_archive") : archive(archivePrefix)
+    {
+        archive.open();
+    }
+
+    void insert(const Aircraft& data)
+    {
+        // Late record older than everything in the hot tier: archive it
+        // directly so the tiers never overlap on reload
+        if (data.timestamp < archive.getBoundary()) {
+            archive.insertLate(data);
+            return;
+        }
+        hot.insert(data);
+        if (hot.getSegmentCount() > HOT_SEGMENTS) spill();
+    }
+
+    // Late records in the batch are archived together, so each segment
+    // they fall in is rewritten once per batch instead of once per record
+    void insertBatch(Aircraft* records, int count)
+    {
+        DynamicArray<int> late;
+        for (int i = 0; i < count; i++) {
+            if (records[i].timestamp < archive.getBoundary()) {
+                late.push(i);
+                continue;
+            }
+            hot.insert(records[i]);
+            if (hot.getSegmentCount() > HOT_SEGMENTS) spill();
+        }
+        if (late.size() == 0) return;
+
+        // Stable bottom-up merge sort of the late positions by timestamp
+        int lateCount = late.size();
+        DynamicArray<int> scratch;
+        scratch.resize(lateCount);
+        int* order = late.data();
+        for (int width = 1; width < lateCount; width *= 2) {
+            for (int lo = 0; lo < lateCount; lo += width * 2) {
+                int mid = (lo + width < lateCount) ? lo + width : lateCount;
+                int hi = (lo + width * 2 < lateCount) ? lo + width * 2 : lateCount;
+                int a = lo, b = mid, out = lo;
+                while (a < mid || b < hi) {
+                    if (b == hi || (a < mid && records[order[a]].timestamp <= records[order[b]].timestamp))
+                        scratch[out++] = order[a++];
+                    else
+                        scratch[out++] = order[b++];
+                }
+            }
+            for (int i = 0; i < lateCount; i++) order[i] = scratch[i];
+        }
+
+        Aircraft* rows = new Aircraft[lateCount];
+        for (int i = 0; i < lateCount; i++) rows[i] = records[order[i]];
+        try {
+            archive.insertLate(rows, lateCount);
+        }
+        catch (FileOperationException&) {
+            delete[] rows;
+            throw;
+        }
+        delete[] rows;
+    }
+
+    template <typename Visitor>
+    void forEach(Visitor& visit)
+    {
+        archive.forEachInRange(LONG_MIN, LONG_MAX, visit);
+        hot.forEach(visit);
+    }
+
+    // Records still held in memory, without touching the archive
+    template <typename Visitor>
+    void forEachRecent(Visitor& visit)
+    {
+        hot.forEach(visit);
+    }
+
+    template <typename Visitor>
+    void forEachInRange(long from, long to, Visitor& visit)
+    {
+        if (from < archive.getBoundary()) archive.forEachInRange(from, to, visit);
+        hot.forEachInRange(from, to, visit);
+    }
+
+    int rank(long ts) { return archive.rank(ts) + hot.rank(ts); }
+
+    bool select(int k, Aircraft& out)
+    {
+        int archived = archive.getCount();
+        if (k < archived) return archive.select(k, out);
+        return hot.select(k - archived, out);
+    }
+
+    int countInRange(long from, long to)
+    {
+        return (to > from) ? rank(to) - rank(from) : 0;
+    }
+
+    template <typename Visitor>
+    int forEachByFlight(const string& flightID, Visitor& visit)
+    {
+        auto match = [&flightID](const Aircraft& record) { return record.flightID == flightID; };
+        return archive.forEachWithKey(flightID, match, visit) + hot.forEachByFlight(flightID, visit);
+    }
+
+    template <typename Visitor>
+    int forEachByAirport(const string& airport, Visitor& visit)
+    {
+        auto match = [&airport](const Aircraft& record) {
+            return record.destination == airport || record.currentNode == airport;
+        };
+        return archive.forEachWithKey(airport, match, visit) + hot.forEachByAirport(airport, visit);
+    }
+
+    template <typename Visitor>
+    int forEachByModel(const string& model, Visitor& visit)
+    {
+        auto match = [&model](const Aircraft& record) { return record.model == model; };
+        return archive.forEachWithKey(model, match, visit) + hot.forEachByModel(model, visit);
+    }
+
+    bool hasLanded(const string& flightID)
+    {
+        if (hot.hasLanded(flightID)) return true;
+        auto ignore = [](const Aircraft&) {};
+        return forEachByFlight(flightID, ignore) > 0;
+    }
+
+    void printLog()
+    {
+        printLogHeader();
+        if (getCount() == 0) printEmptyLog();
+        else {
+            auto print = [](const Aircraft& record) { printLogEntry(record); };
+            forEach(print);
+        }
+        printLogFooter(getCount());
+    }
+
+    // Writes the hot window only; archived history is already on disk
+    void saveToFile(string filename)
+    {
+        hot.saveToFile(filename);
+    }
+
+    // Reopens the archive and reloads the hot window. Records older than
+    // the archive boundary are already archived and are skipped, so a
+    // legacy full-history file is migrated into the archive as it loads.
+    void loadFromFile(string filename)
+    {
+        ifstream file(filename);
+        if (!file.is_open()) throw FileOperationException(filename);
+
+        archive.open();
+        hot.clear();
+
+        string line;
+        getline(file, line);
+        int count = stoi(line);
+
+        for (int i = 0; i < count; i++) {
+            getline(file, line);
+            if (line.empty()) continue;
+            Aircraft record = Aircraft::fromString(line);
+            if (record.timestamp >= archive.getBoundary()) insert(record);
+        }
+        file.close();
+    }
+
+    void reserve(const Aircraft& incoming, int pending) { hot.reserve(incoming, pending); }
+
+    void waitForCompaction() { archive.waitForCompaction(); }
+
+    // Empties both tiers and deletes the archive's files
+    void removeArchive()
+    {
+        archive.removeFiles();
+        hot.clear();
+    }
+
+    int getCount() { return archive.getCount() + hot.getCount(); }
+    int getHotCount() { return hot.getCount(); }
+    int getArchivedCount() { return archive.getCount(); }
+    int getArchiveSegmentCount() { return archive.getSegmentCount(); }
+};
+
+// Flight log engine used by SkyNetATC
+typedef TieredFlightLog FlightLog;
+
+// ===== FLIGHT ANALYTICS =====
+// Landing statistics are kept up to date as each flight lands, so reports
+// never need to scan the flight log. Every read is O(1) or bounded by a
+// constant (ring buckets, digest centroids).
+
+// Counts events in a ring of fixed-width time buckets. Buckets older than
+// the ring are recycled as time moves on.
+class RollingCounter
+{
+private:
+    static const int MAX_BUCKETS = 60;
+
+    long bucketId[MAX_BUCKETS];
+    int counts[MAX_BUCKETS];
+    int bucketSeconds;
+    int bucketCount;
+
+public:
+    RollingCounter(int seconds = 3600, int buckets = 24) : bucketSeconds(seconds), bucketCount(buckets)
+    {
+        if (bucketCount > MAX_BUCKETS) bucketCount = MAX_BUCKETS;
+        clear();
+    }
+
+    void clear()
+    {
+        for (int i = 0; i < MAX_BUCKETS; i++) {
+            bucketId[i] = -1;
+            counts[i] = 0;
+        }
+    }
+
+    void add(long ts)
+    {
+        long id = ts / bucketSeconds;
+        int slot = (int)(id % bucketCount);
+        if (bucketId[slot] == id) counts[slot]++;
+        else if (bucketId[slot] < id) {
+            bucketId[slot] = id;
+            counts[slot] = 1;
+        }
+        // else: older than the ring, already expired
+    }
+
+    // Events in the last `buckets` buckets, up to and including the bucket of now
+    int countRecent(long now, int buckets)
+    {
+        long newest = now / bucketSeconds;
+        int total = 0;
+        for (int i = 0; i < bucketCount; i++) {
+            if (bucketId[i] <= newest && bucketId[i] > newest - buckets) total += counts[i];
+        }
+        return total;
+    }
+};
+
+// Merging t-digest (Dunning): a bounded set of weighted centroids that
+// answers quantile queries with small error at the tails. Samples are
+// buffered and merged in sorted batches.
+class TDigest
+{
+private:
+    static const int COMPRESSION = 100;
+    static const int BUFFER_SIZE = 500;
+    static const int CAPACITY = 4 * COMPRESSION + BUFFER_SIZE;
+
+    double means[CAPACITY];
+    double weights[CAPACITY];
+    int centroidCount;
+    double buffer[BUFFER_SIZE];
+    int buffered;
+    double totalWeight;
+    double minValue;
+    double maxValue;
+
+    static void sortValues(double* values, int count)
+    {
+        for (int gap = count / 2; gap > 0; gap /= 2) {
+            for (int i = gap; i < count; i++) {
+                double value = values[i];
+                int j = i;
+                while (j >= gap && values[j - gap] > value) {
+                    values[j] = values[j - gap];
+                    j -= gap;
+                }
+                values[j] = value;
+            }
+        }
+    }
+
+    // Scale function k1: a centroid may span at most one unit of k, which
+    // keeps centroids small near q = 0 and q = 1 and bounds their number
+    // by about COMPRESSION / 2
+    static double scale(double q) { return COMPRESSION * asin(2 * q - 1) / (2 * 3.14159265358979); }
+
+    // Merges the sorted buffer into the centroids
+    void compress()
+    {
+        if (buffered == 0) return;
+        sortValues(buffer, buffered);
+
+        double mergedMeans[CAPACITY];
+        double mergedWeights[CAPACITY];
+        int a = 0, b = 0, count = 0;
+        while (a < centroidCount || b < buffered) {
+            if (b == buffered || (a < centroidCount && means[a] <= buffer[b])) {
+                mergedMeans[count] = means[a];
+                mergedWeights[count++] = weights[a++];
+            }
+            else {
+                mergedMeans[count] = buffer[b++];
+                mergedWeights[count++] = 1;
+            }
+        }
+
+        totalWeight += buffered;
+        buffered = 0;
+        centroidCount = 0;
+        double before = 0;
+        for (int i = 0; i < count; i++) {
+            if (centroidCount > 0) {
+                double proposed = weights[centroidCount - 1] + mergedWeights[i];
+                if (scale((before + proposed) / totalWeight) - scale(before / totalWeight) <= 1) {
+                    double& mean = means[centroidCount - 1];
+                    mean += (mergedMeans[i] - mean) * mergedWeights[i] / proposed;
+                    weights[centroidCount - 1] = proposed;
+                    continue;
+                }
+                before += weights[centroidCount - 1];
+            }
+            means[centroidCount] = mergedMeans[i];
+            weights[centroidCount++] = mergedWeights[i];
+        }
+    }
+
+public:
+    TDigest() { clear(); }
+
+    void clear()
+    {
+        centroidCount = 0;
+        buffered = 0;
+        totalWeight = 0;
+        minValue = 0;
+        maxValue = 0;
+    }
+
+    void add(double value)
+    {
+        if (totalWeight == 0 && buffered == 0) minValue = maxValue = value;
+        if (value < minValue) minValue = value;
+        if (value > maxValue) maxValue = value;
+        buffer[buffered++] = value;
+        if (buffered == BUFFER_SIZE) compress();
+    }
+
+    // Approximate q-quantile (0 <= q <= 1), interpolated between centroid centres
+    double quantile(double q)
+    {
+        compress();
+        if (centroidCount == 0) return 0;
+        if (q <= 0) return minValue;
+        if (q >= 1) return maxValue;
+
+        double target = q * totalWeight;
+        double cumulative = 0;
+        double prevCentre = 0, prevMean = minValue;
+        for (int i = 0; i < centroidCount; i++) {
+            double centre = cumulative + weights[i] / 2;
+            if (target < centre) {
+                double span = centre - prevCentre;
+                double t = (span > 0) ? (target - prevCentre) / span : 0;
+                return prevMean + t * (means[i] - prevMean);
+            }
+            prevCentre = centre;
+            prevMean = means[i];
+            cumulative += weights[i];
+        }
+        double span = totalWeight - prevCentre;
+        double t = (span > 0) ? (target - prevCentre) / span : 1;
+        return prevMean + t * (maxValue - prevMean);
+    }
+};
+
+class AirportStats
+{
+public:
+    int landings;
+    double waitTotal;
+    int waitCount;
+    RollingCounter hourly;      // last 24 hours, one bucket per hour
+
+    AirportStats() : landings(0), waitTotal(0), waitCount(0), hourly(3600, 24) {}
+};
+
+class FlightLogAnalytics
+{
+public:
+    static const int MAX_PRIORITY = 4;
+
+private:
+    int landings;
+    int byPriority[MAX_PRIORITY + 1];
+    int emergencies;            // landed as CRITICAL or HIGH
+    RollingCounter perMinute;   // last hour, one bucket per minute
+
+    double waitTotal;
+    int waitCount;
+    double waitEwma;
+    TDigest waitDigest;
+
+    StringDictionary airportNames;
+    AirportStats* airports;
+    int airportCapacity;
+
+public:
+    static constexpr double EWMA_ALPHA = 0.1;
+
+    FlightLogAnalytics() : perMinute(60, 60), airportCapacity(8)
+    {
+        airports = new AirportStats[airportCapacity];
+        clear();
+    }
+
+    FlightLogAnalytics(const FlightLogAnalytics&) = delete;
+    FlightLogAnalytics& operator=(const FlightLogAnalytics&) = delete;
+
+    ~FlightLogAnalytics() { delete[] airports; }
+
+    void clear()
+    {
+        landings = 0;
+        emergencies = 0;
+        for (int p = 0; p <= MAX_PRIORITY; p++) byPriority[p] = 0;
+        perMinute.clear();
+        waitTotal = 0;
+        waitCount = 0;
+        waitEwma = 0;
+        waitDigest.clear();
+        airportNames.clear();
+        for (int i = 0; i < airportCapacity; i++) airports[i] = AirportStats();
+    }
+
+    // Folds one landing into every aggregate. O(1) amortized.
+    void record(const Aircraft& landed, const string& airport)
+    {
+        landings++;
+        int priority = landed.priority;
+        if (priority < 1) priority = 1;
+        if (priority > MAX_PRIORITY) priority = MAX_PRIORITY;
+        byPriority[priority]++;
+        if (priority <= 2) emergencies++;
+        perMinute.add(landed.timestamp);
+
+        int code = airportNames.encode(airport);
+        if (code >= airportCapacity) {
+            AirportStats* bigger = new AirportStats[airportCapacity * 2];
+            for (int i = 0; i < airportCapacity; i++) bigger[i] = airports[i];
+            delete[] airports;
+            airports = bigger;
+            airportCapacity *= 2;
+        }
+        AirportStats& stats = airports[code];
+        stats.landings++;
+        stats.hourly.add(landed.timestamp);
+
+        // Wait is only known for flights stamped when they joined the queue
+        if (landed.queuedAt > 0 && landed.timestamp >= landed.queuedAt) {
+            double wait = (double)(landed.timestamp - landed.queuedAt);
+            waitTotal += wait;
+            waitEwma = (waitCount == 0) ? wait : waitEwma + EWMA_ALPHA * (wait - waitEwma);
+            waitCount++;
+            waitDigest.add(wait);
+            stats.waitTotal += wait;
+            stats.waitCount++;
+        }
+    }
+
+    int getLandings() { return landings; }
+    int getPriorityCount(int priority) { return (priority >= 1 && priority <= MAX_PRIORITY) ? byPriority[priority] : 0; }
+    double getPriorityShare(int priority) { return landings ? (double)getPriorityCount(priority) / landings : 0; }
+    double getEmergencyRate() { return landings ? (double)emergencies / landings : 0; }
+    int getLandingsLastHour(long now) { return perMinute.countRecent(now, 60); }
+
+    // Wait from joining the landing queue to touchdown, in seconds
+    int getWaitSamples() { return waitCount; }
+    double getAverageWait() { return waitCount ? waitTotal / waitCount : 0; }
+    double getWaitEwma() { return waitEwma; }
+    double getWaitPercentile(double q) { return waitDigest.quantile(q); }
+
+    int getAirportCount() { return airportNames.getCount(); }
+    const string& getAirportName(int i) { return airportNames.decode(i); }
+    int findAirport(const string& airport) { return airportNames.find(airport); }
+    int getAirportLandings(int i) { return airports[i].landings; }
+    int getAirportLandingsRecent(int i, long now, int hours) { return airports[i].hourly.countRecent(now, hours); }
+    double getAirportAverageWait(int i) { return airports[i].waitCount ? airports[i].waitTotal / airports[i].waitCount : 0; }
+};
+
+// ===== RADAR MODEL =====
+// The radar keeps counts, not a picture. A CountPyramid tallies points per
+// 2^L x 2^L block of world coordinates for every level L, so a screen cell
+// at any power-of-two zoom is answered by one lookup and drawing costs
+// O(viewport cells), whatever the size of the airspace or the fleet.
+// World coordinates may range over +-2^27 on each axis.
+class CountPyramid
+{
+public:
+    static const int LEVELS = 24;
+
+private:
+    struct Slot
+    {
+        long long key;      // -1 marks an empty slot
+        int count;
+    };
+
+    Slot* slots;
+    int capacity;
+    int used;
+    long total;
+
+    static long long makeKey(int level, long cellX, long cellY)
+    {
+        return ((long long)level << 56) | ((long long)(cellX & 0xFFFFFFF) << 28) | (long long)(cellY & 0xFFFFFFF);
+    }
+
+    static unsigned long long mix(long long key)
+    {
+        unsigned long long h = (unsigned long long)key;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    int findSlot(long long key)
+    {
+        int i = (int)(mix(key) & (unsigned long long)(capacity - 1));
+        while (slots[i].key != -1 && slots[i].key != key) i = (i + 1) & (capacity - 1);
+        return i;
+    }
+
+    // Doubles the table, dropping blocks whose count has fallen to zero
+    void grow()
+    {
+        Slot* old = slots;
+        int oldCapacity = capacity;
+        capacity *= 2;
+        slots = new Slot[capacity];
+        for (int i = 0; i < capacity; i++) slots[i].key = -1;
+        used = 0;
+        for (int i = 0; i < oldCapacity; i++) {
+            if (old[i].key == -1 || old[i].count == 0) continue;
+            slots[findSlot(old[i].key)] = old[i];
+            used++;
+        }
+        delete[] old;
+    }
+
+public:
+    CountPyramid() : capacity(256), used(0), total(0)
+    {
+        slots = new Slot[capacity];
+        for (int i = 0; i < capacity; i++) slots[i].key = -1;
+    }
+
+    ~CountPyramid() { delete[] slots; }
+
+    CountPyramid(const CountPyramid&) = delete;
+    CountPyramid& operator=(const CountPyramid&) = delete;
+
+    // Adds delta at (x, y) on every level. O(LEVELS).
+    void add(long x, long y, int delta)
+    {
+        for (int level = 0; level < LEVELS; level++) {
+            if (used * 10 >= capacity * 7) grow();
+            long long key = makeKey(level, x >> level, y >> level);
+            int i = findSlot(key);
+            if (slots[i].key == -1) {
+                slots[i].key = key;
+                slots[i].count = 0;
+                used++;
+            }
+            slots[i].count += delta;
+        }
+        total += delta;
+    }
+
+    // Points in block (cellX, cellY) of size 2^level
+    int count(int level, long cellX, long cellY)
+    {
+        int i = findSlot(makeKey(level, cellX, cellY));
+        return (slots[i].key == -1) ? 0 : slots[i].count;
+    }
+
+    long getTotal() { return total; }
+
+    // Becomes a copy of other. O(other's table size).
+    void copyFrom(const CountPyramid& other)
+    {
+        if (capacity != other.capacity) {
+            delete[] slots;
+            slots = new Slot[other.capacity];
+            capacity = other.capacity;
+        }
+        for (int i = 0; i < capacity; i++) slots[i] = other.slots[i];
+        used = other.used;
+        total = other.total;
+    }
+
+    void clear()
+    {
+        for (int i = 0; i < capacity; i++) slots[i].key = -1;
+        used = 0;
+        total = 0;
+    }
+};
+
+// Aircraft positions plus the fixed airports and waypoints, each in its own
+// pyramid, and the bounding box of everything placed so far
+class RadarModel
+{
+private:
+    CountPyramid traffic;
+    CountPyramid airports;
+    CountPyramid waypoints;
+    long minX, maxX, minY, maxY;
+    bool hasBounds;
+
+    void extendBounds(long x, long y)
+    {
+        if (!hasBounds) {
+            minX = maxX = x;
+            minY = maxY = y;
+            hasBounds = true;
+            return;
+        }
+        if (x < minX) minX = x;
+        if (x > maxX) maxX = x;
+        if (y < minY) minY = y;
+        if (y > maxY) maxY = y;
+    }
+
+public:
+    RadarModel() : minX(0), maxX(0), minY(0), maxY(0), hasBounds(false) {}
+
+    void addFeature(long x, long y, bool isAirport)
+    {
+        (isAirport ? airports : waypoints).add(x, y, 1);
+        extendBounds(x, y);
+    }
+
+    void addAircraft(long x, long y)
+    {
+        traffic.add(x, y, 1);
+        extendBounds(x, y);
+    }
+
+    void removeAircraft(long x, long y) { traffic.add(x, y, -1); }
+
+    void moveAircraft(long fromX, long fromY, long toX, long toY)
+    {
+        removeAircraft(fromX, fromY);
+        addAircraft(toX, toY);
+    }
+
+    void clearTraffic() { traffic.clear(); }
+
+    int trafficAt(int level, long cellX, long cellY) { return traffic.count(level, cellX, cellY); }
+    const CountPyramid& getTraffic() { return traffic; }
+    int airportsAt(int level, long cellX, long cellY) { return airports.count(level, cellX, cellY); }
+    int waypointsAt(int level, long cellX, long cellY) { return waypoints.count(level, cellX, cellY); }
+    long getAircraftCount() { return traffic.getTotal(); }
+
+    bool getBounds(long& x0, long& x1, long& y0, long& y1)
+    {
+        x0 = minX; x1 = maxX; y0 = minY; y1 = maxY;
+        return hasBounds;
+    }
+};
+
+// A rows x cols window onto the radar. Each screen cell covers a
+// 2^level x 2^level block; the window's top-left block is (cellX, cellY).
+// Rows follow world x and columns world y, as the airspace grid always has.
+class RadarViewport
+{
+public:
+    int rows;
+    int cols;
+    int level;
+    long cellX;
+    long cellY;
+
+    RadarViewport(int r, int c) : rows(r), cols(c), level(0), cellX(0), cellY(0) {}
+
+    void pan(int dRows, int dCols)
+    {
+        cellX += dRows;
+        cellY += dCols;
+    }
+
+    // Changes the zoom level, keeping the world point at the centre in place
+    void zoomTo(int newLevel)
+    {
+        if (newLevel < 0) newLevel = 0;
+        if (newLevel >= CountPyramid::LEVELS) newLevel = CountPyramid::LEVELS - 1;
+        long centreX = (cellX + rows / 2) * getCellSpan();
+        long centreY = (cellY + cols / 2) * getCellSpan();
+        level = newLevel;
+        cellX = (centreX >> level) - rows / 2;
+        cellY = (centreY >> level) - cols / 2;
+    }
+
+    void zoomIn() { zoomTo(level - 1); }
+    void zoomOut() { zoomTo(level + 1); }
+
+    // Smallest zoom that shows the whole box [x0, x1] x [y0, y1], centred
+    void fit(long x0, long x1, long y0, long y1)
+    {
+        level = 0;
+        while (level < CountPyramid::LEVELS - 1 &&
+            ((x1 >> level) - (x0 >> level) >= rows || (y1 >> level) - (y0 >> level) >= cols))
+            level++;
+        long spanX = (x1 >> level) - (x0 >> level) + 1;
+        long spanY = (y1 >> level) - (y0 >> level) + 1;
+        cellX = (x0 >> level) - (rows - spanX) / 2;
+        cellY = (y0 >> level) - (cols - spanY) / 2;
+    }
+
+    long getWorldX() { return cellX * getCellSpan(); }
+    long getWorldY() { return cellY * getCellSpan(); }
+    long getCellSpan() { return 1L << level; }
+};
+
+// ===== GRAPH =====
+class GraphNode
+{
+public:
+    string name;
+    int x;
+    int y;
+    bool isAirport;
+
+    GraphNode(string n, int px, int py, bool airport = false)
+        : name(n), x(px), y(py), isAirport(airport) {
+    }
+};
+
+class Edge
+{
+public:
+    string destination;
+    int weight;
+    Edge* next;
+
+    Edge(string dest, int w) : destination(dest), weight(w), next(NULL) {}
+};
+
+// Node occupancy is a bitset indexed by node ID with a parallel owner
+// array, so an occupancy test is one bit test and sector-wide questions
+// ("is anything in here occupied?") are word-wide scans against a node mask.
+// An attached RadarModel is kept in step on every occupy and free, so the
+// radar's traffic layer is derived from occupancy, never drawn by hand.
+class Graph
+{
+private:
+    DynamicArray<GraphNode*> nodes;
+    DynamicArray<Edge*> adjList;
+    int nodeCount;
+    NodePool<Edge> edgePool;
+    StringDictionary nodeIds;       // name -> node ID, in insertion order
+    Bitset occupancy;
+    DynamicArray<string> owners;    // flight occupying each node
+    RadarModel* radar;
+
+    int findNodeIndex(const string& name)
+    {
+        return nodeIds.find(name);
+    }
+
+    void release(int idx)
+    {
+        if (!occupancy.test(idx)) return;
+        occupancy.reset(idx);
+        owners[idx].clear();
+        if (radar != NULL) radar->removeAircraft(nodes[idx]->x, nodes[idx]->y);
+    }
+
+    int minDistance(int dist[], bool visited[])
+    {
+        int min = INT_MAX;
+        int min_index = -1;
+
+        for (int i = 0; i < nodeCount; i++)
+            if (!visited[i] && dist[i] <= min) {
+                min = dist[i];
+                min_index = i;
+            }
+        return min_index;
+    }
+
+    void clearEdges(Edge* edge)
+    {
+        while (edge != NULL) {
+            Edge* temp = edge;
+            edge = edge->next;
+            edgePool.discard(temp);
+        }
+    }
+
+public:
+    Graph() : nodeCount(0), radar(NULL) {}
+
+    ~Graph()
+    {
+        for (int i = 0; i < nodeCount; i++) {
+            delete nodes[i];
+            clearEdges(adjList[i]);
+        }
+    }
+
+    void addNode(string name, int x, int y, bool isAirport = false)
+    {
+        if (findNodeIndex(name) != -1) return;
+
+        nodeIds.encode(name);
+        nodes.push(new GraphNode(name, x, y, isAirport));
+        adjList.push(NULL);
+        owners.push("");
+        nodeCount++;
+        occupancy.resize(nodeCount);
+    }
+
+    void addEdge(string src, string dest, int weight)
+    {
+        int srcIdx = findNodeIndex(src);
+        int destIdx = findNodeIndex(dest);
+
+        if (srcIdx == -1 || destIdx == -1) return;
+
+        Edge* newEdge = edgePool.create(dest, weight);
+        newEdge->next = adjList[srcIdx];
+        adjList[srcIdx] = newEdge;
+    }
+
+    bool isNodeOccupied(string nodeName)
+    {
+        int idx = findNodeIndex(nodeName);
+        return (idx != -1) ? occupancy.test(idx) : false;
+    }
+
+    bool isNodeReachable(string from, string to)
+    {
+        int fromIdx = findNodeIndex(from);
+        if (fromIdx == -1) return false;
+
+        Edge* edge = adjList[fromIdx];
+        while (edge != NULL) {
+            if (edge->destination == to) return true;
+            edge = edge->next;
+        }
+        return false;
+    }
+
+    NodePool<Edge>& getEdgePool() { return edgePool; }
+
+    // Weight of the direct edge from -> to, or -1 if there is none
+    int getEdgeWeight(string from, string to)
+    {
+        int fromIdx = findNodeIndex(from);
+        if (fromIdx == -1) return -1;
+
+        for (Edge* edge = adjList[fromIdx]; edge != NULL; edge = edge->next)
+            if (edge->destination == to) return edge->weight;
+        return -1;
+    }
+
+    AtcStatus tryOccupyNode(const string& nodeName, const string& flightID)
+    {
+        int idx = findNodeIndex(nodeName);
+        if (idx == -1) return ATC_UNKNOWN_NODE;
+        return tryOccupyAt(idx, flightID);
+    }
+
+    // Same as tryOccupyNode, for callers that already hold the node ID
+    AtcStatus tryOccupyAt(int idx, const string& flightID)
+    {
+        if (occupancy.test(idx)) return ATC_OCCUPIED;
+
+        occupancy.set(idx);
+        owners[idx] = flightID;
+        if (radar != NULL) radar->addAircraft(nodes[idx]->x, nodes[idx]->y);
+        return ATC_OK;
+    }
+
+    bool occupyNode(string nodeName, string flightID)
+    {
+        AtcStatus status = tryOccupyNode(nodeName, flightID);
+        if (status == ATC_OCCUPIED) {
+            GraphNode* node = nodes[findNodeIndex(nodeName)];
+            throw CollisionException("(" + toString(node->x) + ", " + toString(node->y) + ")");
+        }
+        return status == ATC_OK;
+    }
+
+    void freeNode(string nodeName)
+    {
+        int idx = findNodeIndex(nodeName);
+        if (idx != -1) release(idx);
+    }
+
+    void freeNodeAt(int idx) { release(idx); }
+
+    // Frees every node, a word at a time
+    void clearOccupancy()
+    {
+        for (int idx = occupancy.nextSet(0); idx != -1; idx = occupancy.nextSet(idx + 1)) release(idx);
+    }
+
+    // Radar whose traffic layer mirrors occupancy from now on
+    void attachRadar(RadarModel* model)
+    {
+        radar = model;
+        if (radar == NULL) return;
+        for (int idx = occupancy.nextSet(0); idx != -1; idx = occupancy.nextSet(idx + 1))
+            radar->addAircraft(nodes[idx]->x, nodes[idx]->y);
+    }
+
+    bool isOccupied(int idx) { return occupancy.test(idx); }
+    int nextOccupied(int from) { return occupancy.nextSet(from); }
+    const string& getOccupant(int idx) { return owners[idx]; }
+    int getOccupiedCount() { return occupancy.count(); }
+
+    // Any occupied node among those set in sector (a mask by node ID)
+    bool anyOccupied(const Bitset& sector) { return occupancy.intersects(sector); }
+    int countOccupied(const Bitset& sector) { return occupancy.countAnd(sector); }
+
+    int getNodeCount() { return nodeCount; }
+    int getNodeIndex(const string& name) { return findNodeIndex(name); }
+    Edge* getEdges(int idx) { return adjList[idx]; }
+
+    // Dijkstra from startIdx into dist and parent (nodeCount entries each),
+    // stopping once endIdx is settled
+    void shortestPaths(int startIdx, int endIdx, int* dist, int* parent)
+    {
+        ScratchScope scope;
+        bool* visited = scratchArena().allocate<bool>(nodeCount);
+
+        for (int i = 0; i < nodeCount; i++) {
+            dist[i] = INT_MAX;
+            visited[i] = false;
+            parent[i] = -1;
+        }
+
+        dist[startIdx] = 0;
+
+        for (int count = 0; count < nodeCount - 1; count++) {
+            int u = minDistance(dist, visited);
+            if (u == -1 || u == endIdx) break;
+
+            visited[u] = true;
+
+            Edge* edge = adjList[u];
+            while (edge != NULL) {
+                int v = findNodeIndex(edge->destination);
+                if (v != -1 && !visited[v] && dist[u] != INT_MAX &&
+                    dist[u] + edge->weight < dist[v]) {
+                    dist[v] = dist[u] + edge->weight;
+                    parent[v] = u;
+                }
+                edge = edge->next;
+            }
+        }
+    }
+
+    // NEW: Get full Dijkstra path as array (for step-by-step movement)
+    // Fills the path (room for getNodeCount() names) and its total distance
+    AtcStatus tryGetDijkstraPath(const string& start, const string& end, string path[], int& pathCount, int& distance)
+    {
+        int startIdx = findNodeIndex(start);
+        int endIdx = findNodeIndex(end);
+
+        if (startIdx == -1 || endIdx == -1) return ATC_UNKNOWN_NODE;
+
+        ScratchScope scope;
+        int* dist = scratchArena().allocate<int>(nodeCount);
+        int* parent = scratchArena().allocate<int>(nodeCount);
+        shortestPaths(startIdx, endIdx, dist, parent);
+
+        if (dist[endIdx] == INT_MAX) return ATC_NO_PATH;
+
+        // Build path
+        pathCount = 0;
+        int current = endIdx;
+        while (current != -1) {
+            path[pathCount++] = nodes[current]->name;
+            current = parent[current];
+        }
+
+        // Reverse path (currently end->start)
+        for (int i = 0; i < pathCount / 2; i++)
+            path[i].swap(path[pathCount - 1 - i]);
+        distance = dist[endIdx];
+        return ATC_OK;
+    }
+
+    // Length of the shortest path only, for callers that never walk it
+    AtcStatus tryGetDistance(const string& start, const string& end, int& distance)
+    {
+        int startIdx = findNodeIndex(start);
+        int endIdx = findNodeIndex(end);
+
+        if (startIdx == -1 || endIdx == -1) return ATC_UNKNOWN_NODE;
+
+        ScratchScope scope;
+        int* dist = scratchArena().allocate<int>(nodeCount);
+        int* parent = scratchArena().allocate<int>(nodeCount);
+        shortestPaths(startIdx, endIdx, dist, parent);
+
+        if (dist[endIdx] == INT_MAX) return ATC_NO_PATH;
+        distance = dist[endIdx];
+        return ATC_OK;
+    }
+
+    // Returns the total distance
+    int getDijkstraPath(const string& start, const string& end, string path[], int& pathCount)
+    {
+        int distance = 0;
+        AtcStatus status = tryGetDijkstraPath(start, end, path, pathCount, distance);
+        if (status == ATC_UNKNOWN_NODE) throw InvalidInputException("Node name");
+        if (status == ATC_NO_PATH) throw NoPathException(start, end);
+        return distance;
+    }
+
+    void dijkstra(string start, string end)
+    {
+        int startIdx = findNodeIndex(start);
+        int endIdx = findNodeIndex(end);
+
+        if (startIdx == -1 || endIdx == -1)
+            throw InvalidInputException("Node name");
+
+        ScratchScope scope;
+        int* dist = scratchArena().allocate<int>(nodeCount);
+        bool* visited = scratchArena().allocate<bool>(nodeCount);
+        int* parent = scratchArena().allocate<int>(nodeCount);
+        string* pathNodes = scratchArena().allocate<string>(nodeCount);
+        int pathCount = 0;
+
+        for (int i = 0; i < nodeCount; i++) {
+            dist[i] = INT_MAX;
+            visited[i] = false;
+            parent[i] = -1;
+        }
+
+        dist[startIdx] = 0;
+
+        for (int count = 0; count < nodeCount - 1; count++) {
+            int u = minDistance(dist, visited);
+            if (u == -1) break;
+
+            visited[u] = true;
+
+            Edge* edge = adjList[u];
+            while (edge != NULL) {
+                int v = findNodeIndex(edge->destination);
+                if (v != -1 && !visited[v] && dist[u] != INT_MAX &&
+                    dist[u] + edge->weight < dist[v]) {
+                    dist[v] = dist[u] + edge->weight;
+                    parent[v] = u;
+                }
+                edge = edge->next;
+            }
+        }
+
+        if (dist[endIdx] == INT_MAX)
+            throw NoPathException(start, end);
+
+        setColor(COLOR_HEADER);
+        cout << "\n|||===========================================================|||\n";
+        cout << "|||           DIJKSTRA'S SHORTEST PATH ALGORITHM              |||\n";
+        cout << "|||===========================================================|||\n";
+        setColor(COLOR_RESET);
+
+        setColor(COLOR_INFO);
+        cout << "  From: ";
+        setColor(MENU);
+        cout << start;
+        setColor(COLOR_INFO);
+        cout << "  ->  To: ";
+        setColor(MENU);
+        cout << end << endl;
+
+        setColor(COLOR_SUCCESS);
+        cout << "  Total Distance: ";
+        setColor(MENU);
+        cout << dist[endIdx] << " km\n";
+
+        setColor(COLOR_INFO);
+        cout << "  Route: ";
+        setColor(COLOR_RESET);
+
+        int current = endIdx;
+        while (current != -1) {
+            pathNodes[pathCount++] = nodes[current]->name;
+            current = parent[current];
+        }
+
+        for (int i = pathCount - 1; i >= 0; i--) {
+            setColor(MENU);
+            cout << pathNodes[i];
+            if (i > 0) {
+                setColor(COLOR_SUBTITLE);
+                cout << " -> ";
+            }
+        }
+        cout << endl;
+        setColor(COLOR_RESET);
+    }
+
+    string findNearestAirport(string startNode)
+    {
+        int startIdx = findNodeIndex(startNode);
+        if (startIdx == -1) return "";
+
+        ScratchScope scope;
+        int* dist = scratchArena().allocate<int>(nodeCount);
+        bool* visited = scratchArena().allocate<bool>(nodeCount);
+
+        for (int i = 0; i < nodeCount; i++) {
+            dist[i] = INT_MAX;
+            visited[i] = false;
+        }
+
+        dist[startIdx] = 0;
+
+        for (int count = 0; count < nodeCount - 1; count++) {
+            int u = minDistance(dist, visited);
+            if (u == -1) break;
+
+            visited[u] = true;
+
+            Edge* edge = adjList[u];
+            while (edge != NULL) {
+                int v = findNodeIndex(edge->destination);
+                if (v != -1 && !visited[v] && dist[u] != INT_MAX &&
+                    dist[u] + edge->weight < dist[v]) {
+                    dist[v] = dist[u] + edge->weight;
+                }
+                edge = edge->next;
+            }
+        }
+
+        int nearestIdx = -1;
+        int minDist = INT_MAX;
+
+        for (int i = 0; i < nodeCount; i++) {
+            if (nodes[i]->isAirport && dist[i] < minDist && dist[i] != INT_MAX) {
+                minDist = dist[i];
+                nearestIdx = i;
+            }
+        }
+
+        return (nearestIdx != -1) ? nodes[nearestIdx]->name : "";
+    }
+
+    GraphNode* getNodeAt(int i) { return nodes[i]; }
+
+    GraphNode* getNodeByName(string name)
+    {
+        int idx = findNodeIndex(name);
+        return (idx != -1) ? nodes[idx] : NULL;
+    }
+
+    void getAirports(DynamicArray<string>& airportList)
+    {
+        airportList.clear();
+        for (int i = 0; i < nodeCount; i++) {
+            if (nodes[i]->isAirport)
+                airportList.push(nodes[i]->name);
+        }
+    }
+
+    void checkAllCollisions()
+    {
+        bool collision = false;
+        for (int i = occupancy.nextSet(0); i != -1; i = occupancy.nextSet(i + 1)) {
+            for (int j = occupancy.nextSet(i + 1); j != -1; j = occupancy.nextSet(j + 1)) {
+                if (abs(nodes[i]->x - nodes[j]->x) <= 1 &&
+                    abs(nodes[i]->y - nodes[j]->y) <= 1) {
+                    setColor(COLOR_DANGER);
+                    cout << "  WARNING: Collision between " << owners[i]
+                        << " and " << owners[j] << "!\n";
+                    setColor(COLOR_RESET);
+                    collision = true;
+                }
+            }
+        }
+        if (!collision) {
+            setColor(COLOR_SUCCESS);
+            cout << "  No collisions detected.\n";
+            setColor(COLOR_RESET);
+        }
+    }
+};
+
+// ===== SECTORS =====
+// The airspace split into sectors that run side by side, one thread each.
+// A sector owns the aircraft, node occupancy and landing queues of its part
+// of the graph and touches nothing else. Aircraft crossing a boundary are
+// handed to the neighbouring sector through a lock-free single-producer /
+// single-consumer queue, and routing questions go to tables the
+// coordinator builds once up front and only reads while sectors run.
+
+// Bounded lock-free ring for exactly one producer thread and one consumer
+// thread. head and tail are kept on separate cache lines so the two sides
+// do not bounce one line between cores.
+template <typename T>
+class SpscQueue
+{
+private:
+    static const int CACHE_LINE = 64;
+
+    T* slots;
+    unsigned int mask;
+    std::atomic<unsigned int> head;     // next slot to read, advanced by the consumer
+    char padding[CACHE_LINE];
+    std::atomic<unsigned int> tail;     // next slot to write, advanced by the producer
+
+public:
+    // capacity is rounded up to a power of two
+    SpscQueue(int capacity) : head(0), tail(0)
+    {
+        unsigned int size = 2;
+        while (size < (unsigned int)capacity) size *= 2;
+        slots = new T[size];
+        mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    ~SpscQueue() { delete[] slots; }
+
+    // Producer side; false if the ring is full
+    bool tryPush(const T& item)
+    {
+        unsigned int t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) > mask) return false;
+        slots[t & mask] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; false if the ring is empty
+    bool tryPop(T& item)
+    {
+        unsigned int h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        item = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Exact only when neither side is running
+    int getSize() { return (int)(tail.load() - head.load()); }
+    int getCapacity() { return (int)mask + 1; }
+};
+
+// Reusable barrier that ends a tick once every sector thread has arrived.
+// Waiters spin with a yield; a tick is long next to the wait.
+class TickBarrier
+{
+private:
+    int parties;
+    std::atomic<int> waiting;
+    std::atomic<int> generation;
+
+public:
+    TickBarrier(int count) : parties(count), waiting(0), generation(0) {}
+
+    void arrive()
+    {
+        int gen = generation.load(std::memory_order_acquire);
+        if (waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == parties) {
+            waiting.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        while (generation.load(std::memory_order_acquire) == gen) std::this_thread::yield();
+    }
+};
+
+// Occupancy of boundary nodes as other sectors see it: a bitset of atomic
+// words by global node ID. Each bit is written only by the sector owning
+// the node and read by its neighbours, which may be other threads or,
+// when the words live in shared memory, other processes.
+class SharedOccupancy
+{
+private:
+    std::atomic<unsigned long long>* words;
+    int bits;
+
+public:
+    SharedOccupancy() : words(NULL), bits(0) {}
+
+    static int wordsFor(int bitCount) { return (bitCount + 63) / 64; }
+
+    // storage holds wordsFor(bitCount) words and outlives this view
+    void attach(std::atomic<unsigned long long>* storage, int bitCount)
+    {
+        words = storage;
+        bits = bitCount;
+    }
+
+    bool test(int i)
+    {
+        return ((words[i >> 6].load(std::memory_order_relaxed) >> (i & 63)) & 1) != 0;
+    }
+
+    void assign(int i, bool value)
+    {
+        if (test(i) == value) return;
+        unsigned long long mask = 1ULL << (i & 63);
+        if (value) words[i >> 6].fetch_or(mask, std::memory_order_relaxed);
+        else words[i >> 6].fetch_and(~mask, std::memory_order_relaxed);
+    }
+
+    int size() { return bits; }
+};
+
+// Aircraft crossing into another sector, already placed on the entry node
+class SectorHandoff
+{
+public:
+    Aircraft aircraft;
+    int node;       // global ID of the entry node
+
+    SectorHandoff() : node(-1) {}
+};
+
+// Partition of a graph into sectors plus the shared routing tables. Nodes
+// are split into vertical strips with equal node counts. For every airport
+// the map keeps each node's shortest distance to it, so the next hop from
+// anywhere is a scan of that node's edges. Nothing changes after
+// construction, so any number of sector threads may read it at once.
+class SectorMap
+{
+private:
+    static const int UNREACHABLE = INT_MAX;
+
+    Graph& graph;
+    int nodeCount;
+    int sectorCount;
+    int* sectorOf;          // node ID -> sector
+    int* localId;           // node ID -> index in its sector's graph
+
+    // Edges by node ID, forward and reversed (compressed rows)
+    int* edgeStart;
+    int* edgeTarget;
+    int* edgeWeight;
+    int* reverseStart;
+    int* reverseSource;
+    int* reverseWeight;
+
+    StringDictionary airportSlots;  // airport name -> slot
+    DynamicArray<int> airportNodes; // slot -> node ID
+    int* distance;                  // [slot * nodeCount + node] -> distance to that airport
+
+    static void sortByPosition(int* ids, int count, Graph& g)
+    {
+        for (int gap = count / 2; gap > 0; gap /= 2) {
+            for (int i = gap; i < count; i++) {
+                int id = ids[i];
+                GraphNode* node = g.getNodeAt(id);
+                int j = i;
+                while (j >= gap) {
+                    GraphNode* other = g.getNodeAt(ids[j - gap]);
+                    if (other->x < node->x || (other->x == node->x && other->y <= node->y)) break;
+                    ids[j] = ids[j - gap];
+                    j -= gap;
+                }
+                ids[j] = id;
+            }
+        }
+    }
+
+    void buildEdges()
+    {
+        int edgeCount = 0;
+        edgeStart = new int[nodeCount + 1];
+        reverseStart = new int[nodeCount + 1];
+        for (int u = 0; u <= nodeCount; u++) reverseStart[u] = 0;
+        for (int u = 0; u < nodeCount; u++) {
+            edgeStart[u] = edgeCount;
+            for (Edge* edge = graph.getEdges(u); edge != NULL; edge = edge->next) {
+                int v = graph.getNodeIndex(edge->destination);
+                if (v == -1) continue;
+                edgeCount++;
+                reverseStart[v + 1]++;
+            }
+        }
+        edgeStart[nodeCount] = edgeCount;
+        for (int v = 0; v < nodeCount; v++) reverseStart[v + 1] += reverseStart[v];
+
+        edgeTarget = new int[edgeCount > 0 ? edgeCount : 1];
+        edgeWeight = new int[edgeCount > 0 ? edgeCount : 1];
+        reverseSource = new int[edgeCount > 0 ? edgeCount : 1];
+        reverseWeight = new int[edgeCount > 0 ? edgeCount : 1];
+
+        ScratchScope scope;
+        int* fill = scratchArena().allocate<int>(nodeCount);
+        for (int v = 0; v < nodeCount; v++) fill[v] = reverseStart[v];
+        int e = 0;
+        for (int u = 0; u < nodeCount; u++) {
+            for (Edge* edge = graph.getEdges(u); edge != NULL; edge = edge->next) {
+                int v = graph.getNodeIndex(edge->destination);
+                if (v == -1) continue;
+                edgeTarget[e] = v;
+                edgeWeight[e++] = edge->weight;
+                reverseSource[fill[v]] = u;
+                reverseWeight[fill[v]++] = edge->weight;
+            }
+        }
+    }
+
+    // Dijkstra from target over the reversed edges, with a lazy binary heap
+    // of (distance << 32 | node) keys
+    void distancesTo(int target, int* dist)
+    {
+        for (int u = 0; u < nodeCount; u++) dist[u] = UNREACHABLE;
+
+        ScratchScope scope;
+        int heapCapacity = edgeStart[nodeCount] + 1;
+        long long* heap = scratchArena().allocate<long long>(heapCapacity);
+        int heapSize = 0;
+
+        dist[target] = 0;
+        heap[heapSize++] = target;
+        while (heapSize > 0) {
+            long long top = heap[0];
+            long long last = heap[--heapSize];
+            int i = 0;
+            while (true) {
+                int child = 2 * i + 1;
+                if (child >= heapSize) break;
+                if (child + 1 < heapSize && heap[child + 1] < heap[child]) child++;
+                if (heap[child] >= last) break;
+                heap[i] = heap[child];
+                i = child;
+            }
+            heap[i] = last;
+
+            int v = (int)(top & 0xFFFFFFFF);
+            int d = (int)(top >> 32);
+            if (d != dist[v]) continue;
+            for (int e = reverseStart[v]; e < reverseStart[v + 1]; e++) {
+                int u = reverseSource[e];
+                if (d + reverseWeight[e] >= dist[u]) continue;
+                dist[u] = d + reverseWeight[e];
+                long long key = ((long long)dist[u] << 32) | u;
+                int j = heapSize++;
+                while (j > 0 && heap[(j - 1) / 2] > key) {
+                    heap[j] = heap[(j - 1) / 2];
+                    j = (j - 1) / 2;
+                }
+                heap[j] = key;
+            }
+        }
+    }
+
+public:
+    SectorMap(Graph& g, int sectors) : graph(g), nodeCount(g.getNodeCount()), sectorCount(sectors)
+    {
+        if (sectorCount < 1) throw InvalidInputException("Sector count");
+
+        sectorOf = new int[nodeCount > 0 ? nodeCount : 1];
+        localId = new int[nodeCount > 0 ? nodeCount : 1];
+        {
+            ScratchScope scope;
+            int* order = scratchArena().allocate<int>(nodeCount);
+            for (int i = 0; i < nodeCount; i++) order[i] = i;
+            sortByPosition(order, nodeCount, graph);
+            for (int rank = 0; rank < nodeCount; rank++)
+                sectorOf[order[rank]] = (int)((long long)rank * sectorCount / nodeCount);
+
+            int* nextLocal = scratchArena().allocate<int>(sectorCount);
+            for (int s = 0; s < sectorCount; s++) nextLocal[s] = 0;
+            for (int i = 0; i < nodeCount; i++) localId[i] = nextLocal[sectorOf[i]]++;
+        }
+
+        buildEdges();
+
+        for (int i = 0; i < nodeCount; i++) {
+            if (!graph.getNodeAt(i)->isAirport) continue;
+            airportSlots.encode(graph.getNodeAt(i)->name);
+            airportNodes.push(i);
+        }
+        int airportCount = airportNodes.size();
+        distance = new int[airportCount > 0 ? (long long)airportCount * nodeCount : 1];
+        for (int slot = 0; slot < airportCount; slot++)
+            distancesTo(airportNodes[slot], distance + (long long)slot * nodeCount);
+    }
+
+    SectorMap(const SectorMap&) = delete;
+    SectorMap& operator=(const SectorMap&) = delete;
+
+    ~SectorMap()
+    {
+        delete[] sectorOf;
+        delete[] localId;
+        delete[] edgeStart;
+        delete[] edgeTarget;
+        delete[] edgeWeight;
+        delete[] reverseStart;
+        delete[] reverseSource;
+        delete[] reverseWeight;
+        delete[] distance;
+    }
+
+    Graph& getGraph() { return graph; }
+    int getNodeCount() { return nodeCount; }
+    int getSectorCount() { return sectorCount; }
+    int getSector(int node) { return sectorOf[node]; }
+    int getLocalId(int node) { return localId[node]; }
+
+    int getAirportCount() { return airportNodes.size(); }
+    int findAirport(const string& name) { return airportSlots.find(name); }
+    const string& getAirportName(int slot) { return airportSlots.decode(slot); }
+    int getAirportNode(int slot) { return airportNodes[slot]; }
+
+    int edgeBegin(int node) { return edgeStart[node]; }
+    int edgeEnd(int node) { return edgeStart[node + 1]; }
+    int getEdgeTarget(int e) { return edgeTarget[e]; }
+    int getEdgeWeight(int e) { return edgeWeight[e]; }
+
+    // Shortest distance from node to the airport in slot, INT_MAX if unreachable
+    int getDistance(int slot, int node) { return distance[(long long)slot * nodeCount + node]; }
+
+    // Whether edge e (leaving node) lies on a shortest path to the airport
+    bool onShortestPath(int slot, int node, int e)
+    {
+        int here = getDistance(slot, node);
+        int there = getDistance(slot, edgeTarget[e]);
+        return here != UNREACHABLE && there != UNREACHABLE && there + edgeWeight[e] == here;
+    }
+
+    // First hop from node towards the airport: node itself on arrival,
+    // -1 if the airport cannot be reached
+    int nextHop(int slot, int node)
+    {
+        if (getDistance(slot, node) == 0) return node;
+        for (int e = edgeStart[node]; e < edgeStart[node + 1]; e++)
+            if (onShortestPath(slot, node, e)) return edgeTarget[e];
+        return -1;
+    }
+};
+
+// One sector: the nodes of its strip, the aircraft flying over them and
+// the landing queues of its airports. Only the sector's own thread calls
+// tick(); other sectors reach it through its inbound queues alone.
+class Sector
+{
+private:
+    int id;
+    SectorMap& map;
+    Graph airspace;                         // this sector's nodes; routing uses the map
+    DynamicArray<int> globalIds;            // local node ID -> global node ID
+    HashTable aircraft;                     // airborne in this sector, by flight ID
+    LandingScheduler landings;
+    DynamicArray<SectorHandoff> holding;    // waiting for their entry node to clear
+    SpscQueue<SectorHandoff>** inbound;     // [from sector], NULL if not a neighbour
+    SpscQueue<SectorHandoff>** outbound;    // [to sector], NULL if not a neighbour
+    SharedOccupancy* boundary;              // neighbours' view of boundary nodes, if shared
+    DynamicArray<int> boundaryNodes;        // local IDs of nodes with an edge into another sector
+
+    long clock;
+    unsigned int rng;
+    bool turnaround;
+
+    long moves;
+    long blocked;
+    long handoffsIn;
+    long handoffsOut;
+    long landed;
+
+    unsigned int nextRandom()
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return rng;
+    }
+
+    void place(Aircraft& flight, int node)
+    {
+        GraphNode* target = map.getGraph().getNodeAt(node);
+        flight.currentNode = target->name;
+        flight.x = target->x;
+        flight.y = target->y;
+    }
+
+    void receive()
+    {
+        SectorHandoff arriving;
+        for (int s = 0; s < map.getSectorCount(); s++) {
+            if (inbound[s] == NULL) continue;
+            while (inbound[s]->tryPop(arriving)) {
+                holding.push(arriving);
+                handoffsIn++;
+            }
+        }
+    }
+
+    // Puts held aircraft on their entry nodes wherever the node is free
+    void admitHolding()
+    {
+        int i = 0;
+        while (i < holding.size()) {
+            SectorHandoff& entry = holding[i];
+            if (airspace.tryOccupyAt(map.getLocalId(entry.node), entry.aircraft.flightID) != ATC_OK) {
+                i++;
+                continue;
+            }
+            aircraft.insert(entry.aircraft.flightID, entry.aircraft);
+            if (i != holding.size() - 1) holding[i] = std::move(holding.back());
+            holding.pop();
+        }
+    }
+
+    // Edge to take from node: straight in to the destination, a free node
+    // on a shortest path, or now and then any free neighbour, which breaks
+    // head-on standoffs. -1 if boxed in.
+    int chooseEdge(int slot, int node)
+    {
+        int sidestep = -1;
+        for (int e = map.edgeBegin(node); e < map.edgeEnd(node); e++) {
+            int next = map.getEdgeTarget(e);
+            if (map.getDistance(slot, next) == 0 && map.getSector(next) == id) return e;
+            if (map.getSector(next) == id && airspace.isOccupied(map.getLocalId(next))) continue;
+            if (map.getSector(next) != id && boundary != NULL && boundary->test(next)) continue;
+            if (map.onShortestPath(slot, node, e)) return e;
+            if (sidestep == -1 && map.getDistance(slot, next) != INT_MAX) sidestep = e;
+        }
+        return (sidestep != -1 && nextRandom() % 4 == 0) ? sidestep : -1;
+    }
+
+    // Two flights nose to nose inside the sector, each on the other's
+    // shortest path, trade nodes. Returns the node the flight moved to, or -1.
+    int swapHeadOn(int slot, int idx, Aircraft& flight)
+    {
+        int here = globalIds[idx];
+        for (int e = map.edgeBegin(here); e < map.edgeEnd(here); e++) {
+            int next = map.getEdgeTarget(e);
+            if (map.getSector(next) != id || !map.onShortestPath(slot, here, e)) continue;
+
+            int other = map.getLocalId(next);
+            string otherID = airspace.getOccupant(other);
+            Aircraft* oncoming = aircraft.search(otherID);
+            if (oncoming == NULL) continue;
+            int otherSlot = map.findAirport(oncoming->destination);
+            if (otherSlot == -1 || map.getDistance(otherSlot, here) >= map.getDistance(otherSlot, next)) continue;
+
+            airspace.freeNodeAt(idx);
+            airspace.freeNodeAt(other);
+            airspace.tryOccupyAt(other, flight.flightID);
+            airspace.tryOccupyAt(idx, otherID);
+            place(flight, next);
+            place(*oncoming, here);
+            return other;
+        }
+        return -1;
+    }
+
+    void moveAircraft()
+    {
+        ScratchScope scope;
+        int count = airspace.getOccupiedCount();
+        int* movers = scratchArena().allocate<int>(count);
+        bool* moved = scratchArena().allocate<bool>(airspace.getNodeCount());
+        int n = 0;
+        for (int idx = airspace.nextOccupied(0); idx != -1; idx = airspace.nextOccupied(idx + 1)) movers[n++] = idx;
+
+        for (int i = 0; i < n; i++) {
+            int idx = movers[i];
+            if (moved[idx]) continue;
+            string flightID = airspace.getOccupant(idx);
+            Aircraft* flight = aircraft.search(flightID);
+            if (flight == NULL) continue;
+
+            int here = globalIds[idx];
+            int slot = map.findAirport(flight->destination);
+            if (slot == -1) continue;
+
+            int e = (map.getDistance(slot, here) == 0) ? -1 : chooseEdge(slot, here);
+            int next = (e != -1) ? map.getEdgeTarget(e) : here;
+
+            // Final approach: the flight joins its airport's landing queue
+            // without taking the airport node, which stays free for departures
+            if (map.getDistance(slot, next) == 0 && map.getSector(next) == id) {
+                airspace.freeNodeAt(idx);
+                place(*flight, next);
+                flight->queuedAt = clock;
+                landings.insert(flight->destination, *flight);
+                aircraft.remove(flightID);
+                continue;
+            }
+            if (e == -1) {
+                int swapped = swapHeadOn(slot, idx, *flight);
+                if (swapped == -1) blocked++;
+                else {
+                    moved[swapped] = true;
+                    moves += 2;
+                }
+                continue;
+            }
+            int owner = map.getSector(next);
+            if (owner == id) {
+                airspace.tryOccupyAt(map.getLocalId(next), flightID);
+                airspace.freeNodeAt(idx);
+                place(*flight, next);
+                moves++;
+                continue;
+            }
+
+            SectorHandoff handoff;
+            handoff.aircraft = *flight;
+            handoff.node = next;
+            place(handoff.aircraft, next);
+            if (!outbound[owner]->tryPush(handoff)) {
+                blocked++;
+                continue;
+            }
+            airspace.freeNodeAt(idx);
+            aircraft.remove(flightID);
+            handoffsOut++;
+        }
+    }
+
+    // Lands everything due this tick; with turnaround on, each landed
+    // aircraft departs again for another airport
+    void land(int tickSeconds)
+    {
+        int queued = landings.getSize();
+        if (queued == 0) return;
+
+        ScratchScope scope;
+        LandingSlot* cleared = scratchArena().allocate<LandingSlot>(queued);
+        int n = landings.processDue(clock - tickSeconds, clock, cleared, queued);
+        landed += n;
+        if (!turnaround) return;
+
+        int airportCount = map.getAirportCount();
+        for (int i = 0; i < n; i++) {
+            SectorHandoff departure;
+            departure.aircraft = cleared[i].aircraft;
+            int from = map.findAirport(cleared[i].airport);
+            int to = (int)(nextRandom() % airportCount);
+            if (to == from && airportCount > 1) to = (to + 1) % airportCount;
+            departure.aircraft.origin = cleared[i].airport;
+            departure.aircraft.destination = map.getAirportName(to);
+            departure.aircraft.timestamp = cleared[i].slotTime;
+            departure.node = map.getAirportNode(from);
+            place(departure.aircraft, departure.node);
+            holding.push(departure);
+        }
+    }
+
+public:
+    Sector(int sectorId, SectorMap& sectorMap, SpscQueue<SectorHandoff>** in, SpscQueue<SectorHandoff>** out,
+        int runways, int separation)
+        : id(sectorId), map(sectorMap), inbound(in), outbound(out), boundary(NULL), clock(0), rng(2463534242u + sectorId * 7919u),
+        turnaround(false), moves(0), blocked(0), handoffsIn(0), handoffsOut(0), landed(0)
+    {
+        Graph& graph = map.getGraph();
+        for (int i = 0; i < map.getNodeCount(); i++) {
+            if (map.getSector(i) != id) continue;
+            GraphNode* node = graph.getNodeAt(i);
+            airspace.addNode(node->name, node->x, node->y, node->isAirport);
+            globalIds.push(i);
+            if (node->isAirport) landings.configureAirport(node->name, runways, separation);
+            for (int e = map.edgeBegin(i); e < map.edgeEnd(i); e++) {
+                if (map.getSector(map.getEdgeTarget(e)) != id) {
+                    boundaryNodes.push(globalIds.size() - 1);
+                    break;
+                }
+            }
+        }
+    }
+
+    Sector(const Sector&) = delete;
+    Sector& operator=(const Sector&) = delete;
+
+    ~Sector()
+    {
+        delete[] inbound;
+        delete[] outbound;
+    }
+
+    // Queues flight to enter at node (a global ID in this sector). Call
+    // only while the sectors are stopped.
+    void admit(const Aircraft& flight, int node)
+    {
+        SectorHandoff entry;
+        entry.aircraft = flight;
+        entry.node = node;
+        place(entry.aircraft, node);
+        holding.push(entry);
+    }
+
+    void setTurnaround(bool enabled) { turnaround = enabled; }
+
+    // From now on skip boundary nodes other sectors report occupied, and
+    // report this sector's own boundary nodes after every tick
+    void shareBoundary(SharedOccupancy* view)
+    {
+        boundary = view;
+        publishBoundary();
+    }
+
+    void publishBoundary()
+    {
+        if (boundary == NULL) return;
+        for (int i = 0; i < boundaryNodes.size(); i++)
+            boundary->assign(globalIds[boundaryNodes[i]], airspace.isOccupied(boundaryNodes[i]));
+    }
+
+    void tick(int tickSeconds)
+    {
+        clock += tickSeconds;
+        receive();
+        admitHolding();
+        moveAircraft();
+        publishBoundary();
+        land(tickSeconds);
+    }
+
+    int getId() { return id; }
+    int getNodeCount() { return globalIds.size(); }
+    Graph& getAirspace() { return airspace; }
+    int getAirborne() { return aircraft.getCount(); }
+    int getHolding() { return holding.size(); }
+    int getQueued() { return landings.getSize(); }
+    long getMoves() { return moves; }
+    long getBlocked() { return blocked; }
+    long getHandoffsIn() { return handoffsIn; }
+    long getHandoffsOut() { return handoffsOut; }
+    long getLanded() { return landed; }
+};
+
+// Owns the sectors, their handoff queues and the shared SectorMap. run()
+// gives every sector its own thread and steps them in lockstep: handoffs
+// sent during one tick are picked up at the start of the next. Global
+// routing queries are answered from the whole graph.
+class SectorCoordinator
+{
+private:
+    SectorMap map;
+    int sectorCount;
+    Sector** sectors;
+    SpscQueue<SectorHandoff>** queues;      // [from * sectorCount + to]; only where sectors share an edge
+    std::atomic<unsigned long long>* boundaryWords;
+    SharedOccupancy boundary;
+
+public:
+    SectorCoordinator(Graph& graph, int sectorTotal, int queueCapacity = 1024, int runways = 2, int separation = 60)
+        : map(graph, sectorTotal), sectorCount(sectorTotal)
+    {
+        queues = new SpscQueue<SectorHandoff>*[sectorCount * sectorCount];
+        for (int i = 0; i < sectorCount * sectorCount; i++) queues[i] = NULL;
+        for (int u = 0; u < map.getNodeCount(); u++) {
+            for (int e = map.edgeBegin(u); e < map.edgeEnd(u); e++) {
+                int from = map.getSector(u);
+                int to = map.getSector(map.getEdgeTarget(e));
+                if (from != to && queues[from * sectorCount + to] == NULL)
+                    queues[from * sectorCount + to] = new SpscQueue<SectorHandoff>(queueCapacity);
+            }
+        }
+
+        sectors = new Sector*[sectorCount];
+        for (int s = 0; s < sectorCount; s++) {
+            SpscQueue<SectorHandoff>** in = new SpscQueue<SectorHandoff>*[sectorCount];
+            SpscQueue<SectorHandoff>** out = new SpscQueue<SectorHandoff>*[sectorCount];
+            for (int other = 0; other < sectorCount; other++) {
+                in[other] = queues[other * sectorCount + s];
+                out[other] = queues[s * sectorCount + other];
+            }
+            sectors[s] = new Sector(s, map, in, out, runways, separation);
+        }
+
+        int words = SharedOccupancy::wordsFor(map.getNodeCount());
+        boundaryWords = new std::atomic<unsigned long long>[words > 0 ? words : 1];
+        for (int w = 0; w < words; w++) boundaryWords[w].store(0);
+        boundary.attach(boundaryWords, map.getNodeCount());
+        for (int s = 0; s < sectorCount; s++) sectors[s]->shareBoundary(&boundary);
+    }
+
+    SectorCoordinator(const SectorCoordinator&) = delete;
+    SectorCoordinator& operator=(const SectorCoordinator&) = delete;
+
+    ~SectorCoordinator()
+    {
+        for (int s = 0; s < sectorCount; s++) delete sectors[s];
+        delete[] sectors;
+        for (int i = 0; i < sectorCount * sectorCount; i++) delete queues[i];
+        delete[] queues;
+        delete[] boundaryWords;
+    }
+
+    // Hands flight to the sector owning flight.currentNode. Call only while
+    // the sectors are stopped.
+    AtcStatus tryLaunch(const Aircraft& flight)
+    {
+        int node = map.getGraph().getNodeIndex(flight.currentNode);
+        if (node == -1) return ATC_UNKNOWN_NODE;
+        sectors[map.getSector(node)]->admit(flight, node);
+        return ATC_OK;
+    }
+
+    void setTurnaround(bool enabled)
+    {
+        for (int s = 0; s < sectorCount; s++) sectors[s]->setTurnaround(enabled);
+    }
+
+    // Runs every sector for ticks steps on its own thread; returns once all are done
+    void run(int ticks, int tickSeconds)
+    {
+        TickBarrier barrier(sectorCount);
+        std::thread* threads = new std::thread[sectorCount];
+        for (int s = 0; s < sectorCount; s++) {
+            Sector* sector = sectors[s];
+            threads[s] = std::thread([sector, &barrier, ticks, tickSeconds]() {
+                for (int t = 0; t < ticks; t++) {
+                    sector->tick(tickSeconds);
+                    barrier.arrive();
+                }
+            });
+        }
+        for (int s = 0; s < sectorCount; s++) threads[s].join();
+        delete[] threads;
+    }
+
+    // Global routing query, across sector boundaries
+    AtcStatus tryRoute(const string& start, const string& end, string path[], int& pathCount, int& distance)
+    {
+        return map.getGraph().tryGetDijkstraPath(start, end, path, pathCount, distance);
+    }
+
+    SectorMap& getMap() { return map; }
+    int getSectorCount() { return sectorCount; }
+    Sector* getSector(int s) { return sectors[s]; }
+
+    // Aircraft anywhere in the system: airborne, holding, in transit or queued to land
+    int getAircraftCount()
+    {
+        int total = 0;
+        for (int s = 0; s < sectorCount; s++)
+            total += sectors[s]->getAirborne() + sectors[s]->getHolding() + sectors[s]->getQueued();
+        for (int i = 0; i < sectorCount * sectorCount; i++)
+            if (queues[i] != NULL) total += queues[i]->getSize();
+        return total;
+    }
+};
+
+// Synthetic airspace for sector and federation runs: a cols x rows grid
+// of waypoints 10 km apart, linked both ways to their four neighbours,
+// with an airport at the centre of every spacing x spacing block. Every
+// process that rebuilds it with the same arguments gets the same node IDs.
+void buildGridAirspace(Graph& graph, int cols, int rows, int spacing)
+{
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            bool airport = (r % spacing == spacing / 2 && c % spacing == spacing / 2);
+            graph.addNode("G" + toString(r) + "-" + toString(c), c, r, airport);
+        }
+    }
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            string here = "G" + toString(r) + "-" + toString(c);
+            if (c + 1 < cols) {
+                string east = "G" + toString(r) + "-" + toString(c + 1);
+                graph.addEdge(here, east, 10);
+                graph.addEdge(east, here, 10);
+            }
+            if (r + 1 < rows) {
+                string south = "G" + toString(r + 1) + "-" + toString(c);
+                graph.addEdge(here, south, 10);
+                graph.addEdge(south, here, 10);
+            }
+        }
+    }
+}
+
+// ===== SECTOR FEDERATION =====
+// Sectors as separate processes on one host, so one crashing sector cannot
+// take the others down. Everything they share sits in one shared-memory
+// segment: a header, a slot per participant (sectors 0..n-1, then the
+// coordinator), the boundary occupancy words and a byte ring for every
+// ordered pair of participants. Messages are compact varint records; a
+// sender publishes a whole batch and rings the receiver's doorbell once.
+
+enum FederationMessage
+{
+    MSG_PAD,            // ring filler before a wrap
+    MSG_HANDOFF,        // aircraft entering the receiver's sector
+    MSG_ROUTE_REQUEST,  // sector -> coordinator: route from a node to an airport
+    MSG_ROUTE_REPLY,    // coordinator -> sector: distance and node IDs
+    MSG_ECHO,           // transport benchmark ping, sent straight back
+    MSG_STOP            // transport benchmark is over
+};
+
+enum FederationMode
+{
+    FEDERATION_SECTORS,     // run sectors on the grid airspace
+    FEDERATION_ECHO         // count handoffs and answer pings
+};
+
+enum FederationStat
+{
+    STAT_AIRBORNE,
+    STAT_HOLDING,
+    STAT_QUEUED,
+    STAT_MOVES,
+    STAT_BLOCKED,
+    STAT_HANDOFFS_IN,
+    STAT_HANDOFFS_OUT,
+    STAT_LANDED,
+    STAT_ROUTE_REPLIES,
+    STAT_ROUTE_MICROS,
+    STAT_MESSAGES,
+    STAT_COUNT
+};
+
+long long steadyMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Named shared memory: POSIX shm_open + mmap, or a Win32 file mapping.
+// The creator removes the name again when it closes the segment.
+class SharedMemory
+{
+private:
+    string name;
+    char* base;
+    size_t bytes;
+    bool owner;
+#ifdef _WIN32
+    HANDLE mapping;
+#endif
+
+public:
+#ifdef _WIN32
+    SharedMemory() : base(NULL), bytes(0), owner(false), mapping(NULL) {}
+#else
+    SharedMemory() : base(NULL), bytes(0), owner(false) {}
+#endif
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    ~SharedMemory() { close(); }
+
+    // New zero-filled segment of size bytes
+    void create(const string& segmentName, size_t size)
+    {
+        close();
+        name = segmentName;
+#ifdef _WIN32
+        mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+            (DWORD)((unsigned long long)size >> 32), (DWORD)(size & 0xFFFFFFFF), name.c_str());
+        if (mapping == NULL) throw SharedMemoryException(name, "cannot create");
+        base = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size));
+        if (base == NULL) {
+            CloseHandle(mapping);
+            mapping = NULL;
+            throw SharedMemoryException(name, "cannot map");
+        }
+#else
+        shm_unlink(name.c_str());   // left behind by a run that crashed
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd == -1) throw SharedMemoryException(name, "cannot create");
+        if (ftruncate(fd, (off_t)size) != 0) {
+            ::close(fd);
+            shm_unlink(name.c_str());
+            throw SharedMemoryException(name, "cannot size");
+        }
+        void* view = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) {
+            shm_unlink(name.c_str());
+            throw SharedMemoryException(name, "cannot map");
+        }
+        base = static_cast<char*>(view);
+#endif
+        bytes = size;
+        owner = true;
+    }
+
+    void open(const string& segmentName)
+    {
+        close();
+        name = segmentName;
+#ifdef _WIN32
+        mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+        if (mapping == NULL) throw SharedMemoryException(name, "not found");
+        base = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+        if (base == NULL) {
+            CloseHandle(mapping);
+            mapping = NULL;
+            throw SharedMemoryException(name, "cannot map");
+        }
+        MEMORY_BASIC_INFORMATION info;
+        VirtualQuery(base, &info, sizeof(info));
+        bytes = info.RegionSize;
+#else
+        int fd = shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd == -1) throw SharedMemoryException(name, "not found");
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw SharedMemoryException(name, "cannot stat");
+        }
+        bytes = (size_t)info.st_size;
+        void* view = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) throw SharedMemoryException(name, "cannot map");
+        base = static_cast<char*>(view);
+#endif
+        owner = false;
+    }
+
+    void close()
+    {
+        if (base == NULL) return;
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+        CloseHandle(mapping);
+        mapping = NULL;
+#else
+        munmap(base, bytes);
+        if (owner) shm_unlink(name.c_str());
+#endif
+        base = NULL;
+        bytes = 0;
+        owner = false;
+    }
+
+    char* data() { return base; }
+    size_t size() { return bytes; }
+};
+
+// Wakes a participant waiting for messages. A producer rings once per
+// published batch and only makes a system call (a futex wake on Linux)
+// when the receiver has actually gone to sleep.
+class Doorbell
+{
+private:
+    static const int SPIN_LIMIT = 200;
+
+    std::atomic<unsigned int> sequence;
+    std::atomic<unsigned int> sleeping;
+
+public:
+    void reset()
+    {
+        sequence.store(0);
+        sleeping.store(0);
+    }
+
+    void ring()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed) == 0) return;
+        sequence.fetch_add(1, std::memory_order_relaxed);
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<int*>(&sequence), FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#endif
+    }
+
+    // Waits until ready() holds, spinning briefly before sleeping. Only
+    // the participant that owns the doorbell waits on it. False on timeout.
+    template <typename Ready>
+    bool wait(Ready& ready, long timeoutMicros)
+    {
+        for (int spin = 0; spin < SPIN_LIMIT; spin++) {
+            if (ready()) return true;
+            std::this_thread::yield();
+        }
+
+        long long deadline = steadyMicros() + timeoutMicros;
+        while (true) {
+            unsigned int seen = sequence.load(std::memory_order_relaxed);
+            sleeping.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            bool done = ready();
+            long long left = deadline - steadyMicros();
+            if (done || left <= 0) {
+                sleeping.store(0, std::memory_order_relaxed);
+                return done;
+            }
+#ifdef __linux__
+            struct timespec timeout;
+            timeout.tv_sec = (time_t)(left / 1000000);
+            timeout.tv_nsec = (long)(left % 1000000) * 1000;
+            syscall(SYS_futex, reinterpret_cast<int*>(&sequence), FUTEX_WAIT, seen, &timeout, NULL, 0);
+#else
+            (void)seen;
+            std::this_thread::sleep_for(std::chrono::microseconds(left < 100 ? left : 100));
+#endif
+            sleeping.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+// Single-producer / single-consumer byte ring of variable-length records
+// that works across processes. A record is a 4-byte header (payload
+// length, type) and the payload, padded to 8 bytes; a record that would
+// run past the end is preceded by a pad record and starts over at zero.
+// The producer stages any number of records and makes them visible with
+// one publish(); the consumer frees a drained batch with one store.
+class ShmRing
+{
+public:
+    static const int HEADER = 4;
+    static const int MAX_PAYLOAD = 60000;
+
+    struct Control
+    {
+        std::atomic<unsigned long long> head;   // bytes consumed
+        char headPadding[56];
+        std::atomic<unsigned long long> tail;   // bytes published
+        char tailPadding[56];
+    };
+
+private:
+    Control* control;
+    unsigned char* buffer;
+    unsigned long long capacity;    // power of two, multiple of 8
+    unsigned long long staged;      // producer only: end of staged records
+
+    static unsigned long long padded(int length) { return (HEADER + (unsigned long long)length + 7) & ~7ULL; }
+
+    void putHeader(unsigned long long offset, int length, unsigned char type)
+    {
+        buffer[offset] = (unsigned char)(length & 0xFF);
+        buffer[offset + 1] = (unsigned char)(length >> 8);
+        buffer[offset + 2] = type;
+        buffer[offset + 3] = 0;
+    }
+
+public:
+    ShmRing() : control(NULL), buffer(NULL), capacity(0), staged(0) {}
+
+    static size_t bytesFor(int ringCapacity) { return sizeof(Control) + (size_t)ringCapacity; }
+
+    // memory holds bytesFor(ringCapacity) bytes; the creator initializes it
+    void attach(char* memory, int ringCapacity, bool initialize)
+    {
+        control = reinterpret_cast<Control*>(memory);
+        buffer = reinterpret_cast<unsigned char*>(memory + sizeof(Control));
+        capacity = (unsigned long long)ringCapacity;
+        if (initialize) {
+            control->head.store(0);
+            control->tail.store(0);
+        }
+        staged = control->tail.load(std::memory_order_acquire);
+    }
+
+    // Producer: room for a record of length bytes, however the ring wraps
+    bool hasRoomFor(int length)
+    {
+        return staged + 2 * padded(length) - control->head.load(std::memory_order_acquire) <= capacity;
+    }
+
+    // Producer: stages a record; false if the consumer has not freed enough room
+    bool tryWrite(unsigned char type, const char* payload, int length)
+    {
+        if (length > MAX_PAYLOAD) return false;
+        unsigned long long need = padded(length);
+        unsigned long long offset = staged & (capacity - 1);
+        unsigned long long tailRoom = capacity - offset;
+        unsigned long long total = (need > tailRoom) ? need + tailRoom : need;
+        if (staged + total - control->head.load(std::memory_order_acquire) > capacity) return false;
+
+        if (need > tailRoom) {
+            putHeader(offset, (int)(tailRoom - HEADER), MSG_PAD);
+            staged += tailRoom;
+            offset = 0;
+        }
+        putHeader(offset, length, type);
+        if (length > 0) memcpy(buffer + offset + HEADER, payload, (size_t)length);
+        staged += need;
+        return true;
+    }
+
+    // Producer: makes every staged record visible; false if there were none
+    bool publish()
+    {
+        if (staged == control->tail.load(std::memory_order_relaxed)) return false;
+        control->tail.store(staged, std::memory_order_release);
+        return true;
+    }
+
+    // Producer: the consumer has read everything published
+    bool isDrained() { return control->head.load(std::memory_order_acquire) == control->tail.load(std::memory_order_relaxed); }
+
+    // Consumer: something published is waiting
+    bool hasData() { return control->head.load(std::memory_order_relaxed) != control->tail.load(std::memory_order_acquire); }
+
+    // Consumer: hands up to maxRecords records to handle(type, payload,
+    // length), then frees them all at once. Returns the number handled.
+    template <typename Handler>
+    int drain(Handler& handle, int maxRecords)
+    {
+        unsigned long long head = control->head.load(std::memory_order_relaxed);
+        unsigned long long tail = control->tail.load(std::memory_order_acquire);
+        int count = 0;
+        while (head != tail && count < maxRecords) {
+            unsigned long long offset = head & (capacity - 1);
+            int length = buffer[offset] | (buffer[offset + 1] << 8);
+            unsigned char type = buffer[offset + 2];
+            if (type != MSG_PAD) {
+                handle(type, reinterpret_cast<const char*>(buffer + offset + HEADER), length);
+                count++;
+            }
+            head += padded(length);
+        }
+        control->head.store(head, std::memory_order_release);
+        return count;
+    }
+};
+
+// ----- Wire format -----
+// Payload fields are varints (signed ones zig-zagged), strings are a
+// varint length and the bytes, capped at 255. Airports travel as their
+// slot in the shared SectorMap, which every participant builds identically.
+
+void appendWireString(string& out, const string& value)
+{
+    size_t length = value.size() < 255 ? value.size() : 255;
+    appendVarint(out, length);
+    out.append(value, 0, length);
+}
+
+void readWireString(const char*& p, const char* end, string& value)
+{
+    unsigned long long length = readVarint(p, end);
+    if (length > (unsigned long long)(end - p)) throw AircraftException("Federation message is truncated");
+    value.assign(p, (size_t)length);
+    p += length;
+}
+
+// Airport slot + 1, or 0 followed by the name for anything else
+void appendWirePlace(string& out, const string& place, SectorMap& map)
+{
+    int slot = map.findAirport(place);
+    appendVarint(out, (unsigned long long)(slot + 1));
+    if (slot == -1) appendWireString(out, place);
+}
+
+void readWirePlace(const char*& p, const char* end, string& place, SectorMap& map)
+{
+    unsigned long long slot = readVarint(p, end);
+    if (slot == 0) readWireString(p, end, place);
+    else if (slot <= (unsigned long long)map.getAirportCount()) place = map.getAirportName((int)slot - 1);
+    else throw AircraftException("Federation message names an unknown airport");
+}
+
+// Largest handoff payload (capped strings), for room checks before encoding
+const int MAX_HANDOFF_BYTES = 2048;
+
+void encodeHandoff(string& out, const SectorHandoff& handoff, SectorMap& map)
+{
+    const Aircraft& a = handoff.aircraft;
+    out.clear();
+    appendVarint(out, (unsigned long long)handoff.node);
+    appendWireString(out, a.flightID);
+    appendWireString(out, a.model);
+    appendWireString(out, a.status);
+    appendVarint(out, (unsigned long long)a.fuelLevel);
+    appendVarint(out, (unsigned long long)a.priority);
+    appendWirePlace(out, a.origin, map);
+    appendWirePlace(out, a.destination, map);
+    appendVarint(out, zigzag(a.timestamp));
+    appendVarint(out, zigzag(a.queuedAt));
+}
+
+// Rebuilds the handoff, placing the aircraft on its entry node
+void decodeHandoff(const char* p, int length, SectorHandoff& handoff, SectorMap& map)
+{
+    const char* end = p + length;
+    Aircraft& a = handoff.aircraft;
+    unsigned long long node = readVarint(p, end);
+    if (node >= (unsigned long long)map.getNodeCount()) throw AircraftException("Federation message names an unknown node");
+    handoff.node = (int)node;
+    readWireString(p, end, a.flightID);
+    readWireString(p, end, a.model);
+    readWireString(p, end, a.status);
+    a.fuelLevel = (int)readVarint(p, end);
+    a.priority = (int)readVarint(p, end);
+    readWirePlace(p, end, a.origin, map);
+    readWirePlace(p, end, a.destination, map);
+    a.timestamp = unzigzag(readVarint(p, end));
+    a.queuedAt = unzigzag(readVarint(p, end));
+
+    GraphNode* entry = map.getGraph().getNodeAt(handoff.node);
+    a.currentNode = entry->name;
+    a.x = entry->x;
+    a.y = entry->y;
+}
+
+// ----- Segment layout -----
+
+class FederationHeader
+{
+public:
+    static const unsigned int MAGIC = 0x534B594E;
+
+    unsigned int magic;
+    int mode;
+    int sectorCount;
+    int participants;       // sectors + coordinator
+    int ringCapacity;
+    int nodeCount;
+
+    // The grid airspace every participant rebuilds (buildGridAirspace)
+    int gridCols;
+    int gridRows;
+    int airportSpacing;
+
+    int ticks;
+    int tickSeconds;
+    int runways;
+    int separation;
+
+    std::atomic<int> attached;
+    std::atomic<int> started;
+};
+
+class ParticipantSlot
+{
+public:
+    Doorbell doorbell;
+    std::atomic<int> ticksDone;     // sectors: ticks completed, handoffs for them published
+    std::atomic<int> done;
+    long long stats[STAT_COUNT];    // written by the participant before done is set
+};
+
+// A participant's view of the segment. The coordinator creates it and is
+// participant sectorCount; each sector process joins with its sector ID.
+class SectorFederation
+{
+private:
+    SharedMemory memory;
+    FederationHeader* header;
+    char* slotBase;
+    std::atomic<unsigned long long>* boundaryWords;
+    ShmRing* rings;         // [from * participants + to]
+    int self;
+
+    static size_t align64(size_t n) { return (n + 63) & ~(size_t)63; }
+    static size_t slotStride() { return align64(sizeof(ParticipantSlot)); }
+    static size_t ringStride(int ringCapacity) { return align64(ShmRing::bytesFor(ringCapacity)); }
+
+    static size_t segmentSize(int participants, int nodeCount, int ringCapacity)
+    {
+        return align64(sizeof(FederationHeader)) + participants * slotStride()
+            + align64(SharedOccupancy::wordsFor(nodeCount) * sizeof(unsigned long long))
+            + (size_t)participants * participants * ringStride(ringCapacity);
+    }
+
+    void layout(bool initialize)
+    {
+        int participants = header->participants;
+        char* base = memory.data();
+        slotBase = base + align64(sizeof(FederationHeader));
+        char* words = slotBase + participants * slotStride();
+        boundaryWords = reinterpret_cast<std::atomic<unsigned long long>*>(words);
+        char* ringBase = words + align64(SharedOccupancy::wordsFor(header->nodeCount) * sizeof(unsigned long long));
+
+        rings = new ShmRing[participants * participants];
+        for (int i = 0; i < participants * participants; i++)
+            rings[i].attach(ringBase + i * ringStride(header->ringCapacity), header->ringCapacity, initialize);
+    }
+
+public:
+    SectorFederation() : header(NULL), slotBase(NULL), boundaryWords(NULL), rings(NULL), self(-1) {}
+
+    SectorFederation(const SectorFederation&) = delete;
+    SectorFederation& operator=(const SectorFederation&) = delete;
+
+    ~SectorFederation() { delete[] rings; }
+
+    // Creates the segment and fills in everything but the run parameters.
+    // ringCapacity must be a power of two.
+    void create(const string& name, int mode, int sectorCount, int nodeCount, int ringCapacity)
+    {
+        int participants = sectorCount + 1;
+        memory.create(name, segmentSize(participants, nodeCount, ringCapacity));
+
+        header = new (memory.data()) FederationHeader();
+        header->mode = mode;
+        header->sectorCount = sectorCount;
+        header->participants = participants;
+        header->ringCapacity = ringCapacity;
+        header->nodeCount = nodeCount;
+        header->attached.store(0);
+        header->started.store(0);
+        layout(true);
+
+        if (!boundaryWords[0].is_lock_free()) throw SharedMemoryException(name, "64-bit atomics are not lock-free");
+        for (int w = 0; w < SharedOccupancy::wordsFor(nodeCount); w++) boundaryWords[w].store(0);
+        for (int p = 0; p < participants; p++) {
+            ParticipantSlot* slot = new (slotBase + p * slotStride()) ParticipantSlot();
+            slot->doorbell.reset();
+            slot->ticksDone.store(0);
+            slot->done.store(0);
+            for (int s = 0; s < STAT_COUNT; s++) slot->stats[s] = 0;
+        }
+        self = sectorCount;
+    }
+
+    // Marks the segment ready for participants to join
+    void open() { header->magic = FederationHeader::MAGIC; }
+
+    void join(const string& name, int id)
+    {
+        memory.open(name);
+        header = reinterpret_cast<FederationHeader*>(memory.data());
+        if (header->magic != FederationHeader::MAGIC) throw SharedMemoryException(name, "not a federation segment");
+        if (id < 0 || id >= header->sectorCount) throw SharedMemoryException(name, "no sector " + toString(id));
+        layout(false);
+        self = id;
+        header->attached.fetch_add(1);
+    }
+
+    FederationHeader& getHeader() { return *header; }
+    ParticipantSlot& getSlot(int p) { return *reinterpret_cast<ParticipantSlot*>(slotBase + p * slotStride()); }
+    ShmRing& ring(int from, int to) { return rings[from * header->participants + to]; }
+    std::atomic<unsigned long long>* getBoundaryWords() { return boundaryWords; }
+
+    int getSelf() { return self; }
+    int getCoordinator() { return header->sectorCount; }
+    int getParticipants() { return header->participants; }
+
+    // Publishes every ring out of this participant and rings each receiver once
+    void flush()
+    {
+        for (int to = 0; to < header->participants; to++) {
+            if (to != self && ring(self, to).publish()) getSlot(to).doorbell.ring();
+        }
+    }
+
+    // Any ring into this participant has records waiting
+    bool hasMail()
+    {
+        for (int from = 0; from < header->participants; from++)
+            if (from != self && ring(from, self).hasData()) return true;
+        return false;
+    }
+};
+
+// A Sector running in its own process. Handoffs read from the rings go
+// straight into the sector; its outbound queues are drained into the rings
+// once per tick, followed by one doorbell per receiver. Once a tick the
+// sector also asks the coordinator for a route and times the reply.
+// Sectors keep in step: tick t starts once every other sector has
+// finished tick t - 1, so a handoff always lands one tick after it left.
+class FederatedSector
+{
+private:
+    static const int ROUTE_WINDOW = 1024;
+    static const long PEER_TIMEOUT_MICROS = 5000000;
+
+    SectorFederation& federation;
+    SectorMap& map;
+    Sector* sector;
+    SpscQueue<SectorHandoff>** outbound;    // [to sector], local
+    SharedOccupancy boundary;
+    string scratch;
+    unsigned int rng;
+
+    unsigned int nextRequest;
+    long long sentAt[ROUTE_WINDOW];
+    long long handoffsIn;
+    long long routeReplies;
+    long long routeMicros;
+    long long malformed;
+
+    class Receiver
+    {
+    public:
+        FederatedSector* owner;
+        SectorHandoff arriving;
+
+        void operator()(unsigned char type, const char* payload, int length)
+        {
+            try {
+                if (type == MSG_HANDOFF) {
+                    decodeHandoff(payload, length, arriving, owner->map);
+                    owner->sector->admit(arriving.aircraft, arriving.node);
+                    owner->handoffsIn++;
+                }
+                else if (type == MSG_ROUTE_REPLY) {
+                    const char* p = payload;
+                    unsigned int id = (unsigned int)readVarint(p, payload + length);
+                    owner->routeReplies++;
+                    owner->routeMicros += steadyMicros() - owner->sentAt[id % ROUTE_WINDOW];
+                }
+            }
+            catch (AircraftException&) {
+                owner->malformed++;
+            }
+        }
+    };
+
+    void receive()
+    {
+        Receiver receiver;
+        receiver.owner = this;
+        int self = federation.getSelf();
+        for (int from = 0; from < federation.getParticipants(); from++) {
+            if (from != self) federation.ring(from, self).drain(receiver, INT_MAX);
+        }
+    }
+
+    void sendHandoffs()
+    {
+        int self = federation.getSelf();
+        SectorHandoff leaving;
+        for (int to = 0; to < map.getSectorCount(); to++) {
+            if (outbound[to] == NULL) continue;
+            ShmRing& ring = federation.ring(self, to);
+            while (ring.hasRoomFor(MAX_HANDOFF_BYTES) && outbound[to]->tryPop(leaving)) {
+                encodeHandoff(scratch, leaving, map);
+                ring.tryWrite(MSG_HANDOFF, scratch.data(), (int)scratch.size());
+            }
+        }
+    }
+
+    // False if another sector stopped making progress (crashed or hung)
+    bool waitForPeers(int tick)
+    {
+        int self = federation.getSelf();
+        for (int s = 0; s < map.getSectorCount(); s++) {
+            if (s == self) continue;
+            ParticipantSlot& peer = federation.getSlot(s);
+            long long deadline = 0;
+            for (int spin = 0; peer.ticksDone.load(std::memory_order_acquire) < tick; spin++) {
+                if (spin % 1024 == 0) {
+                    long long now = steadyMicros();
+                    if (deadline == 0) deadline = now + PEER_TIMEOUT_MICROS;
+                    else if (now > deadline) return false;
+                }
+                std::this_thread::yield();
+            }
+        }
+        return true;
+    }
+
+    void requestRoute()
+    {
+        ShmRing& ring = federation.ring(federation.getSelf(), federation.getCoordinator());
+        if (!ring.hasRoomFor(32) || map.getAirportCount() == 0) return;
+
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        unsigned int id = nextRequest++;
+        scratch.clear();
+        appendVarint(scratch, id);
+        appendVarint(scratch, rng % (unsigned int)map.getNodeCount());
+        appendVarint(scratch, (rng >> 16) % (unsigned int)map.getAirportCount());
+        sentAt[id % ROUTE_WINDOW] = steadyMicros();
+        ring.tryWrite(MSG_ROUTE_REQUEST, scratch.data(), (int)scratch.size());
+    }
+
+public:
+    FederatedSector(SectorFederation& fed, SectorMap& sectorMap)
+        : federation(fed), map(sectorMap), rng(2654435761u + fed.getSelf() * 40503u), nextRequest(0),
+        handoffsIn(0), routeReplies(0), routeMicros(0), malformed(0)
+    {
+        FederationHeader& header = federation.getHeader();
+        int sectorCount = map.getSectorCount();
+        int self = federation.getSelf();
+
+        SpscQueue<SectorHandoff>** in = new SpscQueue<SectorHandoff>*[sectorCount];
+        SpscQueue<SectorHandoff>** out = new SpscQueue<SectorHandoff>*[sectorCount];
+        outbound = new SpscQueue<SectorHandoff>*[sectorCount];
+        for (int s = 0; s < sectorCount; s++) {
+            in[s] = NULL;
+            outbound[s] = (s != self) ? new SpscQueue<SectorHandoff>(1024) : NULL;
+            out[s] = outbound[s];
+        }
+        sector = new Sector(self, map, in, out, header.runways, header.separation);
+        sector->setTurnaround(true);
+        boundary.attach(federation.getBoundaryWords(), map.getNodeCount());
+        sector->shareBoundary(&boundary);
+    }
+
+    FederatedSector(const FederatedSector&) = delete;
+    FederatedSector& operator=(const FederatedSector&) = delete;
+
+    ~FederatedSector()
+    {
+        delete sector;
+        for (int s = 0; s < map.getSectorCount(); s++) delete outbound[s];
+        delete[] outbound;
+    }
+
+    // Runs ticks steps, then reports this sector's totals in its slot.
+    // False if it had to stop early because a peer was lost.
+    bool run(int ticks, int tickSeconds)
+    {
+        ParticipantSlot& mine = federation.getSlot(federation.getSelf());
+        bool completed = true;
+        for (int t = 0; t < ticks; t++) {
+            if (!waitForPeers(t)) {
+                completed = false;
+                break;
+            }
+            receive();
+            sector->tick(tickSeconds);
+            sendHandoffs();
+            requestRoute();
+            federation.flush();
+            mine.ticksDone.store(t + 1, std::memory_order_release);
+        }
+
+        // Whatever could not be sent is still this sector's to count
+        int unsent = 0;
+        for (int s = 0; s < map.getSectorCount(); s++)
+            if (outbound[s] != NULL) unsent += outbound[s]->getSize();
+
+        ParticipantSlot& slot = federation.getSlot(federation.getSelf());
+        slot.stats[STAT_AIRBORNE] = sector->getAirborne();
+        slot.stats[STAT_HOLDING] = sector->getHolding() + unsent;
+        slot.stats[STAT_QUEUED] = sector->getQueued();
+        slot.stats[STAT_MOVES] = sector->getMoves();
+        slot.stats[STAT_BLOCKED] = sector->getBlocked();
+        slot.stats[STAT_HANDOFFS_IN] = handoffsIn;
+        slot.stats[STAT_HANDOFFS_OUT] = sector->getHandoffsOut();
+        slot.stats[STAT_LANDED] = sector->getLanded();
+        slot.stats[STAT_ROUTE_REPLIES] = routeReplies;
+        slot.stats[STAT_ROUTE_MICROS] = routeMicros;
+        slot.stats[STAT_MESSAGES] = malformed;
+        slot.done.store(1, std::memory_order_release);
+        federation.getSlot(federation.getCoordinator()).doorbell.ring();
+        return completed;
+    }
+};
+
+// Transport benchmark partner: decodes every handoff, answers pings and
+// stops on MSG_STOP. Reports the handoffs it decoded.
+void runEchoParticipant(SectorFederation& federation, SectorMap& map)
+{
+    class Echo
+    {
+    public:
+        SectorFederation* federation;
+        SectorMap* map;
+        SectorHandoff arriving;
+        long long handoffs;
+        bool stop;
+
+        void operator()(unsigned char type, const char* payload, int length)
+        {
+            if (type == MSG_HANDOFF) {
+                try {
+                    decodeHandoff(payload, length, arriving, *map);
+                    handoffs++;
+                }
+                catch (AircraftException&) {}
+            }
+            else if (type == MSG_ECHO) {
+                federation->ring(federation->getSelf(), federation->getCoordinator()).tryWrite(MSG_ECHO, payload, length);
+            }
+            else if (type == MSG_STOP) stop = true;
+        }
+    };
+
+    Echo echo;
+    echo.federation = &federation;
+    echo.map = &map;
+    echo.handoffs = 0;
+    echo.stop = false;
+
+    ShmRing& inbox = federation.ring(federation.getCoordinator(), federation.getSelf());
+    auto ready = [&inbox]() { return inbox.hasData(); };
+    ParticipantSlot& slot = federation.getSlot(federation.getSelf());
+    while (!echo.stop) {
+        if (!slot.doorbell.wait(ready, 5000000)) break;     // coordinator gone
+        inbox.drain(echo, INT_MAX);
+        federation.flush();
+    }
+
+    slot.stats[STAT_MESSAGES] = echo.handoffs;
+    slot.done.store(1, std::memory_order_release);
+    federation.getSlot(federation.getCoordinator()).doorbell.ring();
+}
+
+// Entry point of a sector process ("--sector <segment> <id>"): joins the
+// segment, rebuilds the shared airspace, waits for the start signal and
+// runs. Returns the process exit code.
+int runSectorProcess(const string& segment, int id)
+{
+    try {
+        SectorFederation federation;
+        federation.join(segment, id);
+        FederationHeader& header = federation.getHeader();
+
+        Graph grid;
+        buildGridAirspace(grid, header.gridCols, header.gridRows, header.airportSpacing);
+        SectorMap map(grid, header.sectorCount);
+        if (map.getNodeCount() != header.nodeCount) throw SharedMemoryException(segment, "airspace does not match");
+
+        if (header.mode == FEDERATION_ECHO) {
+            runEchoParticipant(federation, map);
+            return 0;
+        }
+
+        FederatedSector sector(federation, map);
+        auto started = [&header]() { return header.started.load(std::memory_order_acquire) != 0; };
+        if (!federation.getSlot(id).doorbell.wait(started, 10000000)) throw SharedMemoryException(segment, "never started");
+        if (!sector.run(header.ticks, header.tickSeconds)) throw SharedMemoryException(segment, "lost a peer sector");
+        return 0;
+    }
+    catch (AircraftException& e) {
+        cerr << "  Sector " << id << ": " << e.what() << "\n";
+        return 1;
+    }
+}
+
+// ----- Sector processes -----
+
+// Segment name unique to this process
+string federationSegmentName()
+{
+#ifdef _WIN32
+    return "Local\\skynet-" + toString((int)GetCurrentProcessId());
+#else
+    return "/skynet-" + toString((int)getpid());
+#endif
+}
+
+#ifdef _WIN32
+typedef HANDLE ProcessHandle;
+#else
+typedef pid_t ProcessHandle;
+extern char** environ;
+#endif
+
+// Starts this executable again as "--sector <segment> <id>"
+bool spawnSectorProcess(const string& segment, int id, ProcessHandle& process)
+{
+    string idText = toString(id);
+#ifdef _WIN32
+    char path[MAX_PATH];
+    if (GetModuleFileNameA(NULL, path, MAX_PATH) == 0) return false;
+    string command = "\"" + string(path) + "\" --sector " + segment + " " + idText;
+    STARTUPINFOA startup;
+    PROCESS_INFORMATION info;
+    ZeroMemory(&startup, sizeof(startup));
+    startup.cb = sizeof(startup);
+    if (!CreateProcessA(path, &command[0], NULL, NULL, FALSE, 0, NULL, NULL, &startup, &info)) return false;
+    CloseHandle(info.hThread);
+    process = info.hProcess;
+    return true;
+#else
+    char path[] = "/proc/self/exe";
+    char flag[] = "--sector";
+    char* argv[] = { path, flag, const_cast<char*>(segment.c_str()), const_cast<char*>(idText.c_str()), NULL };
+    return posix_spawn(&process, path, NULL, NULL, argv, environ) == 0;
+#endif
+}
+
+// Exit code of the process, once it has finished
+int waitSectorProcess(ProcessHandle process)
+{
+#ifdef _WIN32
+    WaitForSingleObject(process, INFINITE);
+    DWORD code = 1;
+    GetExitCodeProcess(process, &code);
+    CloseHandle(process);
+    return (int)code;
+#else
+    int status = 0;
+    if (waitpid(process, &status, 0) == -1) return -1;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#endif
+}
+
+// ===== CONCURRENT REGISTRY =====
+// Aircraft registry shared by several threads (radar feed, UI, planner).
+// Keys hash to one of STRIPES stripes, each with its own writer mutex and
+// bucket chains, so writers on different stripes never contend.
+//
+// Lookups take no lock. Each record is the aircraft encoded into atomic
+// words behind a seqlock, and each stripe has a structure counter that
+// writers make odd around every insert, remove and rehash; a reader whose
+// counter changed while it walked the chain tries again, and after a few
+// failed tries takes the stripe lock. Removed records go to the stripe's
+// free list instead of the heap and replaced bucket arrays are kept until
+// the registry is destroyed, so a reader that raced a writer only ever
+// reads stale words, never freed memory. Lookups copy the aircraft out:
+// there is no pointer for another thread to invalidate.
+
+// Registry encoding: every Aircraft field, strings as a varint length and
+// the bytes (uncapped, unlike the federation wire strings)
+void appendRecordString(string& out, const string& value)
+{
+    appendVarint(out, value.size());
+    out += value;
+}
+
+void encodeRegistryRecord(string& out, const Aircraft& a)
+{
+    out.clear();
+    appendRecordString(out, a.flightID);
+    appendRecordString(out, a.model);
+    appendRecordString(out, a.status);
+    appendRecordString(out, a.origin);
+    appendRecordString(out, a.destination);
+    appendRecordString(out, a.currentNode);
+    appendVarint(out, zigzag(a.fuelLevel));
+    appendVarint(out, zigzag(a.priority));
+    appendVarint(out, zigzag(a.x));
+    appendVarint(out, zigzag(a.y));
+    appendVarint(out, zigzag(a.timestamp));
+    appendVarint(out, zigzag(a.queuedAt));
+}
+
+void decodeRegistryRecord(const char* p, int length, Aircraft& a)
+{
+    const char* end = p + length;
+    readWireString(p, end, a.flightID);
+    readWireString(p, end, a.model);
+    readWireString(p, end, a.status);
+    readWireString(p, end, a.origin);
+    readWireString(p, end, a.destination);
+    readWireString(p, end, a.currentNode);
+    a.fuelLevel = (int)unzigzag(readVarint(p, end));
+    a.priority = (int)unzigzag(readVarint(p, end));
+    a.x = (int)unzigzag(readVarint(p, end));
+    a.y = (int)unzigzag(readVarint(p, end));
+    a.timestamp = unzigzag(readVarint(p, end));
+    a.queuedAt = unzigzag(readVarint(p, end));
+}
+
+// True if the encoded record's flight ID (its first field) is key
+bool registryRecordHasKey(const char* p, int length, const string& key)
+{
+    const char* end = p + length;
+    if (p == end) return false;
+    unsigned long long size = readVarint(p, end);
+    return size == key.size() && size <= (unsigned long long)(end - p) && memcmp(p, key.data(), key.size()) == 0;
+}
+
+class RegistryRecord
+{
+public:
+    std::atomic<RegistryRecord*> next;
+    std::atomic<unsigned int> hash;
+    std::atomic<unsigned int> sequence;     // odd while the record is being rewritten
+    std::atomic<int> length;                // encoded bytes
+    const int capacity;                     // words, fixed for the record's lifetime
+    std::atomic<unsigned long long>* words;
+
+    RegistryRecord(int wordCount) : next(NULL), hash(0), sequence(0), length(0), capacity(wordCount)
+    {
+        words = new std::atomic<unsigned long long>[wordCount];
+        for (int i = 0; i < wordCount; i++) words[i].store(0, std::memory_order_relaxed);
+    }
+
+    RegistryRecord(const RegistryRecord&) = delete;
+    RegistryRecord& operator=(const RegistryRecord&) = delete;
+
+    ~RegistryRecord() { delete[] words; }
+};
+
+class RegistryBuckets
+{
+public:
+    int mask;
+    std::atomic<RegistryRecord*>* heads;
+    RegistryBuckets* retired;               // the array this one replaced
+
+    RegistryBuckets(int size, RegistryBuckets* older) : mask(size - 1), retired(older)
+    {
+        heads = new std::atomic<RegistryRecord*>[size];
+        for (int i = 0; i < size; i++) heads[i].store(NULL, std::memory_order_relaxed);
+    }
+
+    RegistryBuckets(const RegistryBuckets&) = delete;
+    RegistryBuckets& operator=(const RegistryBuckets&) = delete;
+
+    ~RegistryBuckets() { delete[] heads; }
+};
+
+class RegistryStripe
+{
+public:
+    std::mutex writeLock;
+    std::atomic<unsigned int> structure;    // odd while a chain is being relinked
+    std::atomic<RegistryBuckets*> buckets;
+    std::atomic<int> count;
+    std::atomic<long long> lockedReads;     // lookups that fell back to the lock
+    RegistryRecord* freeList;               // guarded by writeLock
+    string encoded;                         // writer's encoding buffer, guarded by writeLock
+    Aircraft decoded;                       // record being modified, guarded by writeLock
+    char padding[64];                       // keeps neighbouring stripes off this cache line
+
+    RegistryStripe() : structure(0), buckets(NULL), count(0), lockedReads(0), freeList(NULL) {}
+};
+
+// Room to copy one record out: on the stack unless the record is large
+class RegistryReadBuffer
+{
+private:
+    static const int LOCAL_WORDS = 32;
+    char local[LOCAL_WORDS * 8];
+    string spill;
+
+public:
+    char* reserve(int words)
+    {
+        if (words <= LOCAL_WORDS) return local;
+        spill.resize((size_t)words * 8);
+        return &spill[0];
+    }
+};
+
+class ConcurrentRegistry
+{
+private:
+    static const int STRIPE_BITS = 6;
+    static const int STRIPES = 1 << STRIPE_BITS;
+    static const int INITIAL_BUCKETS = 16;
+    static const int RECORD_WORDS = 16;     // fits a typical aircraft; bigger records get their own size
+    static const int OPTIMISTIC_TRIES = 4;
+
+    RegistryStripe* stripes;
+    std::atomic<unsigned int>* pageVersions;    // bumped by every change to a page, under its stripe's lock
+
+    static int wordsFor(int bytes) { return (bytes + 7) / 8; }
+
+    RegistryStripe& stripeFor(unsigned int hash) { return stripes[hash & (STRIPES - 1)]; }
+
+    static int bucketFor(unsigned int hash, const RegistryBuckets* buckets)
+    {
+        return (int)((hash >> STRIPE_BITS) & (unsigned int)buckets->mask);
+    }
+
+    // Seqlock read of record into buffer (at least record.capacity words).
+    // False if a writer was rewriting it.
+    static bool readRecord(const RegistryRecord& record, char* buffer, int& length)
+    {
+        unsigned int before = record.sequence.load(std::memory_order_acquire);
+        if (before & 1) return false;
+        length = record.length.load(std::memory_order_relaxed);
+        if (length < 0 || wordsFor(length) > record.capacity) return false;
+        for (int i = 0; i < wordsFor(length); i++) {
+            unsigned long long word = record.words[i].load(std::memory_order_relaxed);
+            memcpy(buffer + i * 8, &word, 8);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return record.sequence.load(std::memory_order_relaxed) == before;
+    }
+
+    static void writeRecord(RegistryRecord& record, const string& bytes)
+    {
+        unsigned int sequence = record.sequence.load(std::memory_order_relaxed);
+        record.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        int words = wordsFor((int)bytes.size());
+        for (int i = 0; i < words; i++) {
+            unsigned long long word = 0;
+            size_t offset = (size_t)i * 8;
+            memcpy(&word, bytes.data() + offset, bytes.size() - offset < 8 ? bytes.size() - offset : 8);
+            record.words[i].store(word, std::memory_order_relaxed);
+        }
+        record.length.store((int)bytes.size(), std::memory_order_relaxed);
+        record.sequence.store(sequence + 2, std::memory_order_release);
+    }
 
-    int minDistance(int dist[], bool visited[])
+    // Writers bracket every relink with these, under the stripe lock
+    static void beginRelink(RegistryStripe& stripe)
     {
-        int min = INT_MAX;
-        int min_index = -1;
+        stripe.structure.store(stripe.structure.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
 
-        for (int i = 0; i < nodeCount; i++)
-            if (!visited[i] && dist[i] <= min) {
-                min = dist[i];
-                min_index = i;
+    static void endRelink(RegistryStripe& stripe)
+    {
+        stripe.structure.store(stripe.structure.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // A free record with room for bytes, or a new one
+    RegistryRecord* takeRecord(RegistryStripe& stripe, const string& bytes)
+    {
+        int words = wordsFor((int)bytes.size());
+        RegistryRecord* record = stripe.freeList;
+        if (record != NULL && record->capacity >= words) {
+            stripe.freeList = record->next.load(std::memory_order_relaxed);
+        }
+        else {
+            record = new RegistryRecord(words > RECORD_WORDS ? (words + 7) / 8 * 8 : RECORD_WORDS);
+        }
+        writeRecord(*record, bytes);
+        return record;
+    }
+
+    void releaseRecord(RegistryStripe& stripe, RegistryRecord* record)
+    {
+        record->next.store(stripe.freeList, std::memory_order_release);
+        stripe.freeList = record;
+    }
+
+    // The link pointing at key's record (NULL if absent); stripe lock held
+    std::atomic<RegistryRecord*>* findLinkLocked(RegistryStripe& stripe, unsigned int hash, const string& key, RegistryReadBuffer& buffer)
+    {
+        RegistryBuckets* buckets = stripe.buckets.load(std::memory_order_relaxed);
+        std::atomic<RegistryRecord*>* link = &buckets->heads[bucketFor(hash, buckets)];
+        for (RegistryRecord* record = link->load(std::memory_order_relaxed); record != NULL;
+            record = link->load(std::memory_order_relaxed)) {
+            if (record->hash.load(std::memory_order_relaxed) == hash) {
+                int length = 0;
+                char* bytes = buffer.reserve(record->capacity);
+                readRecord(*record, bytes, length);
+                if (registryRecordHasKey(bytes, length, key)) return link;
             }
-        return min_index;
+            link = &record->next;
+        }
+        return NULL;
     }
 
-    void clearEdges(Edge* edge)
+    // Relinks every record into a table twice the size; stripe lock held
+    void growLocked(RegistryStripe& stripe)
     {
-        while (edge != NULL) {
-            Edge* temp = edge;
-            edge = edge->next;
-            delete temp;
+        RegistryBuckets* old = stripe.buckets.load(std::memory_order_relaxed);
+        RegistryBuckets* bigger = new RegistryBuckets((old->mask + 1) * 2, old);
+        beginRelink(stripe);
+        for (int i = 0; i <= old->mask; i++) {
+            RegistryRecord* record = old->heads[i].load(std::memory_order_relaxed);
+            while (record != NULL) {
+                RegistryRecord* next = record->next.load(std::memory_order_relaxed);
+                std::atomic<RegistryRecord*>& head = bigger->heads[bucketFor(record->hash.load(std::memory_order_relaxed), bigger)];
+                record->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                head.store(record, std::memory_order_relaxed);
+                record = next;
+            }
+        }
+        stripe.buckets.store(bigger, std::memory_order_release);
+        endRelink(stripe);
+    }
+
+    void touchPage(unsigned int hash)
+    {
+        pageVersions[hash & (PAGES - 1)].fetch_add(1, std::memory_order_release);
+    }
+
+    // Rewrites the record behind link (currently the length bytes at
+    // current) with stripe.encoded, swapping in a larger record if it no
+    // longer fits. An unchanged record is left alone, so its page keeps
+    // its version. Stripe lock held.
+    void rewriteLocked(RegistryStripe& stripe, std::atomic<RegistryRecord*>* link, const char* current, int length)
+    {
+        if (length == (int)stripe.encoded.size() && memcmp(current, stripe.encoded.data(), length) == 0) return;
+        RegistryRecord* record = link->load(std::memory_order_relaxed);
+        touchPage(record->hash.load(std::memory_order_relaxed));
+        if (wordsFor((int)stripe.encoded.size()) <= record->capacity) {
+            writeRecord(*record, stripe.encoded);
+            return;
+        }
+        RegistryRecord* larger = takeRecord(stripe, stripe.encoded);
+        larger->hash.store(record->hash.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        larger->next.store(record->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        beginRelink(stripe);
+        link->store(larger, std::memory_order_release);
+        releaseRecord(stripe, record);
+        endRelink(stripe);
+    }
+
+    // Decodes the record behind link into stripe.decoded, lets change
+    // modify it and writes it back; stripe lock held
+    template <typename Change>
+    void modifyLocked(RegistryStripe& stripe, std::atomic<RegistryRecord*>* link, RegistryReadBuffer& buffer,
+        Change& change)
+    {
+        RegistryRecord* record = link->load(std::memory_order_relaxed);
+        char* bytes = buffer.reserve(record->capacity);
+        int length = 0;
+        readRecord(*record, bytes, length);
+        decodeRegistryRecord(bytes, length, stripe.decoded);
+        change(stripe.decoded);
+        encodeRegistryRecord(stripe.encoded, stripe.decoded);
+        rewriteLocked(stripe, link, bytes, length);
+    }
+
+    // Calls visit(const Aircraft&) with a copy of every aircraft in
+    // buckets first, first + step, ...; stripe lock held
+    template <typename Visitor>
+    void visitLocked(RegistryStripe& stripe, int first, int step, Visitor& visit)
+    {
+        RegistryReadBuffer buffer;
+        Aircraft& aircraft = stripe.decoded;
+        RegistryBuckets* buckets = stripe.buckets.load(std::memory_order_relaxed);
+        for (int b = first; b <= buckets->mask; b += step) {
+            for (RegistryRecord* record = buckets->heads[b].load(std::memory_order_relaxed); record != NULL;
+                record = record->next.load(std::memory_order_relaxed)) {
+                char* bytes = buffer.reserve(record->capacity);
+                int length = 0;
+                readRecord(*record, bytes, length);
+                decodeRegistryRecord(bytes, length, aircraft);
+                visit(aircraft);
+            }
+        }
+    }
+
+    // Writes aircraft under key; inserts only if insertMissing. True if
+    // the key was already present.
+    bool store(const Aircraft& aircraft, bool insertMissing)
+    {
+        unsigned int hash = hashString(aircraft.flightID);
+        RegistryStripe& stripe = stripeFor(hash);
+        RegistryReadBuffer buffer;
+
+        std::lock_guard<std::mutex> guard(stripe.writeLock);
+        std::atomic<RegistryRecord*>* link = findLinkLocked(stripe, hash, aircraft.flightID, buffer);
+        if (link != NULL) {
+            RegistryRecord* record = link->load(std::memory_order_relaxed);
+            char* bytes = buffer.reserve(record->capacity);
+            int length = 0;
+            readRecord(*record, bytes, length);
+            encodeRegistryRecord(stripe.encoded, aircraft);
+            rewriteLocked(stripe, link, bytes, length);
+            return true;
+        }
+        if (!insertMissing) return false;
+        encodeRegistryRecord(stripe.encoded, aircraft);
+
+        if (stripe.count.load(std::memory_order_relaxed) > stripe.buckets.load(std::memory_order_relaxed)->mask)
+            growLocked(stripe);
+        RegistryBuckets* buckets = stripe.buckets.load(std::memory_order_relaxed);
+        std::atomic<RegistryRecord*>& head = buckets->heads[bucketFor(hash, buckets)];
+        RegistryRecord* record = takeRecord(stripe, stripe.encoded);
+        record->hash.store(hash, std::memory_order_relaxed);
+        record->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        beginRelink(stripe);
+        head.store(record, std::memory_order_release);
+        endRelink(stripe);
+        stripe.count.fetch_add(1, std::memory_order_relaxed);
+        touchPage(hash);
+        return false;
+    }
+
+    // One lock-free pass over key's chain: ATC_OK / ATC_NOT_FOUND, or
+    // ATC_EMPTY if a writer interfered and the pass has to be repeated
+    AtcStatus tryOptimisticGet(RegistryStripe& stripe, unsigned int hash, const string& key, Aircraft& out)
+    {
+        RegistryReadBuffer buffer;
+
+        unsigned int structure = stripe.structure.load(std::memory_order_acquire);
+        if (structure & 1) return ATC_EMPTY;
+        RegistryBuckets* buckets = stripe.buckets.load(std::memory_order_acquire);
+        RegistryRecord* record = buckets->heads[bucketFor(hash, buckets)].load(std::memory_order_acquire);
+        int steps = 0, limit = stripe.count.load(std::memory_order_relaxed) + 2;
+        bool found = false;
+        while (record != NULL && !found) {
+            if (++steps > limit) return ATC_EMPTY;      // walked into a relinked chain
+            if (record->hash.load(std::memory_order_relaxed) == hash) {
+                char* bytes = buffer.reserve(record->capacity);
+                int length = 0;
+                if (!readRecord(*record, bytes, length)) return ATC_EMPTY;
+                if (registryRecordHasKey(bytes, length, key)) {
+                    decodeRegistryRecord(bytes, length, out);
+                    found = true;
+                }
+            }
+            record = record->next.load(std::memory_order_acquire);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (stripe.structure.load(std::memory_order_relaxed) != structure) return ATC_EMPTY;
+        return found ? ATC_OK : ATC_NOT_FOUND;
+    }
+
+public:
+    // Snapshot pages: a key's page is the low bits of its hash, so each
+    // page lies in one stripe, in every INITIAL_BUCKETS-th of its buckets
+    static const int PAGES = STRIPES * INITIAL_BUCKETS;
+
+    ConcurrentRegistry()
+    {
+        stripes = new RegistryStripe[STRIPES];
+        for (int s = 0; s < STRIPES; s++) stripes[s].buckets.store(new RegistryBuckets(INITIAL_BUCKETS, NULL));
+        pageVersions = new std::atomic<unsigned int>[PAGES];
+        for (int p = 0; p < PAGES; p++) pageVersions[p].store(0, std::memory_order_relaxed);
+    }
+
+    ConcurrentRegistry(const ConcurrentRegistry&) = delete;
+    ConcurrentRegistry& operator=(const ConcurrentRegistry&) = delete;
+
+    // Adds the aircraft, or replaces the one registered under its ID
+    void insert(const Aircraft& aircraft) { store(aircraft, true); }
+
+    // False if no aircraft is registered under aircraft.flightID
+    bool update(const Aircraft& aircraft) { return store(aircraft, false); }
+
+    bool remove(const string& key)
+    {
+        unsigned int hash = hashString(key);
+        RegistryStripe& stripe = stripeFor(hash);
+        RegistryReadBuffer buffer;
+
+        std::lock_guard<std::mutex> guard(stripe.writeLock);
+        std::atomic<RegistryRecord*>* link = findLinkLocked(stripe, hash, key, buffer);
+        if (link == NULL) return false;
+        RegistryRecord* record = link->load(std::memory_order_relaxed);
+        beginRelink(stripe);
+        link->store(record->next.load(std::memory_order_relaxed), std::memory_order_release);
+        releaseRecord(stripe, record);
+        endRelink(stripe);
+        stripe.count.fetch_sub(1, std::memory_order_relaxed);
+        touchPage(hash);
+        return true;
+    }
+
+    // Copies the aircraft registered under key into out. Lock-free unless
+    // writers keep relinking the key's stripe.
+    AtcStatus tryGet(const string& key, Aircraft& out)
+    {
+        unsigned int hash = hashString(key);
+        RegistryStripe& stripe = stripeFor(hash);
+        for (int attempt = 0; attempt < OPTIMISTIC_TRIES; attempt++) {
+            AtcStatus status = tryOptimisticGet(stripe, hash, key, out);
+            if (status != ATC_EMPTY) return status;
+            std::this_thread::yield();
+        }
+
+        stripe.lockedReads.fetch_add(1, std::memory_order_relaxed);
+        RegistryReadBuffer buffer;
+        std::lock_guard<std::mutex> guard(stripe.writeLock);
+        std::atomic<RegistryRecord*>* link = findLinkLocked(stripe, hash, key, buffer);
+        if (link == NULL) return ATC_NOT_FOUND;
+        RegistryRecord* record = link->load(std::memory_order_relaxed);
+        char* bytes = buffer.reserve(record->capacity);
+        int length = 0;
+        readRecord(*record, bytes, length);
+        decodeRegistryRecord(bytes, length, out);
+        return ATC_OK;
+    }
+
+    bool contains(const string& key)
+    {
+        Aircraft ignored;
+        return tryGet(key, ignored) == ATC_OK;
+    }
+
+    // Calls change(Aircraft&) on the aircraft registered under key and
+    // stores the result, all under the stripe lock, so writers to the same
+    // flight never lose each other's changes. change must keep the flight
+    // ID and must not call back into the registry.
+    template <typename Change>
+    AtcStatus tryModify(const string& key, Change& change)
+    {
+        unsigned int hash = hashString(key);
+        RegistryStripe& stripe = stripeFor(hash);
+        RegistryReadBuffer buffer;
+
+        std::lock_guard<std::mutex> guard(stripe.writeLock);
+        std::atomic<RegistryRecord*>* link = findLinkLocked(stripe, hash, key, buffer);
+        if (link == NULL) return ATC_NOT_FOUND;
+        modifyLocked(stripe, link, buffer, change);
+        return ATC_OK;
+    }
+
+    // tryModify for every aircraft, one stripe at a time under that
+    // stripe's lock. Once the stripes' buffers have grown this allocates
+    // nothing, so a simulation tick can run it.
+    template <typename Change>
+    void modifyEach(Change& change)
+    {
+        RegistryReadBuffer buffer;
+        for (int s = 0; s < STRIPES; s++) {
+            RegistryStripe& stripe = stripes[s];
+            std::lock_guard<std::mutex> guard(stripe.writeLock);
+            RegistryBuckets* buckets = stripe.buckets.load(std::memory_order_relaxed);
+            for (int b = 0; b <= buckets->mask; b++) {
+                // a rewrite may swap the record behind link, so step through links
+                for (std::atomic<RegistryRecord*>* link = &buckets->heads[b]; link->load(std::memory_order_relaxed) != NULL;
+                    link = &link->load(std::memory_order_relaxed)->next)
+                    modifyLocked(stripe, link, buffer, change);
+            }
+        }
+    }
+
+    // Drops every aircraft; their records go back to each stripe's free list
+    void clear()
+    {
+        for (int s = 0; s < STRIPES; s++) {
+            RegistryStripe& stripe = stripes[s];
+            std::lock_guard<std::mutex> guard(stripe.writeLock);
+            RegistryBuckets* buckets = stripe.buckets.load(std::memory_order_relaxed);
+            beginRelink(stripe);
+            for (int b = 0; b <= buckets->mask; b++) {
+                RegistryRecord* record = buckets->heads[b].load(std::memory_order_relaxed);
+                buckets->heads[b].store(NULL, std::memory_order_relaxed);
+                while (record != NULL) {
+                    RegistryRecord* next = record->next.load(std::memory_order_relaxed);
+                    touchPage(record->hash.load(std::memory_order_relaxed));
+                    releaseRecord(stripe, record);
+                    record = next;
+                }
+            }
+            endRelink(stripe);
+            stripe.count.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Replaces the contents with a file in HashTable's format: a count,
+    // then one aircraft per line
+    void loadFromFile(string filename)
+    {
+        ifstream file(filename);
+        if (!file.is_open()) throw FileOperationException(filename);
+
+        clear();
+        string line;
+        getline(file, line);
+        int count = stoi(line);
+        for (int i = 0; i < count; i++) {
+            getline(file, line);
+            if (line.empty()) continue;
+            insert(Aircraft::fromString(line));
+        }
+        file.close();
+    }
+
+    // Calls visit(const Aircraft&) with a copy of every aircraft, one
+    // stripe at a time under that stripe's lock
+    template <typename Visitor>
+    void forEach(Visitor& visit)
+    {
+        for (int s = 0; s < STRIPES; s++) {
+            std::lock_guard<std::mutex> guard(stripes[s].writeLock);
+            visitLocked(stripes[s], 0, 1, visit);
+        }
+    }
+
+    static int pageOf(const string& key) { return (int)(hashString(key) & (PAGES - 1)); }
+
+    // Changes whenever an aircraft on the page is added, changed or
+    // removed. Read it before copying the page: a copy taken afterwards
+    // is at least that new.
+    unsigned int getPageVersion(int page) { return pageVersions[page].load(std::memory_order_acquire); }
+
+    // forEach for the aircraft on one page, under its stripe's lock
+    template <typename Visitor>
+    void forEachInPage(int page, Visitor& visit)
+    {
+        RegistryStripe& stripe = stripes[page & (STRIPES - 1)];
+        std::lock_guard<std::mutex> guard(stripe.writeLock);
+        visitLocked(stripe, page >> STRIPE_BITS, INITIAL_BUCKETS, visit);
+    }
+
+    int getCount()
+    {
+        int total = 0;
+        for (int s = 0; s < STRIPES; s++) total += stripes[s].count.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    long long getLockedReads()
+    {
+        long long total = 0;
+        for (int s = 0; s < STRIPES; s++) total += stripes[s].lockedReads.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    int getStripeCount() { return STRIPES; }
+
+    ~ConcurrentRegistry()
+    {
+        for (int s = 0; s < STRIPES; s++) {
+            RegistryBuckets* buckets = stripes[s].buckets.load();
+            for (int b = 0; b <= buckets->mask; b++) {
+                RegistryRecord* record = buckets->heads[b].load();
+                while (record != NULL) {
+                    RegistryRecord* next = record->next.load();
+                    delete record;
+                    record = next;
+                }
+            }
+            while (stripes[s].freeList != NULL) {
+                RegistryRecord* next = stripes[s].freeList->next.load();
+                delete stripes[s].freeList;
+                stripes[s].freeList = next;
+            }
+            while (buckets != NULL) {
+                RegistryBuckets* older = buckets->retired;
+                delete buckets;
+                buckets = older;
+            }
+        }
+        delete[] stripes;
+        delete[] pageVersions;
+    }
+};
+
+// ===== COMMAND QUEUE =====
+// Bounded multi-producer / single-consumer queue (Vyukov's per-cell
+// sequence scheme). A producer claims a cell by advancing the enqueue
+// position with a CAS, fills it, then publishes it by storing the cell's
+// sequence; the single consumer needs no atomic read-modify-write at all.
+// A full queue is reported, not waited on, so a producer never blocks the
+// consumer and decides itself whether to drop or retry.
+template <typename T>
+class MpscQueue
+{
+private:
+    class Cell
+    {
+    public:
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    Cell* cells;
+    size_t mask;
+    std::atomic<size_t> enqueuePos;
+    char padding[64];                   // producers and consumer on separate cache lines
+    size_t dequeuePos;                  // consumer only
+    std::atomic<long long> rejected;    // pushes refused because the queue was full
+    long long drained;
+    long long batches;
+    size_t maxDepth;
+
+public:
+    // capacity is rounded up to a power of two
+    MpscQueue(int capacity) : enqueuePos(0), dequeuePos(0), rejected(0), drained(0), batches(0), maxDepth(0)
+    {
+        size_t size = 2;
+        while (size < (size_t)capacity) size *= 2;
+        cells = new Cell[size];
+        mask = size - 1;
+        for (size_t i = 0; i < size; i++) cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Any thread. False (and counted) if the queue is full.
+    bool tryPush(const T& value)
+    {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            long long lag = (long long)(sequence - pos);
+            if (lag == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (lag < 0) {
+                rejected.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer only. Hands up to max queued values to handle(T&) in FIFO
+    // order (per producer) and returns how many were handled.
+    template <typename Handler>
+    int drain(Handler& handle, int max)
+    {
+        size_t depth = getDepth();
+        if (depth > maxDepth) maxDepth = depth;
+
+        int count = 0;
+        while (count < max) {
+            Cell& cell = cells[dequeuePos & mask];
+            if (cell.sequence.load(std::memory_order_acquire) != dequeuePos + 1) break;
+            handle(cell.value);
+            cell.value = T();
+            cell.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+            dequeuePos++;
+            count++;
+        }
+        if (count > 0) {
+            drained += count;
+            batches++;
+        }
+        return count;
+    }
+
+    // Approximate while producers are active
+    size_t getDepth() { return enqueuePos.load(std::memory_order_relaxed) - dequeuePos; }
+    int getCapacity() { return (int)(mask + 1); }
+    long long getRejected() { return rejected.load(std::memory_order_relaxed); }
+    long long getDrained() { return drained; }
+    long long getBatches() { return batches; }
+    size_t getMaxDepth() { return maxDepth; }
+
+    // Only while no producer is pushing
+    void clearStats()
+    {
+        rejected.store(0);
+        drained = 0;
+        batches = 0;
+        maxDepth = 0;
+    }
+
+    ~MpscQueue() { delete[] cells; }
+};
+
+// Work for the control loop, queued by feed, script, timer or UI threads
+enum CommandType
+{
+    CMD_NONE,
+    CMD_ADD_FLIGHT,         // aircraft: the new flight
+    CMD_POSITION_REPORT,    // aircraft.flightID now at node
+    CMD_EMERGENCY,          // aircraft.flightID raised to priority value
+    CMD_TICK                // advance the simulation clock one tick
+};
+
+class ControlCommand
+{
+public:
+    CommandType type;
+    Aircraft aircraft;
+    string node;
+    int value;
+    long long issuedMicros;     // steadyMicros() when queued, for latency
+
+    ControlCommand() : type(CMD_NONE), value(0), issuedMicros(0) {}
+};
+
+// Control-loop totals for applied commands
+class CommandStats
+{
+public:
+    long long applied;
+    long long failed;           // unknown flight or node, or an add that was refused
+    long long conflicts;        // position reports naming a node another flight holds
+    long long landed;           // landings during queued ticks
+    long long latencyMicros;    // queued to applied, summed
+    long long maxLatencyMicros;
+
+    CommandStats() { clear(); }
+
+    void clear()
+    {
+        applied = failed = conflicts = landed = 0;
+        latencyMicros = maxLatencyMicros = 0;
+    }
+};
+
+// ===== SNAPSHOTS =====
+// Read-copy-update publication. The engine builds a new immutable version
+// off to the side and swaps one pointer; a reader pins whichever version
+// is current with a hazard pointer, so it takes no lock, never sees a
+// half-built version and never holds the engine up. A replaced version is
+// deleted once no hazard pointer names it. One thread publishes; up to
+// READERS threads may hold a version at the same time.
+template <typename T>
+class SnapshotCell
+{
+private:
+    static const int READERS = 64;
+
+    std::atomic<T*> current;
+    std::atomic<T*> hazards[READERS];
+    std::atomic<int> claimed[READERS];
+    DynamicArray<T*> retired;               // publisher only
+
+    // Deletes every retired version no reader has pinned
+    void reclaim()
+    {
+        int kept = 0;
+        for (int r = 0; r < retired.size(); r++) {
+            bool pinned = false;
+            for (int i = 0; i < READERS && !pinned; i++) pinned = hazards[i].load() == retired[r];
+            if (pinned) retired[kept++] = retired[r];
+            else delete retired[r];
+        }
+        retired.resize(kept);
+    }
+
+public:
+    SnapshotCell() : current(NULL)
+    {
+        for (int i = 0; i < READERS; i++) {
+            hazards[i].store(NULL);
+            claimed[i].store(0);
+        }
+    }
+
+    SnapshotCell(const SnapshotCell&) = delete;
+    SnapshotCell& operator=(const SnapshotCell&) = delete;
+
+    // Makes fresh the current version; the cell owns it from here on
+    void publish(T* fresh)
+    {
+        T* old = current.exchange(fresh);
+        if (old != NULL) retired.push(old);
+        reclaim();
+    }
+
+    bool hasVersion() { return current.load(std::memory_order_acquire) != NULL; }
+
+    // Pins the current version (NULL if none was published) in a free
+    // hazard slot; returns the slot for unpin
+    int pin(T*& version)
+    {
+        int slot = 0;
+        int expected = 0;
+        while (!claimed[slot].compare_exchange_weak(expected, 1, std::memory_order_acquire)) {
+            expected = 0;
+            if (++slot == READERS) {
+                slot = 0;
+                std::this_thread::yield();
+            }
         }
+        // Re-check after publishing the hazard: the version may have been
+        // retired in between
+        T* seen = current.load();
+        do {
+            version = seen;
+            hazards[slot].store(version);
+            seen = current.load();
+        } while (seen != version);
+        return slot;
+    }
+
+    void unpin(int slot)
+    {
+        hazards[slot].store(NULL);
+        claimed[slot].store(0, std::memory_order_release);
+    }
+
+    ~SnapshotCell()
+    {
+        for (int r = 0; r < retired.size(); r++) delete retired[r];
+        delete current.load();
+    }
+};
+
+// A pinned version for the lifetime of the reader object
+template <typename T>
+class SnapshotReader
+{
+private:
+    SnapshotCell<T>& cell;
+    T* version;
+    int slot;
+
+public:
+    SnapshotReader(SnapshotCell<T>& source) : cell(source), version(NULL)
+    {
+        slot = cell.pin(version);
+    }
+
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    ~SnapshotReader() { cell.unpin(slot); }
+
+    T* get() { return version; }
+    T* operator->() { return version; }
+    T& operator*() { return *version; }
+};
+
+// Rows shared by consecutive snapshots while their source is unchanged,
+// freed with the last snapshot that refers to them
+template <typename T>
+class SharedRows
+{
+private:
+    std::atomic<int> references;
+
+    SharedRows() : references(1) {}
+    ~SharedRows() {}
+
+public:
+    DynamicArray<T> rows;
+
+    static SharedRows* create() { return new SharedRows(); }
+
+    SharedRows* share()
+    {
+        references.fetch_add(1, std::memory_order_relaxed);
+        return this;
+    }
+
+    void release()
+    {
+        if (references.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
     }
+};
+
+// One registry page's aircraft, indexed by flight ID. Consecutive
+// snapshots share a page until the registry changes it; it is freed with
+// the last snapshot that refers to it.
+class AircraftPage
+{
+private:
+    std::atomic<int> references;
+    int* index;             // positions in rows by flight ID hash, -1 empty
+    int indexMask;
+
+    AircraftPage() : references(1), index(NULL), indexMask(0) {}
+    ~AircraftPage() { delete[] index; }
 
 public:
-    Graph() : nodeCount(0)
+    DynamicArray<Aircraft> rows;
+
+    static AircraftPage* create() { return new AircraftPage(); }
+
+    AircraftPage* share()
+    {
+        references.fetch_add(1, std::memory_order_relaxed);
+        return this;
+    }
+
+    void release()
     {
-        for (int i = 0; i < MAX_NODES; i++) {
-            nodes[i] = NULL;
-            adjList[i] = NULL;
+        if (references.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+    }
+
+    // Builds the flight ID index once every row has been added
+    void seal()
+    {
+        if (rows.empty()) return;
+        int size = 4;
+        while (size < rows.size() * 2) size *= 2;
+        delete[] index;
+        index = new int[size];
+        indexMask = size - 1;
+        for (int i = 0; i < size; i++) index[i] = -1;
+        for (int a = 0; a < rows.size(); a++) {
+            int i = (int)(hashString(rows[a].flightID) & (unsigned int)indexMask);
+            while (index[i] != -1) i = (i + 1) & indexMask;
+            index[i] = a;
         }
     }
 
-    ~Graph()
+    const Aircraft* find(const string& flightID) const
+    {
+        if (index == NULL) return NULL;
+        int i = (int)(hashString(flightID) & (unsigned int)indexMask);
+        for (; index[i] != -1; i = (i + 1) & indexMask)
+            if (rows[index[i]].flightID == flightID) return &rows[index[i]];
+        return NULL;
+    }
+};
+
+// Point-in-time view of what the displays and saves read: the registered
+// aircraft (one page per registry page), the radar's traffic counts (node
+// occupancy as the radar sees it), the flight log's in-memory window and
+// the headline totals. Immutable once published.
+class AirspaceSnapshot
+{
+public:
+    long long version;
+    long clock;
+    DynamicArray<AircraftPage*> pages;
+    int aircraftCount;
+    CountPyramid traffic;
+    SharedRows<Aircraft>* recentLog;
+    int queued;
+    int logged;
+    long landingsLastHour;  // -1 before the first landing
+    double waitEwma;        // negative before the first wait sample
+    long long commandsApplied;
+
+    AirspaceSnapshot() : version(0), clock(0), aircraftCount(0), recentLog(NULL),
+        queued(0), logged(0), landingsLastHour(-1), waitEwma(-1), commandsApplied(0) {
+    }
+
+    AirspaceSnapshot(const AirspaceSnapshot&) = delete;
+    AirspaceSnapshot& operator=(const AirspaceSnapshot&) = delete;
+
+    // Adds the next registry page; the snapshot takes its own reference
+    void addPage(AircraftPage* page)
+    {
+        pages.push(page->share());
+        aircraftCount += page->rows.size();
+    }
+
+    // NULL if the flight was not registered in this version
+    const Aircraft* find(const string& flightID) const
     {
-        for (int i = 0; i < nodeCount; i++) {
-            delete nodes[i];
-            clearEdges(adjList[i]);
-        }
+        if (pages.size() != ConcurrentRegistry::PAGES) return NULL;
+        return pages[ConcurrentRegistry::pageOf(flightID)]->find(flightID);
     }
 
-    void addNode(string name, int x, int y, bool isAirport = false)
+    ~AirspaceSnapshot()
     {
-        if (findNodeIndex(name) != -1) return;
-        if (nodeCount >= MAX_NODES) return;
-
-        nodes[nodeCount] = new GraphNode(name, x, y, isAirport);
-        nodeCount++;
+        for (int p = 0; p < pages.size(); p++) pages[p]->release();
+        if (recentLog != NULL) recentLog->release();
     }
+};
 
-    void addEdge(string src, string dest, int weight)
-    {
-        int srcIdx = findNodeIndex(src);
-        int destIdx = findNodeIndex(dest);
+// ===== CHECKPOINTS =====
+enum CheckpointState
+{
+    CHECKPOINT_IDLE,
+    CHECKPOINT_RUNNING,
+    CHECKPOINT_FINISHED
+};
 
-        if (srcIdx == -1 || destIdx == -1) return;
+struct CheckpointReport
+{
+    long long version;      // snapshot version written, 0 before the first checkpoint
+    int records;
+    long long bytes;
+    long long micros;
+    string error;           // empty when both files were replaced
 
-        Edge* newEdge = new Edge(dest, weight);
-        newEdge->next = adjList[srcIdx];
-        adjList[srcIdx] = newEdge;
+    CheckpointReport() : version(0), records(0), bytes(0), micros(0) {}
+};
+
+// Writes the latest snapshot to disk on a background thread, one checkpoint
+// at a time. The control thread only starts it and later collects the
+// report, so it never waits on the disk.
+class Checkpointer
+{
+private:
+    std::thread worker;
+    std::atomic<int> state;
+    std::atomic<long long> bytesWritten;
+    std::atomic<int> recordsWritten;
+    std::atomic<int> recordsTotal;
+    std::atomic<long long> version;
+    CheckpointReport result;    // worker's, complete once state is FINISHED
+    CheckpointReport last;      // control thread's copy of the last finished one
+    int finished;
+
+    // "<count> <snapshot version>"; loaders that only read the count still
+    // accept it
+    void writeHeader(CheckpointFile& file, int count, long long snapshot)
+    {
+        string line = toString(count);
+        line += ' ';
+        appendNumber(line, snapshot);
+        line += '\n';
+        file.append(line);
     }
 
-    bool isNodeOccupied(string nodeName)
+    void writeRows(CheckpointFile& file, const Aircraft* rows, int count)
     {
-        int idx = findNodeIndex(nodeName);
-        return (idx != -1) ? nodes[idx]->occupied : false;
+        string line;
+        for (int i = 0; i < count; i++) {
+            line.clear();
+            rows[i].appendTo(line);
+            line += '\n';
+            file.append(line);
+            recordsWritten.fetch_add(1, std::memory_order_relaxed);
+        }
     }
 
-    bool isNodeReachable(string from, string to)
+    // Same layouts as HashTable::saveToFile and TieredFlightLog::saveToFile
+    // (the in-memory window), plus the snapshot version in both headers:
+    // the two files are committed one after the other, so a pair whose
+    // versions differ was cut short in between. view was pinned in slot
+    // by start().
+    void write(SnapshotCell<AirspaceSnapshot>& cell, AirspaceSnapshot* view, int slot,
+        const string& registryFile, const string& logFile)
     {
-        int fromIdx = findNodeIndex(from);
-        if (fromIdx == -1) return false;
+        long long begin = steadyMicros();
+        result = CheckpointReport();
+        try {
+            SharedRows<Aircraft>* log = view->recentLog;
+            int logCount = (log != NULL) ? log->rows.size() : 0;
+            version.store(view->version, std::memory_order_relaxed);
+            recordsTotal.store(view->aircraftCount + logCount, std::memory_order_relaxed);
+            result.version = view->version;
+
+            CheckpointFile registry(registryFile, &bytesWritten);
+            writeHeader(registry, view->aircraftCount, view->version);
+            for (int p = 0; p < view->pages.size(); p++) {
+                DynamicArray<Aircraft>& rows = view->pages[p]->rows;
+                writeRows(registry, rows.data(), rows.size());
+            }
+            registry.commit();
 
-        Edge* edge = adjList[fromIdx];
-        while (edge != NULL) {
-            if (edge->destination == to) return true;
-            edge = edge->next;
+            CheckpointFile history(logFile, &bytesWritten);
+            writeHeader(history, logCount, view->version);
+            writeRows(history, logCount > 0 ? log->rows.data() : NULL, logCount);
+            history.commit();
         }
-        return false;
+        catch (AircraftException& e) {
+            result.error = e.what();
+        }
+        cell.unpin(slot);
+        result.records = recordsWritten.load(std::memory_order_relaxed);
+        result.bytes = bytesWritten.load(std::memory_order_relaxed);
+        result.micros = steadyMicros() - begin;
+        state.store(CHECKPOINT_FINISHED, std::memory_order_release);
     }
 
-    bool occupyNode(string nodeName, string flightID)
-    {
-        int idx = findNodeIndex(nodeName);
-        if (idx == -1) return false;
+public:
+    Checkpointer() : state(CHECKPOINT_IDLE), bytesWritten(0), recordsWritten(0), recordsTotal(0), version(0),
+        finished(0) {
+    }
 
-        if (nodes[idx]->occupied)
-            throw CollisionException("(" + toString(nodes[idx]->x) + ", " + toString(nodes[idx]->y) + ")");
+    Checkpointer(const Checkpointer&) = delete;
+    Checkpointer& operator=(const Checkpointer&) = delete;
 
-        nodes[idx]->occupied = true;
-        nodes[idx]->occupiedBy = flightID;
+    // Writes the version that is latest now, pinned here so that nothing the
+    // control thread publishes afterwards can end up in this checkpoint.
+    // False while the previous checkpoint is still being written.
+    bool start(SnapshotCell<AirspaceSnapshot>& cell, const string& registryFile, const string& logFile)
+    {
+        poll();
+        if (state.load(std::memory_order_acquire) == CHECKPOINT_RUNNING) return false;
+        if (worker.joinable()) worker.join();
+        AirspaceSnapshot* view = NULL;
+        int slot = cell.pin(view);
+        bytesWritten.store(0, std::memory_order_relaxed);
+        recordsWritten.store(0, std::memory_order_relaxed);
+        recordsTotal.store(0, std::memory_order_relaxed);
+        version.store(view->version, std::memory_order_relaxed);
+        state.store(CHECKPOINT_RUNNING, std::memory_order_relaxed);
+        worker = std::thread([this, &cell, view, slot, registryFile, logFile]() {
+            write(cell, view, slot, registryFile, logFile);
+        });
         return true;
     }
 
-    void freeNode(string nodeName)
+    // Blocks until the running checkpoint, if any, has finished
+    void wait()
     {
-        int idx = findNodeIndex(nodeName);
-        if (idx != -1) {
-            nodes[idx]->occupied = false;
-            nodes[idx]->occupiedBy = "";
-        }
+        if (worker.joinable()) worker.join();
+        poll();
     }
 
-    // NEW: Get full Dijkstra path as array (for step-by-step movement)
-    void getDijkstraPath(string start, string end, string path[], int& pathCount)
+    // Collects a finished checkpoint's report; true once per checkpoint
+    bool poll()
     {
-        int startIdx = findNodeIndex(start);
-        int endIdx = findNodeIndex(end);
-
-        if (startIdx == -1 || endIdx == -1)
-            throw InvalidInputException("Node name");
-
-        int dist[50];
-        bool visited[50];
-        int parent[50];
-
-        for (int i = 0; i < nodeCount; i++) {
-            dist[i] = INT_MAX;
-            visited[i] = false;
-            parent[i] = -1;
-        }
-
-        dist[startIdx] = 0;
-
-        for (int count = 0; count < nodeCount - 1; count++) {
-            int u = minDistance(dist, visited);
-            if (u == -1) break;
-
-            visited[u] = true;
+        if (state.load(std::memory_order_acquire) != CHECKPOINT_FINISHED) return false;
+        if (worker.joinable()) worker.join();
+        last = result;
+        finished++;
+        state.store(CHECKPOINT_IDLE, std::memory_order_relaxed);
+        return true;
+    }
 
-            Edge* edge = adjList[u];
-            while (edge != NULL) {
-                int v = findNodeIndex(edge->destination);
-                if (v != -1 && !visited[v] && dist[u] != INT_MAX &&
-                    dist[u] + edge->weight < dist[v]) {
-                    dist[v] = dist[u] + edge->weight;
-                    parent[v] = u;
-                }
-                edge = edge->next;
-            }
-        }
+    bool isRunning() { return state.load(std::memory_order_acquire) == CHECKPOINT_RUNNING; }
 
-        if (dist[endIdx] == INT_MAX)
-            throw NoPathException(start, end);
+    // Progress of the running checkpoint
+    long long getVersion() { return version.load(std::memory_order_relaxed); }
+    long long getBytesWritten() { return bytesWritten.load(std::memory_order_relaxed); }
+    int getPercent()
+    {
+        int total = recordsTotal.load(std::memory_order_relaxed);
+        return (total > 0) ? (int)((long long)recordsWritten.load(std::memory_order_relaxed) * 100 / total) : 0;
+    }
 
-        // Build path
-        pathCount = 0;
-        int current = endIdx;
-        while (current != -1) {
-            path[pathCount++] = nodes[current]->name;
-            current = parent[current];
-        }
+    const CheckpointReport& getLast() { return last; }
+    int getFinished() { return finished; }
 
-        // Reverse path (currently end->start)
-        for (int i = 0; i < pathCount / 2; i++) {
-            string temp = path[i];
-            path[i] = path[pathCount - 1 - i];
-            path[pathCount - 1 - i] = temp;
-        }
+    // Snapshot version in a checkpoint file's header, -1 if the file was
+    // written without one. Throws FileOperationException if it is missing.
+    static long long readVersion(const string& filename)
+    {
+        ifstream file(filename);
+        if (!file.is_open()) throw FileOperationException(filename);
+        string line;
+        getline(file, line);
+        size_t space = line.find(' ');
+        return (space == string::npos) ? -1 : atoll(line.c_str() + space + 1);
     }
 
-    void dijkstra(string start, string end)
+    ~Checkpointer()
     {
-        int startIdx = findNodeIndex(start);
-        int endIdx = findNodeIndex(end);
-
-        if (startIdx == -1 || endIdx == -1)
-            throw InvalidInputException("Node name");
-
-        int dist[50];
-        bool visited[50];
-        int parent[50];
-        string pathNodes[50];
-        int pathCount = 0;
+        if (worker.joinable()) worker.join();
+    }
+};
 
-        for (int i = 0; i < nodeCount; i++) {
-            dist[i] = INT_MAX;
-            visited[i] = false;
-            parent[i] = -1;
-        }
+// ===== FEED INGESTION =====
+// Read-only view of a whole file: mmap, or a Win32 file mapping
+class MappedFile
+{
+private:
+    const char* base;
+    size_t bytes;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
 
-        dist[startIdx] = 0;
+public:
+#ifdef _WIN32
+    MappedFile() : base(NULL), bytes(0), file(INVALID_HANDLE_VALUE), mapping(NULL) {}
+#else
+    MappedFile() : base(NULL), bytes(0) {}
+#endif
 
-        for (int count = 0; count < nodeCount - 1; count++) {
-            int u = minDistance(dist, visited);
-            if (u == -1) break;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
 
-            visited[u] = true;
+    ~MappedFile() { close(); }
 
-            Edge* edge = adjList[u];
-            while (edge != NULL) {
-                int v = findNodeIndex(edge->destination);
-                if (v != -1 && !visited[v] && dist[u] != INT_MAX &&
-                    dist[u] + edge->weight < dist[v]) {
-                    dist[v] = dist[u] + edge->weight;
-                    parent[v] = u;
-                }
-                edge = edge->next;
-            }
+    void open(const string& filename)
+    {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+            FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (file == INVALID_HANDLE_VALUE) throw FileOperationException(filename);
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            close();
+            throw FileOperationException(filename);
         }
+        bytes = (size_t)size.QuadPart;
+        if (bytes == 0) return;     // an empty file cannot be mapped
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL) base = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (base == NULL) {
+            close();
+            throw FileOperationException(filename);
+        }
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd == -1) throw FileOperationException(filename);
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw FileOperationException(filename);
+        }
+        bytes = (size_t)info.st_size;
+        if (bytes == 0) {
+            ::close(fd);
+            return;
+        }
+        void* view = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) {
+            bytes = 0;
+            throw FileOperationException(filename);
+        }
+        // read front to back once: let the kernel read ahead and drop pages behind
+        madvise(view, bytes, MADV_SEQUENTIAL);
+        base = static_cast<const char*>(view);
+#endif
+    }
 
-        if (dist[endIdx] == INT_MAX)
-            throw NoPathException(start, end);
+    void close()
+    {
+#ifdef _WIN32
+        if (base != NULL) UnmapViewOfFile(base);
+        if (mapping != NULL) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (base != NULL) munmap(const_cast<char*>(base), bytes);
+#endif
+        base = NULL;
+        bytes = 0;
+    }
 
-        setColor(COLOR_HEADER);
-        cout << "\n|||===========================================================|||\n";
-        cout << "|||           DIJKSTRA'S SHORTEST PATH ALGORITHM              |||\n";
-        cout << "|||===========================================================|||\n";
-        setColor(COLOR_RESET);
+    const char* data() const { return base; }
+    size_t size() const { return bytes; }
+};
 
-        setColor(COLOR_INFO);
-        cout << "  From: ";
-        setColor(MENU);
-        cout << start;
-        setColor(COLOR_INFO);
-        cout << "  ->  To: ";
-        setColor(MENU);
-        cout << end << endl;
+// Name -> ID table filled once and then only read, so parser threads can
+// share it. Lookups take the name as a byte range straight from the file.
+class FeedNameIndex
+{
+private:
+    DynamicArray<string> names;
+    int* slots;                 // IDs by name hash, -1 empty
+    int mask;
 
-        setColor(COLOR_SUCCESS);
-        cout << "  Total Distance: ";
-        setColor(MENU);
-        cout << dist[endIdx] << " km\n";
+    void place(int id)
+    {
+        int i = (int)(hashString(names[id]) & (unsigned int)mask);
+        while (slots[i] != -1) i = (i + 1) & mask;
+        slots[i] = id;
+    }
 
-        setColor(COLOR_INFO);
-        cout << "  Route: ";
-        setColor(COLOR_RESET);
+public:
+    FeedNameIndex() : slots(NULL), mask(0) {}
 
-        int current = endIdx;
-        while (current != -1) {
-            pathNodes[pathCount++] = nodes[current]->name;
-            current = parent[current];
-        }
+    FeedNameIndex(const FeedNameIndex&) = delete;
+    FeedNameIndex& operator=(const FeedNameIndex&) = delete;
 
-        for (int i = pathCount - 1; i >= 0; i--) {
-            setColor(MENU);
-            cout << pathNodes[i];
-            if (i > 0) {
-                setColor(COLOR_SUBTITLE);
-                cout << " -> ";
-            }
+    // ID of name, added if new
+    int add(const string& name)
+    {
+        int existing = find(name.data(), (int)name.length());
+        if (existing != -1) return existing;
+        if ((names.size() + 1) * 2 > mask + 1) {
+            int size = (mask + 1) * 2;
+            if (size < 16) size = 16;
+            delete[] slots;
+            slots = new int[size];
+            mask = size - 1;
+            for (int i = 0; i < size; i++) slots[i] = -1;
+            for (int id = 0; id < names.size(); id++) place(id);
         }
-        cout << endl;
-        setColor(COLOR_RESET);
+        names.push(name);
+        place(names.size() - 1);
+        return names.size() - 1;
     }
 
-    string findNearestAirport(string startNode)
+    // -1 if unknown
+    int find(const char* text, int length) const
     {
-        int startIdx = findNodeIndex(startNode);
-        if (startIdx == -1) return "";
+        if (slots == NULL) return -1;
+        int i = (int)(hashBytes(text, (size_t)length) & (unsigned int)mask);
+        for (; slots[i] != -1; i = (i + 1) & mask) {
+            const string& name = names[slots[i]];
+            if ((int)name.length() == length && memcmp(name.data(), text, (size_t)length) == 0) return slots[i];
+        }
+        return -1;
+    }
 
-        int dist[50];
-        bool visited[50];
+    const string& nameOf(int id) const { return names[id]; }
+    int size() const { return names.size(); }
 
-        for (int i = 0; i < nodeCount; i++) {
-            dist[i] = INT_MAX;
-            visited[i] = false;
-        }
+    ~FeedNameIndex() { delete[] slots; }
+};
 
-        dist[startIdx] = 0;
+// One parsed position report: the flight was seen at node at time.
+// flight and node are IDs in the reader's name tables, -1 if unknown.
+struct FeedReport
+{
+    long long time;
+    int flight;
+    int node;
+};
 
-        for (int count = 0; count < nodeCount - 1; count++) {
-            int u = minDistance(dist, visited);
-            if (u == -1) break;
+// Binary feed layout (host byte order, little-endian on every target):
+// this header, then flightCount + nodeCount names (one length byte, then
+// the characters), then reportCount records of three uint32 values:
+// seconds after baseTime, flight and node, indexing the names above.
+struct FeedFileHeader
+{
+    char magic[8];
+    unsigned int flightCount;
+    unsigned int nodeCount;
+    unsigned long long reportCount;
+    long long baseTime;
+};
 
-            visited[u] = true;
+const char FEED_MAGIC[8] = { 'S', 'K', 'Y', 'F', 'E', 'E', 'D', '1' };
+const int FEED_RECORD_BYTES = 12;
 
-            Edge* edge = adjList[u];
-            while (edge != NULL) {
-                int v = findNodeIndex(edge->destination);
-                if (v != -1 && !visited[v] && dist[u] != INT_MAX &&
-                    dist[u] + edge->weight < dist[v]) {
-                    dist[v] = dist[u] + edge->weight;
-                }
-                edge = edge->next;
+// Streams a recorded position feed, CSV ("time,flightID,node" per line,
+// '#' comments) or the binary layout above, from a memory-mapped file. Each
+// slice is cut into one range per worker at record boundaries and parsed
+// in parallel; the parts come back in file order.
+class FeedReader
+{
+private:
+    static const size_t SLICE_BYTES = 16 << 20;
+    MappedFile file;
+    const FeedNameIndex& flights;
+    const FeedNameIndex& nodes;
+    bool binary;
+    size_t position;            // next unparsed byte
+    size_t limit;               // end of the reports
+    long long baseTime;         // binary only
+    int* flightIds;             // binary name number -> flight ID
+    int* nodeIds;
+    int binaryFlights;
+    int binaryNodes;
+    long long malformed;
+
+    // Parses whole lines in [begin, end), which ends after a newline or at
+    // the end of the file
+    static void parseCsv(const char* begin, const char* end, const FeedNameIndex& flights,
+        const FeedNameIndex& nodes, DynamicArray<FeedReport>& out, long long& bad)
+    {
+        const char* p = begin;
+        FeedReport report;
+        while (p < end) {
+            const char* line = p;
+            const char* eol = static_cast<const char*>(memchr(p, '\n', (size_t)(end - p)));
+            if (eol == NULL) eol = end;
+            p = eol + 1;
+            const char* last = eol;
+            if (last > line && last[-1] == '\r') last--;
+            if (last == line || *line == '#') continue;
+
+            const char* c = line;
+            long long time = 0;
+            while (c < last && *c >= '0' && *c <= '9') time = time * 10 + (*c++ - '0');
+            if (c == line || c == last || *c != ',') {
+                bad++;
+                continue;
+            }
+            const char* flight = ++c;
+            while (c < last && *c != ',') c++;
+            if (c == last || c == flight) {
+                bad++;
+                continue;
             }
+            const char* node = c + 1;
+            if (node == last) {
+                bad++;
+                continue;
+            }
+            report.time = time;
+            report.flight = flights.find(flight, (int)(c - flight));
+            report.node = nodes.find(node, (int)(last - node));
+            out.push(report);
         }
+    }
 
-        int nearestIdx = -1;
-        int minDist = INT_MAX;
-
-        for (int i = 0; i < nodeCount; i++) {
-            if (nodes[i]->isAirport && dist[i] < minDist && dist[i] != INT_MAX) {
-                minDist = dist[i];
-                nearestIdx = i;
+    void parseBinary(size_t first, size_t count, DynamicArray<FeedReport>& out, long long& bad) const
+    {
+        const char* record = file.data() + first;
+        unsigned int fields[3];
+        FeedReport report;
+        for (size_t r = 0; r < count; r++, record += FEED_RECORD_BYTES) {
+            memcpy(fields, record, sizeof(fields));
+            if (fields[1] >= (unsigned int)binaryFlights || fields[2] >= (unsigned int)binaryNodes) {
+                bad++;
+                continue;
             }
+            report.time = baseTime + fields[0];
+            report.flight = flightIds[fields[1]];
+            report.node = nodeIds[fields[2]];
+            out.push(report);
         }
-
-        return (nearestIdx != -1) ? nodes[nearestIdx]->name : "";
     }
 
-    GraphNode* getNodeByName(string name)
+    // Reads the name tables; on return position is at the first record
+    void readBinaryHeader(const string& filename)
     {
-        int idx = findNodeIndex(name);
-        return (idx != -1) ? nodes[idx] : NULL;
+        const char* data = file.data();
+        FeedFileHeader header;
+        memcpy(&header, data, sizeof(header));
+        size_t at = sizeof(header);
+        baseTime = header.baseTime;
+        binaryFlights = (int)header.flightCount;
+        binaryNodes = (int)header.nodeCount;
+        flightIds = new int[binaryFlights > 0 ? binaryFlights : 1];
+        nodeIds = new int[binaryNodes > 0 ? binaryNodes : 1];
+        for (int n = 0; n < binaryFlights + binaryNodes; n++) {
+            if (at >= file.size()) throw FileOperationException(filename + " (truncated name table)");
+            int length = (unsigned char)data[at];
+            if (at + 1 + length > file.size()) throw FileOperationException(filename + " (truncated name table)");
+            if (n < binaryFlights) flightIds[n] = flights.find(data + at + 1, length);
+            else nodeIds[n - binaryFlights] = nodes.find(data + at + 1, length);
+            at += 1 + length;
+        }
+        position = at;
+        size_t records = (file.size() - at) / FEED_RECORD_BYTES;
+        if (records > header.reportCount) records = (size_t)header.reportCount;
+        else malformed += (long long)(header.reportCount - records);     // truncated recording
+        limit = at + records * FEED_RECORD_BYTES;
     }
 
-    void getAirports(string* airportList, int& count)
+public:
+    FeedReader(const string& filename, const FeedNameIndex& flightIndex, const FeedNameIndex& nodeIndex)
+        : flights(flightIndex), nodes(nodeIndex), binary(false), position(0), limit(0), baseTime(0), flightIds(NULL),
+        nodeIds(NULL), binaryFlights(0), binaryNodes(0), malformed(0)
     {
-        count = 0;
-        for (int i = 0; i < nodeCount; i++) {
-            if (nodes[i]->isAirport)
-                airportList[count++] = nodes[i]->name;
+        file.open(filename);
+        limit = file.size();
+        if (file.size() >= sizeof(FeedFileHeader) && memcmp(file.data(), FEED_MAGIC, sizeof(FEED_MAGIC)) == 0) {
+            binary = true;
+            try {
+                readBinaryHeader(filename);
+            }
+            catch (AircraftException&) {
+                // the destructor does not run for a constructor that throws
+                delete[] flightIds;
+                delete[] nodeIds;
+                throw;
+            }
         }
     }
 
-    void checkAllCollisions()
+    FeedReader(const FeedReader&) = delete;
+    FeedReader& operator=(const FeedReader&) = delete;
+
+    // Parses the next slice with one range per worker into parts[0..workers),
+    // each cleared first; returns the number of reports parsed
+    int readSlice(DynamicArray<FeedReport>* parts, int workers)
     {
-        bool collision = false;
-        for (int i = 0; i < nodeCount; i++) {
-            if (nodes[i]->occupied) {
-                for (int j = i + 1; j < nodeCount; j++) {
-                    if (nodes[j]->occupied &&
-                        abs(nodes[i]->x - nodes[j]->x) <= 1 &&
-                        abs(nodes[i]->y - nodes[j]->y) <= 1) {
-                        setColor(COLOR_DANGER);
-                        cout << "  WARNING: Collision between " << nodes[i]->occupiedBy
-                            << " and " << nodes[j]->occupiedBy << "!\n";
-                        setColor(COLOR_RESET);
-                        collision = true;
-                    }
+        size_t begin[64 + 1];
+        if (workers > 64) workers = 64;
+        if (binary) {
+            size_t records = (limit - position) / FEED_RECORD_BYTES;
+            size_t slice = SLICE_BYTES / FEED_RECORD_BYTES;
+            if (records > slice) records = slice;
+            for (int w = 0; w <= workers; w++) begin[w] = position + records * w / workers * FEED_RECORD_BYTES;
+        }
+        else {
+            // every range but the first starts just after a newline
+            const char* data = file.data();
+            size_t end = (limit - position > SLICE_BYTES) ? position + SLICE_BYTES : limit;
+            begin[0] = position;
+            for (int w = 1; w <= workers; w++) {
+                size_t at = position + (end - position) * w / workers;
+                if (at < begin[w - 1]) at = begin[w - 1];
+                if (at > position && at < limit && data[at - 1] != '\n') {
+                    const char* eol = static_cast<const char*>(memchr(data + at, '\n', limit - at));
+                    at = (eol != NULL) ? (size_t)(eol - data) + 1 : limit;
                 }
+                begin[w] = at;
             }
         }
-        if (!collision) {
-            setColor(COLOR_SUCCESS);
-            cout << "  No collisions detected.\n";
-            setColor(COLOR_RESET);
+
+        long long bad[64];
+        auto parse = [&](int w) {
+            parts[w].clear();
+            bad[w] = 0;
+            if (binary) parseBinary(begin[w], (begin[w + 1] - begin[w]) / FEED_RECORD_BYTES, parts[w], bad[w]);
+            else parseCsv(file.data() + begin[w], file.data() + begin[w + 1], flights, nodes, parts[w], bad[w]);
+        };
+        std::thread* helpers = new std::thread[workers];
+        for (int w = 1; w < workers; w++) helpers[w] = std::thread(parse, w);
+        parse(0);
+        int parsed = 0;
+        for (int w = 0; w < workers; w++) {
+            if (w > 0) helpers[w].join();
+            malformed += bad[w];
+            parsed += parts[w].size();
         }
+        delete[] helpers;
+        position = begin[workers];
+        return parsed;
+    }
+
+    bool isBinary() { return binary; }
+    bool isDone() { return position >= limit; }
+    size_t getPosition() { return position; }
+    size_t getSize() { return limit; }
+    long long getMalformed() { return malformed; }
+
+    ~FeedReader()
+    {
+        delete[] flightIds;
+        delete[] nodeIds;
     }
 };
 
-#endif
\ No newline at end of file
+#endif